@@ -31,10 +31,19 @@
 
 import m5
 from m5.objects import *
+from m5.util import fatal
 from Caches import *
 from O3_ARM_v7a import *
 
 def config_cache(options, system):
+    if options.reuse_profile and not (options.caches and options.l2cache):
+        fatal("--reuse-profile requires --caches and --l2cache")
+    if options.opt_record and not (options.caches and options.l2cache):
+        fatal("--opt-record requires --caches and --l2cache")
+    if options.opt_record and options.fastmem:
+        # fastmem accesses bypass the caches
+        fatal("--opt-record does not work with --fastmem")
+
     if options.l2cache:
         if options.cpu_type == "arm_detailed":
             system.l2 = O3_ARM_v7aL2(size = options.l2_size, assoc = options.l2_assoc,
@@ -44,7 +53,21 @@ def config_cache(options, system):
                                 block_size=options.cacheline_size)
 
         system.tol2bus = CoherentBus()
-        system.l2.cpu_side = system.tol2bus.master
+        if options.reuse_profile or options.opt_record:
+            # monitor the stream of requests leaving the L1 caches
+            system.l2_monitor = CommMonitor()
+            if options.reuse_profile:
+                system.l2_monitor.disable_reuse_dists = False
+                system.l2_monitor.reuse_block_size = options.cacheline_size
+                system.l2_monitor.reuse_sample_rate = \
+                    options.reuse_sample_rate
+            if options.opt_record:
+                system.l2_monitor.block_trace = options.opt_record
+                system.l2_monitor.block_trace_size = options.cacheline_size
+            system.l2_monitor.slave = system.tol2bus.master
+            system.l2.cpu_side = system.l2_monitor.master
+        else:
+            system.l2.cpu_side = system.tol2bus.master
         system.l2.mem_side = system.membus.slave
 
     for i in xrange(options.num_cpus):
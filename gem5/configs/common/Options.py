@@ -42,6 +42,14 @@ def addCommonOptions(parser):
     parser.add_option("--caches", action="store_true")
     parser.add_option("--l2cache", action="store_true")
     parser.add_option("--fastmem", action="store_true")
+    parser.add_option("--block-cache", action="store_true",
+                      help="Cache decoded basic blocks in the atomic CPU"
+                      " (single CPU, syscall emulation only)")
+    parser.add_option("--atomic-quantum", type="int", default=0,
+                      help="Instructions atomic CPUs execute per event")
+    parser.add_option("--parallel-atomic", action="store_true",
+                      help="Run each atomic CPU on a host thread of its own"
+                      " (needs --fastmem and --atomic-quantum)")
     parser.add_option("--clock", action="store", type="string", default='2GHz')
     parser.add_option("--num-dirs", type="int", default=1)
     parser.add_option("--num-l2caches", type="int", default=1)
@@ -55,6 +63,16 @@ def addCommonOptions(parser):
     parser.add_option("--l2_assoc", type="int", default=8)
     parser.add_option("--l3_assoc", type="int", default=16)
     parser.add_option("--cacheline_size", type="int", default=64)
+    parser.add_option("--reuse-profile", action="store_true",
+                      help="profile the reuse distances and working set "
+                      "of the requests past the L1 caches")
+    parser.add_option("--reuse-sample-rate", type="float", default=1.0,
+                      help="fraction of the blocks --reuse-profile tracks")
+    parser.add_option("--opt-record", type="string", default=None,
+                      help="record the line addresses referenced in the "
+                      "L2 cache to this file in the output directory, as "
+                      "an oracle for --opt-oracle; with classic caches the "
+                      "requests leaving the L1 caches are recorded")
     parser.add_option("--ruby", action="store_true")
     parser.add_option("--smt", action="store_true", default=False,
                       help = """
@@ -118,6 +136,15 @@ def addCommonOptions(parser):
     parser.add_option("-p", "--prog-interval", type="int",
         help="CPU Progress Interval")
 
+    # Phase statistics
+    parser.add_option("--stats-snapshot", action="append", type="string",
+        default=[],
+        help="record the statistics matching <EXPR> every "
+             "--stats-snapshot-period ticks (may be given more than once)")
+    parser.add_option("--stats-snapshot-period", action="store", type="int",
+        default=None,
+        help="ticks between statistics snapshots")
+
     # Fastforwarding and simpoint related materials
     parser.add_option("-W", "--warmup-insts", action="store", type="int",
         default=None,
@@ -134,6 +161,35 @@ def addCommonOptions(parser):
         help="""Treat value of --checkpoint-restore or --take-checkpoint as a
                 number of instructions.""")
 
+    # Sampled simulation: an atomic CPU warms up the caches functionally
+    # and short detailed windows are measured at the sample points
+    parser.add_option("--sample-period", action="store", type="int",
+        default=None,
+        help="SMARTS sampling: measure a window every <N> instructions")
+    parser.add_option("--sample-warmup", action="store", type="int",
+        default=2000,
+        help="detailed warm-up instructions before each measured window")
+    parser.add_option("--sample-length", action="store", type="int",
+        default=1000,
+        help="instructions measured in each detailed window")
+    parser.add_option("--max-samples", action="store", type="int",
+        default=None,
+        help="stop after measuring <N> windows")
+    parser.add_option("--simpoint-file", action="store", type="string",
+        default=None,
+        help="SimPoint sampling: simulate the intervals listed in this "
+             "SimPoint .simpts file in detail")
+    parser.add_option("--simpoint-weights", action="store", type="string",
+        default=None,
+        help="SimPoint .weights file for --simpoint-file")
+    parser.add_option("--simpoint-interval", action="store", type="int",
+        default=None,
+        help="instructions per SimPoint interval")
+    parser.add_option("--bbv-interval", action="store", type="int",
+        default=None,
+        help="write a SimPoint basic-block vector every <N> instructions "
+             "(simple CPUs only)")
+
 def addSEOptions(parser):
     # Benchmark options
     parser.add_option("-c", "--cmd", default="",
@@ -76,7 +76,8 @@ def setCPUClass(options):
         if options.restore_with_cpu != options.cpu_type:
             CPUClass = TmpClass
             TmpClass, test_mem_mode = getCPUClass(options.restore_with_cpu)
-    elif options.fast_forward:
+    elif options.fast_forward or options.sample_period or \
+             options.simpoint_file:
         CPUClass = TmpClass
         TmpClass = AtomicSimpleCPU
         test_mem_mode = 'atomic'
@@ -255,6 +256,183 @@ def repeatSwitch(testsys, repeat_switch_cpu_list, maxtick, switch_freq):
             exit_event = m5.simulate(maxtick - m5.curTick())
             return exit_event.getCause()
 
+# Exit cause of the instruction stops that end each sampling phase
+sampleStop = "sample stop"
+
+# Normal quantile of the reported two-sided 95% confidence intervals
+sampleZ = 1.96
+
+def samplePoints(options):
+    """Yields the (start, length, weight) of each window to measure in
+    detail, start being the number of instructions before it.
+
+    With --simpoint-file the windows are the SimPoint intervals in
+    program order, weighted as in --simpoint-weights.  Otherwise they
+    are SMARTS systematic samples: the last --sample-length
+    instructions of every --sample-period, all weighted the same.
+    """
+
+    if options.simpoint_file:
+        interval = options.simpoint_interval
+        weights = {}
+        for line in open(options.simpoint_weights):
+            weight, cluster = line.split()
+            weights[int(cluster)] = float(weight)
+
+        points = []
+        for line in open(options.simpoint_file):
+            index, cluster = line.split()
+            points.append((int(index), weights[int(cluster)]))
+
+        for index, weight in sorted(points):
+            yield index * interval, interval, weight
+    else:
+        period = options.sample_period
+        start = period - options.sample_length
+        while True:
+            yield start, options.sample_length, 1.0
+            start += period
+
+def sampleCounters(cpu, caches):
+    """Returns the cycles of the measuring cpu and the misses of every
+    cache so far; samples are the difference of two of these."""
+
+    stats = m5.stats.stats_dict
+    counters = [ stats[cpu.path() + ".numCycles"].total() ]
+    for cache in caches:
+        counters.append(stats[cache.path() + ".overall_misses"].total())
+    return counters
+
+def sampleStats(values, weights):
+    """Returns the weighted mean of the per-window values and the half
+    width of its confidence interval, or None for a single window.
+    Weights count as reliability weights, so the equal weights of
+    SMARTS give the usual interval of the sample mean."""
+
+    total = sum(weights)
+    mean = sum([ w * v for v, w in zip(values, weights) ]) / total
+    if len(values) < 2:
+        return mean, None
+
+    sum_sq = sum([ w * w for w in weights ])
+    var = sum([ w * (v - mean) ** 2 for v, w in zip(values, weights) ])
+    var /= total - sum_sq / total
+    eff_n = total * total / sum_sq
+    return mean, sampleZ * (var / eff_n) ** 0.5
+
+def sampleReport(samples, caches):
+    """Prints the weighted CPI, IPC and cache MPKI of the windows and
+    writes the per-window values to samples.txt."""
+
+    outdir = m5.options.outdir or getcwd()
+    out = open(joinpath(outdir, "samples.txt"), "w")
+    names = [ "cpi" ] + [ cache.path() + ".mpki" for cache in caches ]
+    print >>out, "start length weight %s" % " ".join(names)
+    for start, length, weight, values in samples:
+        print >>out, "%d %d %g %s" % (start, length, weight,
+                                      " ".join([ "%g" % v for v in values ]))
+    out.close()
+
+    print "**** SAMPLED SIMULATION RESULTS ****"
+    print "windows measured: %d" % len(samples)
+    if not samples:
+        return
+
+    weights = [ sample[2] for sample in samples ]
+    for i, name in enumerate(names):
+        values = [ sample[3][i] for sample in samples ]
+        mean, half = sampleStats(values, weights)
+        if half is None:
+            print "%s: %g" % (name, mean)
+        else:
+            rel = 100.0 * half / mean if mean else 0.0
+            print "%s: %g +/- %g (%.2f%%, 95%% confidence)" % \
+                  (name, mean, half, rel)
+
+        if name == "cpi":
+            if half is None or half >= mean:
+                print "ipc: %g" % (1.0 / mean)
+            else:
+                print "ipc: %g (%g to %g, 95%% confidence)" % \
+                      (1.0 / mean, 1.0 / (mean + half), 1.0 / (mean - half))
+
+def sampleRunInsts(cpus, insts, maxtick):
+    for cpu in cpus:
+        cpu.scheduleInstStop(0, insts, sampleStop)
+    exit_event = m5.simulate(maxtick - m5.curTick())
+    return exit_event.getCause()
+
+def sampledRun(options, testsys, switch_cpus, maxtick):
+    """Sampled simulation.  Between the windows the atomic CPU runs with
+    the caches in functional warm-up mode; each window is preceded by
+    --sample-warmup instructions on the detailed CPU, which also warm
+    up its branch predictor, and the following instructions are
+    measured.  Statistics are not reset, so stats.txt still covers
+    the whole run."""
+
+    to_detailed = [ (testsys.cpu[i], switch_cpus[i])
+                    for i in xrange(len(switch_cpus)) ]
+    to_atomic = [ (new, old) for old, new in to_detailed ]
+    caches = [ obj for obj in testsys.descendants()
+               if isinstance(obj, BaseCache) ]
+
+    pos = 0
+    samples = []
+    exit_cause = sampleStop
+    m5.warmupCaches(testsys, True)
+
+    for start, length, weight in samplePoints(options):
+        if options.max_samples and len(samples) >= options.max_samples:
+            break
+        if start < pos:
+            continue
+
+        # Functional warming up to the detailed warm-up
+        warm_start = max(start - options.sample_warmup, pos)
+        if warm_start > pos:
+            exit_cause = sampleRunInsts(testsys.cpu, warm_start - pos,
+                                        maxtick)
+            if exit_cause != sampleStop:
+                break
+        pos = warm_start
+
+        m5.warmupCaches(testsys, False)
+        m5.doDrain(testsys)
+        m5.changeToTiming(testsys)
+        m5.switchCpus(to_detailed)
+        m5.resume(testsys)
+
+        if start > pos:
+            exit_cause = sampleRunInsts(switch_cpus, start - pos, maxtick)
+            if exit_cause != sampleStop:
+                break
+        pos = start
+
+        before = sampleCounters(switch_cpus[0], caches)
+        exit_cause = sampleRunInsts(switch_cpus, length, maxtick)
+        if exit_cause != sampleStop:
+            break
+        pos += length
+        after = sampleCounters(switch_cpus[0], caches)
+
+        delta = [ a - b for a, b in zip(after, before) ]
+        values = [ delta[0] / length ] + \
+                 [ 1000.0 * misses / length for misses in delta[1:] ]
+        samples.append((start, length, weight, values))
+        print "window %d @ inst %d: cpi %g" % (len(samples), start,
+                                               values[0])
+
+        m5.doDrain(testsys)
+        m5.changeToAtomic(testsys)
+        m5.switchCpus(to_atomic)
+        m5.resume(testsys)
+        m5.warmupCaches(testsys, True)
+
+    sampleReport(samples, caches)
+    if exit_cause == sampleStop:
+        exit_cause = "all sample windows measured"
+    return exit_cause
+
 def run(options, root, testsys, cpu_class):
     if options.maxtick:
         maxtick = options.maxtick
@@ -284,6 +462,32 @@ def run(options, root, testsys, cpu_class):
     if options.repeat_switch and options.take_checkpoints:
         fatal("Can't specify both --repeat-switch and --take-checkpoints")
 
+    sampling = options.sample_period or options.simpoint_file
+    if sampling:
+        if options.fast_forward or options.standard_switch or \
+               options.repeat_switch or options.take_checkpoints:
+            fatal("Sampling can't be combined with --fast-forward, "
+                  "--standard-switch, --repeat-switch or "
+                  "--take-checkpoints")
+        if not cpu_class or \
+               not isinstance(testsys.cpu[0], AtomicSimpleCPU):
+            fatal("Sampling needs a detailed --cpu-type and an atomic "
+                  "CPU to fast forward with")
+        if options.num_cpus != 1:
+            fatal("Sampling supports a single CPU")
+        if options.simpoint_file:
+            if options.sample_period:
+                fatal("Can't specify both --sample-period and "
+                      "--simpoint-file")
+            if not options.simpoint_weights or \
+                   not options.simpoint_interval:
+                fatal("--simpoint-file needs --simpoint-weights and "
+                      "--simpoint-interval")
+        elif options.sample_period <= \
+                 options.sample_warmup + options.sample_length:
+            fatal("--sample-period must be longer than the detailed "
+                  "warm-up and window")
+
     np = options.num_cpus
     switch_cpus = None
 
@@ -295,6 +499,22 @@ def run(options, root, testsys, cpu_class):
         for i in xrange(np):
             testsys.cpu[i].max_insts_any_thread = options.maxinsts
 
+    if options.block_cache and np > 1:
+        # a CPU's block cache doesn't see the stores of the others
+        fatal("--block-cache only works with a single CPU")
+
+    for i in xrange(np):
+        if isinstance(testsys.cpu[i], AtomicSimpleCPU):
+            if options.block_cache:
+                testsys.cpu[i].block_cache = True
+            if options.atomic_quantum:
+                testsys.cpu[i].quantum = options.atomic_quantum
+            if options.parallel_atomic:
+                testsys.cpu[i].parallel = True
+        if isinstance(testsys.cpu[i], BaseSimpleCPU):
+            if options.bbv_interval:
+                testsys.cpu[i].bbv_interval = options.bbv_interval
+
     if cpu_class:
         switch_cpus = [cpu_class(defer_registration=True, cpu_id=(i))
                        for i in xrange(np)]
@@ -433,7 +653,13 @@ def run(options, root, testsys, cpu_class):
         maxtick, checkpoint_dir = findCptDir(options, maxtick, cptdir, testsys)
     m5.instantiate(checkpoint_dir)
 
-    if options.standard_switch or cpu_class:
+    if options.stats_snapshot_period:
+        if not options.stats_snapshot:
+            fatal("--stats-snapshot-period requires --stats-snapshot")
+        m5.stats.snapshot(options.stats_snapshot,
+                          options.stats_snapshot_period)
+
+    if (options.standard_switch or cpu_class) and not sampling:
         if options.standard_switch:
             print "Switch at instruction count:%s" % \
                     str(testsys.cpu[0].max_insts_any_thread)
@@ -490,6 +716,9 @@ def run(options, root, testsys, cpu_class):
         # received from the benchmark running are ignored and skipped in
         # favor of command line checkpoint instructions.
         exit_cause = scriptCheckpoints(options, maxtick, cptdir)
+    elif sampling:
+        print "**** SAMPLED SIMULATION ****"
+        exit_cause = sampledRun(options, testsys, switch_cpus, maxtick)
     else:
         if options.fast_forward:
             m5.stats.reset()
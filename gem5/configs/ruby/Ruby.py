@@ -55,6 +55,9 @@ def define_options(parser):
                       help="the number of rows in the mesh topology")
     parser.add_option("--garnet-network", type="string", default=None,
                       help="'fixed'|'flexible'")
+    parser.add_option("--garnet-router-threads", type="int", default=0,
+                      help="host threads evaluating the fixed-pipeline " \
+                           "garnet routers in parallel")
     parser.add_option("--network-fault-model", action="store_true", default=False,
                       help="enable network fault model: see src/mem/ruby/network/fault_model/")
 
@@ -74,6 +77,9 @@ def define_options(parser):
                       help="Used for seeding the random number generator")
 
     parser.add_option("--ruby_stats", type="string", default="ruby.stats")
+    parser.add_option("--opt-oracle", type="string", default=None,
+                      help="use OPT replacement in the L2 cache, driven "
+                      "by a trace recorded with --opt-record")
 
     protocol = buildEnv['PROTOCOL']
     exec "import %s" % protocol
@@ -106,6 +112,20 @@ def create_system(options, system, piobus = None, dma_ports = []):
         print "Error: could not create sytem for ruby protocol %s" % protocol
         raise
 
+    if options.opt_record or options.opt_oracle:
+        # the oracle is the sequence of references of a single, shared
+        # L2, recorded by the L2 itself in an earlier run
+        l2_caches = [cntrl.L2cacheMemory for cntrl in topology.nodes
+                     if hasattr(cntrl, "L2cacheMemory")]
+        if len(l2_caches) != 1:
+            m5.util.fatal("--opt-record and --opt-oracle need exactly " \
+                          "one L2 cache, found %d" % len(l2_caches))
+        if options.opt_record:
+            l2_caches[0].access_trace = options.opt_record
+        if options.opt_oracle:
+            l2_caches[0].replacement_policy = "OPT"
+            l2_caches[0].opt_trace = options.opt_oracle
+
     # Create a port proxy for connecting the system port. This is
     # independent of the protocol and kept in the protocol-agnostic
     # part (i.e. here).
@@ -162,6 +182,10 @@ def create_system(options, system, piobus = None, dma_ports = []):
     else:
         network = NetworkClass(ruby_system = ruby, topology = net_topology)
 
+    if options.garnet_router_threads:
+        assert(options.garnet_network == "fixed")
+        network.router_threads = options.garnet_router_threads
+
     #
     # Loop through the directory controlers.
     # Determine the total memory size of the ruby system and verify it is equal
@@ -0,0 +1,159 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_POOL_ALLOCATOR_HH__
+#define __BASE_POOL_ALLOCATOR_HH__
+
+#include <cstddef>
+#include <memory>
+#include <new>
+
+/**
+ * A pool of fixed-size blocks of memory. Blocks are carved out of
+ * slabs that are allocated in one go, and blocks that are released
+ * are kept on a free list for the next allocation of the same size.
+ * Memory is never returned to the heap.
+ *
+ * There is one pool per block size, shared by all its users. The
+ * pools are not thread safe.
+ */
+template <size_t Size>
+class FixedSizePool
+{
+  public:
+    static void *
+    allocate()
+    {
+        if (!freeHead)
+            grow(slabBlocks);
+
+        Block *block = freeHead;
+        freeHead = block->next;
+        return block;
+    }
+
+    static void
+    release(void *p)
+    {
+        Block *block = static_cast<Block *>(p);
+        block->next = freeHead;
+        freeHead = block;
+    }
+
+    /** Make sure that at least n blocks are free. */
+    static void
+    reserve(size_t n)
+    {
+        size_t free_blocks = 0;
+        for (Block *b = freeHead; b && free_blocks < n; b = b->next)
+            free_blocks++;
+        if (free_blocks < n)
+            grow(n - free_blocks);
+    }
+
+  private:
+    union Block
+    {
+        Block *next;
+        char data[Size];
+        long double align;
+    };
+
+    /** Number of blocks to add when the pool runs dry */
+    static const size_t slabBlocks = 256;
+
+    static void
+    grow(size_t n)
+    {
+        Block *slab = static_cast<Block *>(::operator new(n * sizeof(Block)));
+        for (size_t i = 0; i < n; i++) {
+            slab[i].next = freeHead;
+            freeHead = &slab[i];
+        }
+    }
+
+    static Block *freeHead;
+};
+
+template <size_t Size>
+typename FixedSizePool<Size>::Block *FixedSizePool<Size>::freeHead = NULL;
+
+/**
+ * An allocator for the standard containers that takes single
+ * elements, such as the nodes of a list or a map, from a
+ * FixedSizePool. Containers that keep churning through elements then
+ * recycle the same memory instead of going to the heap every time.
+ */
+template <class T>
+class PoolAllocator : public std::allocator<T>
+{
+  public:
+    typedef size_t size_type;
+    typedef T *pointer;
+
+    template <class U>
+    struct rebind
+    {
+        typedef PoolAllocator<U> other;
+    };
+
+    PoolAllocator() { }
+    PoolAllocator(const PoolAllocator &) : std::allocator<T>() { }
+    template <class U>
+    PoolAllocator(const PoolAllocator<U> &) { }
+
+    pointer
+    allocate(size_type n, const void * = 0)
+    {
+        if (n != 1)
+            return std::allocator<T>::allocate(n);
+        return static_cast<pointer>(FixedSizePool<sizeof(T)>::allocate());
+    }
+
+    void
+    deallocate(pointer p, size_type n)
+    {
+        if (n != 1)
+            std::allocator<T>::deallocate(p, n);
+        else
+            FixedSizePool<sizeof(T)>::release(p);
+    }
+};
+
+template <class T, class U>
+inline bool
+operator==(const PoolAllocator<T> &, const PoolAllocator<U> &)
+{
+    return true;
+}
+
+template <class T, class U>
+inline bool
+operator!=(const PoolAllocator<T> &, const PoolAllocator<U> &)
+{
+    return false;
+}
+
+#endif // __BASE_POOL_ALLOCATOR_HH__
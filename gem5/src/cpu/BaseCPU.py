@@ -87,6 +87,7 @@ class BaseCPU(MemObject):
         code('''
     void switchOut();
     void takeOverFrom(BaseCPU *cpu);
+    void scheduleInstStop(ThreadID tid, Counter insts, const char *cause);
 ''')
 
     def takeOverFrom(self, old_cpu):
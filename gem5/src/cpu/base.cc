@@ -165,6 +165,10 @@ BaseCPU::BaseCPU(Params *p, bool is_checker)
         }
     }
 
+    instStopEvents.resize(numThreads);
+    for (ThreadID tid = 0; tid < numThreads; ++tid)
+        instStopEvents[tid] = new InstStopEvent;
+
     // allocate per-thread load-based event queues
     comLoadEventQueue = new EventQueue *[numThreads];
     for (ThreadID tid = 0; tid < numThreads; ++tid)
@@ -239,11 +243,39 @@ BaseCPU::enableFunctionTrace()
 
 BaseCPU::~BaseCPU()
 {
+    for (ThreadID tid = 0; tid < numThreads; ++tid) {
+        if (instStopEvents[tid]->scheduled())
+            comInstEventQueue[tid]->deschedule(instStopEvents[tid]);
+        delete instStopEvents[tid];
+    }
     delete profileEvent;
     delete[] comLoadEventQueue;
     delete[] comInstEventQueue;
 }
 
+void
+BaseCPU::InstStopEvent::process()
+{
+    exitSimLoop(cause);
+}
+
+void
+BaseCPU::scheduleInstStop(ThreadID tid, Counter insts, const char *cause)
+{
+    assert(tid < numThreads);
+    InstStopEvent *event = instStopEvents[tid];
+    event->cause = cause;
+    comInstEventQueue[tid]->reschedule(event,
+                                       getCurrentInstCount(tid) + insts,
+                                       true);
+}
+
+Counter
+BaseCPU::getCurrentInstCount(ThreadID tid)
+{
+    panic("%s does not count instructions per thread\n", name());
+}
+
 void
 BaseCPU::init()
 {
@@ -320,6 +320,39 @@ class BaseCPU : public MemObject
      */
     EventQueue **comLoadEventQueue;
 
+    /**
+     * Make the simulation loop exit once a thread has committed another
+     * insts instructions. Each thread has a single such stop, so
+     * scheduling it again replaces the previous one. This lets scripts
+     * switch CPUs at instruction boundaries after instantiation.
+     * @param tid The thread to count the instructions of.
+     * @param insts Instructions from now.
+     * @param cause The exit cause returned to Python.
+     */
+    void scheduleInstStop(ThreadID tid, Counter insts, const char *cause);
+
+    /**
+     * Instructions committed by a thread so far, counted the way its
+     * instruction-based event queue is serviced.
+     */
+    virtual Counter getCurrentInstCount(ThreadID tid);
+
+  private:
+    /** Exits the simulation loop for scheduleInstStop(). */
+    class InstStopEvent : public Event
+    {
+      public:
+        std::string cause;
+
+        InstStopEvent() : Event(Sim_Exit_Pri) {}
+        void process();
+        const char *description() const { return "instruction stop"; }
+    };
+
+    std::vector<InstStopEvent *> instStopEvents;
+
+  public:
+
     System *system;
 
     /**
@@ -51,6 +51,7 @@
 #include <queue>
 
 #include "arch/utility.hh"
+#include "base/pool_allocator.hh"
 #include "base/trace.hh"
 #include "config/the_isa.hh"
 #include "cpu/checker/cpu.hh"
@@ -91,7 +92,8 @@ class BaseDynInst : public RefCounted
     typedef RefCountingPtr<BaseDynInst<Impl> > BaseDynInstPtr;
 
     // The list of instructions iterator type.
-    typedef typename std::list<DynInstPtr>::iterator ListIt;
+    typedef std::list<DynInstPtr, PoolAllocator<DynInstPtr> > InstList;
+    typedef typename InstList::iterator ListIt;
 
     enum {
         MaxInstSrcRegs = TheISA::MaxInstSrcRegs,        /// Max source regs
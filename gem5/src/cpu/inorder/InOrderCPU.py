@@ -45,7 +45,8 @@ class InOrderCPU(BaseCPU):
     fetchBuffSize = Param.Unsigned(4, "Fetch Buffer Size (Number of Cache Blocks Stored)")
     memBlockSize = Param.Unsigned(64, "Memory Block Size")
 
-    predType = Param.String("tournament", "Branch predictor type ('local', 'tournament')")
+    predType = Param.String("tournament",
+        "Branch predictor type ('local', 'tournament', 'tage', 'perceptron')")
     localPredictorSize = Param.Unsigned(2048, "Size of local predictor")
     localCtrBits = Param.Unsigned(2, "Bits per counter")
     localHistoryTableSize = Param.Unsigned(2048, "Size of local history table")
@@ -56,6 +57,22 @@ class InOrderCPU(BaseCPU):
     choicePredictorSize = Param.Unsigned(8192, "Size of choice predictor")
     choiceCtrBits = Param.Unsigned(2, "Bits of choice counters")
 
+    tageNumTables = Param.Unsigned(7, "Number of TAGE tagged tables")
+    tageTableBits = Param.Unsigned(10, "log2 of the entries per TAGE table")
+    tageTagBits = Param.Unsigned(11, "Bits of the TAGE tags")
+    tageMinHist = Param.Unsigned(5, "History length of the first TAGE table")
+    tageMaxHist = Param.Unsigned(130, "History length of the last TAGE table")
+    tageBimodalSize = Param.Unsigned(8192, "Size of the TAGE base predictor")
+    tageLoopSize = Param.Unsigned(64, "Size of the loop predictor (0 for none)")
+    tageSCSize = Param.Unsigned(1024,
+        "Size of each statistical corrector table (0 for none)")
+
+    perceptronNumTables = Param.Unsigned(8, "Number of perceptron tables")
+    perceptronTableSize = Param.Unsigned(1024, "Weights per perceptron table")
+    perceptronWeightBits = Param.Unsigned(8, "Bits per perceptron weight")
+    perceptronHistoryBits = Param.Unsigned(128,
+        "History length of the last perceptron table")
+
     BTBEntries = Param.Unsigned(4096, "Number of BTB entries")
     BTBTagSize = Param.Unsigned(16, "Size of the BTB tags, in bits")
 
@@ -831,6 +831,11 @@ class InOrderCPU : public BaseCPU
         return total;
     }
 
+    /** Ops committed by a thread, which the instruction-based event
+     *  queues count in. */
+    virtual Counter getCurrentInstCount(ThreadID tid)
+    { return thread[tid]->numOp; }
+
     /** Pointer to the system. */
     System *system;
 
@@ -64,6 +64,24 @@ BPredUnit::BPredUnit(Resource *_res, ThePipeline::Params *params)
                                         params->choiceCtrBits,
                                         params->instShiftAmt);
         predictor = Tournament;
+    } else if (params->predType == "tage") {
+        tageBP = new TageBP(params->tageNumTables,
+                            params->tageTableBits,
+                            params->tageTagBits,
+                            params->tageMinHist,
+                            params->tageMaxHist,
+                            params->tageBimodalSize,
+                            params->tageLoopSize,
+                            params->tageSCSize,
+                            params->instShiftAmt);
+        predictor = TAGE;
+    } else if (params->predType == "perceptron") {
+        perceptronBP = new PerceptronBP(params->perceptronNumTables,
+                                        params->perceptronTableSize,
+                                        params->perceptronWeightBits,
+                                        params->perceptronHistoryBits,
+                                        params->instShiftAmt);
+        predictor = Perceptron;
     } else {
         fatal("Invalid BP selected!");
     }
@@ -392,9 +410,13 @@ BPredUnit::squash(const InstSeqNum &squashed_sn,
 void
 BPredUnit::BPUncond(void * &bp_history)
 {
-    // Only the tournament predictor cares about unconditional branches.
+    // The local predictor doesn't care about unconditional branches.
     if (predictor == Tournament) {
         tournamentBP->uncondBr(bp_history);
+    } else if (predictor == TAGE) {
+        tageBP->uncondBr(bp_history);
+    } else if (predictor == Perceptron) {
+        perceptronBP->uncondBr(bp_history);
     }    
 }
 
@@ -406,6 +428,10 @@ BPredUnit::BPSquash(void *bp_history)
         localBP->squash(bp_history);
     } else if (predictor == Tournament) {
         tournamentBP->squash(bp_history);
+    } else if (predictor == TAGE) {
+        tageBP->squash(bp_history);
+    } else if (predictor == Perceptron) {
+        perceptronBP->squash(bp_history);
     } else {
         panic("Predictor type is unexpected value!");
     }    
@@ -419,6 +445,10 @@ BPredUnit::BPLookup(Addr inst_PC, void * &bp_history)
         return localBP->lookup(inst_PC, bp_history);
     } else if (predictor == Tournament) {
         return tournamentBP->lookup(inst_PC, bp_history);
+    } else if (predictor == TAGE) {
+        return tageBP->lookup(inst_PC, bp_history);
+    } else if (predictor == Perceptron) {
+        return perceptronBP->lookup(inst_PC, bp_history);
     } else {
         panic("Predictor type is unexpected value!");
     }
@@ -432,6 +462,10 @@ BPredUnit::BPUpdate(Addr inst_PC, bool taken, void *bp_history, bool squashed)
         localBP->update(inst_PC, taken, bp_history);
     } else if (predictor == Tournament) {
         tournamentBP->update(inst_PC, taken, bp_history, squashed);
+    } else if (predictor == TAGE) {
+        tageBP->update(inst_PC, taken, bp_history, squashed);
+    } else if (predictor == Perceptron) {
+        perceptronBP->update(inst_PC, taken, bp_history, squashed);
     } else {
         panic("Predictor type is unexpected value!");
     }
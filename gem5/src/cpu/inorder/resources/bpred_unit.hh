@@ -41,7 +41,9 @@
 #include "cpu/inorder/resource.hh"
 #include "cpu/pred/2bit_local.hh"
 #include "cpu/pred/btb.hh"
+#include "cpu/pred/perceptron.hh"
 #include "cpu/pred/ras.hh"
+#include "cpu/pred/tage.hh"
 #include "cpu/pred/tournament.hh"
 #include "cpu/inst_seq.hh"
 #include "params/InOrderCPU.hh"
@@ -56,7 +58,9 @@ class BPredUnit
 
     enum PredType {
         Local,
-        Tournament
+        Tournament,
+        TAGE,
+        Perceptron
     };
 
     PredType predictor;
@@ -239,6 +243,12 @@ class BPredUnit
     /** The tournament branch predictor. */
     TournamentBP *tournamentBP;
 
+    /** The TAGE branch predictor. */
+    TageBP *tageBP;
+
+    /** The hashed perceptron branch predictor. */
+    PerceptronBP *perceptronBP;
+
     /** The BTB. */
     DefaultBTB BTB;
 
@@ -82,7 +82,8 @@ class DerivO3CPU(BaseCPU):
     backComSize = Param.Unsigned(5, "Time buffer size for backwards communication")
     forwardComSize = Param.Unsigned(5, "Time buffer size for forward communication")
 
-    predType = Param.String("tournament", "Branch predictor type ('local', 'tournament')")
+    predType = Param.String("tournament",
+        "Branch predictor type ('local', 'tournament', 'tage', 'perceptron')")
     localPredictorSize = Param.Unsigned(2048, "Size of local predictor")
     localCtrBits = Param.Unsigned(2, "Bits per counter")
     localHistoryTableSize = Param.Unsigned(2048, "Size of local history table")
@@ -93,6 +94,22 @@ class DerivO3CPU(BaseCPU):
     choicePredictorSize = Param.Unsigned(8192, "Size of choice predictor")
     choiceCtrBits = Param.Unsigned(2, "Bits of choice counters")
 
+    tageNumTables = Param.Unsigned(7, "Number of TAGE tagged tables")
+    tageTableBits = Param.Unsigned(10, "log2 of the entries per TAGE table")
+    tageTagBits = Param.Unsigned(11, "Bits of the TAGE tags")
+    tageMinHist = Param.Unsigned(5, "History length of the first TAGE table")
+    tageMaxHist = Param.Unsigned(130, "History length of the last TAGE table")
+    tageBimodalSize = Param.Unsigned(8192, "Size of the TAGE base predictor")
+    tageLoopSize = Param.Unsigned(64, "Size of the loop predictor (0 for none)")
+    tageSCSize = Param.Unsigned(1024,
+        "Size of each statistical corrector table (0 for none)")
+
+    perceptronNumTables = Param.Unsigned(8, "Number of perceptron tables")
+    perceptronTableSize = Param.Unsigned(1024, "Weights per perceptron table")
+    perceptronWeightBits = Param.Unsigned(8, "Bits per perceptron weight")
+    perceptronHistoryBits = Param.Unsigned(128,
+        "History length of the last perceptron table")
+
     BTBEntries = Param.Unsigned(4096, "Number of BTB entries")
     BTBTagSize = Param.Unsigned(16, "Size of the BTB tags, in bits")
 
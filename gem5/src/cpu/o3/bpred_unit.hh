@@ -49,7 +49,9 @@
 #include "base/types.hh"
 #include "cpu/pred/2bit_local.hh"
 #include "cpu/pred/btb.hh"
+#include "cpu/pred/perceptron.hh"
 #include "cpu/pred/ras.hh"
+#include "cpu/pred/tage.hh"
 #include "cpu/pred/tournament.hh"
 #include "cpu/inst_seq.hh"
 
@@ -67,7 +69,9 @@ class BPredUnit
 
     enum PredType {
         Local,
-        Tournament
+        Tournament,
+        TAGE,
+        Perceptron
     };
 
     PredType predictor;
@@ -270,6 +274,12 @@ class BPredUnit
     /** The tournament branch predictor. */
     TournamentBP *tournamentBP;
 
+    /** The TAGE branch predictor. */
+    TageBP *tageBP;
+
+    /** The hashed perceptron branch predictor. */
+    PerceptronBP *perceptronBP;
+
     /** The BTB. */
     DefaultBTB BTB;
 
@@ -76,6 +76,24 @@ BPredUnit<Impl>::BPredUnit(DerivO3CPUParams *params)
                                         params->choiceCtrBits,
                                         params->instShiftAmt);
         predictor = Tournament;
+    } else if (params->predType == "tage") {
+        tageBP = new TageBP(params->tageNumTables,
+                            params->tageTableBits,
+                            params->tageTagBits,
+                            params->tageMinHist,
+                            params->tageMaxHist,
+                            params->tageBimodalSize,
+                            params->tageLoopSize,
+                            params->tageSCSize,
+                            params->instShiftAmt);
+        predictor = TAGE;
+    } else if (params->predType == "perceptron") {
+        perceptronBP = new PerceptronBP(params->perceptronNumTables,
+                                        params->perceptronTableSize,
+                                        params->perceptronWeightBits,
+                                        params->perceptronHistoryBits,
+                                        params->instShiftAmt);
+        predictor = Perceptron;
     } else {
         fatal("Invalid BP selected!");
     }
@@ -430,9 +448,13 @@ template <class Impl>
 void
 BPredUnit<Impl>::BPUncond(void * &bp_history)
 {
-    // Only the tournament predictor cares about unconditional branches.
+    // The local predictor doesn't care about unconditional branches.
     if (predictor == Tournament) {
         tournamentBP->uncondBr(bp_history);
+    } else if (predictor == TAGE) {
+        tageBP->uncondBr(bp_history);
+    } else if (predictor == Perceptron) {
+        perceptronBP->uncondBr(bp_history);
     }
 }
 
@@ -444,6 +466,10 @@ BPredUnit<Impl>::BPSquash(void *bp_history)
         localBP->squash(bp_history);
     } else if (predictor == Tournament) {
         tournamentBP->squash(bp_history);
+    } else if (predictor == TAGE) {
+        tageBP->squash(bp_history);
+    } else if (predictor == Perceptron) {
+        perceptronBP->squash(bp_history);
     } else {
         panic("Predictor type is unexpected value!");
     }
@@ -457,6 +483,10 @@ BPredUnit<Impl>::BPLookup(Addr instPC, void * &bp_history)
         return localBP->lookup(instPC, bp_history);
     } else if (predictor == Tournament) {
         return tournamentBP->lookup(instPC, bp_history);
+    } else if (predictor == TAGE) {
+        return tageBP->lookup(instPC, bp_history);
+    } else if (predictor == Perceptron) {
+        return perceptronBP->lookup(instPC, bp_history);
     } else {
         panic("Predictor type is unexpected value!");
     }
@@ -470,6 +500,10 @@ BPredUnit<Impl>::BPBTBUpdate(Addr instPC, void * &bp_history)
         return localBP->BTBUpdate(instPC, bp_history);
     } else if (predictor == Tournament) {
         return tournamentBP->BTBUpdate(instPC, bp_history);
+    } else if (predictor == TAGE) {
+        return tageBP->BTBUpdate(instPC, bp_history);
+    } else if (predictor == Perceptron) {
+        return perceptronBP->BTBUpdate(instPC, bp_history);
     } else {
         panic("Predictor type is unexpected value!");
     }
@@ -484,6 +518,10 @@ BPredUnit<Impl>::BPUpdate(Addr instPC, bool taken, void *bp_history,
         localBP->update(instPC, taken, bp_history);
     } else if (predictor == Tournament) {
         tournamentBP->update(instPC, taken, bp_history, squashed);
+    } else if (predictor == TAGE) {
+        tageBP->update(instPC, taken, bp_history, squashed);
+    } else if (predictor == Perceptron) {
+        perceptronBP->update(instPC, taken, bp_history, squashed);
     } else {
         panic("Predictor type is unexpected value!");
     }
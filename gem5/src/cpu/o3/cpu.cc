@@ -274,6 +274,11 @@ FullO3CPU<Impl>::FullO3CPU(DerivO3CPUParams *params)
         checker = NULL;
     }
 
+    // Set aside storage for as many instructions as can be in flight
+    // between fetch and commit, so that they come from the pool
+    Impl::DynInst::reservePool(params->numROBEntries +
+                               params->fetchWidth * params->forwardComSize);
+
     if (!FullSystem) {
         thread.resize(numThreads);
         tids.resize(numThreads);
@@ -105,7 +105,8 @@ class FullO3CPU : public BaseO3CPU
     typedef O3ThreadState<Impl> ImplState;
     typedef O3ThreadState<Impl> Thread;
 
-    typedef typename std::list<DynInstPtr>::iterator ListIt;
+    typedef typename Impl::InstList InstList;
+    typedef typename InstList::iterator ListIt;
 
     friend class O3ThreadContext<Impl>;
 
@@ -391,6 +392,10 @@ class FullO3CPU : public BaseO3CPU
     /** Count the Total Ops (including micro ops) committed in the CPU. */
     virtual Counter totalOps() const;
 
+    /** Instructions committed by a thread, for instruction stops. */
+    virtual Counter getCurrentInstCount(ThreadID tid)
+    { return thread[tid]->numInst; }
+
     /** Add Thread to Active Threads List. */
     void activateContext(ThreadID tid, Cycles delay);
 
@@ -578,7 +583,7 @@ class FullO3CPU : public BaseO3CPU
 #endif
 
     /** List of all the instructions in flight. */
-    std::list<DynInstPtr> instList;
+    InstList instList;
 
     /** List of all the instructions that will be removed at the end of this
      *  cycle.
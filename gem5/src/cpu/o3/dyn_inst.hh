@@ -44,6 +44,7 @@
 #define __CPU_O3_DYN_INST_HH__
 
 #include "arch/isa_traits.hh"
+#include "base/pool_allocator.hh"
 #include "config/the_isa.hh"
 #include "cpu/o3/cpu.hh"
 #include "cpu/o3/isa_specific.hh"
@@ -95,6 +96,39 @@ class BaseO3DynInst : public BaseDynInst<Impl>
 
     ~BaseO3DynInst();
 
+    /**
+     * Instructions are created and retired at a very high rate, so
+     * their storage is recycled through a pool instead of the heap.
+     */
+    static void *
+    operator new(size_t size)
+    {
+        if (size != sizeof(BaseO3DynInst))
+            return ::operator new(size);
+        return FixedSizePool<sizeof(BaseO3DynInst)>::allocate();
+    }
+
+    static void
+    operator delete(void *p, size_t size)
+    {
+        if (!p)
+            return;
+        if (size != sizeof(BaseO3DynInst))
+            ::operator delete(p);
+        else
+            FixedSizePool<sizeof(BaseO3DynInst)>::release(p);
+    }
+
+    /**
+     * Make sure the pool can hold n instructions in flight without
+     * going back to the heap.
+     */
+    static void
+    reservePool(size_t n)
+    {
+        FixedSizePool<sizeof(BaseO3DynInst)>::reserve(n);
+    }
+
     /** Executes the instruction.*/
     Fault execute();
 
@@ -123,6 +157,9 @@ class BaseO3DynInst : public BaseDynInst<Impl>
 
 
   public:
+    /** Slot this instruction holds in the IQ, or -1 if it holds none. */
+    int iqSlot;
+
 #if TRACING_ON
     /** Tick records used for the pipeline activity viewer. */
     Tick fetchTick;	     // instruction fetch is completed.
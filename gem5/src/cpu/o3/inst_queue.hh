@@ -45,12 +45,13 @@
 
 #include <list>
 #include <map>
-#include <queue>
 #include <vector>
 
+#include "base/pool_allocator.hh"
 #include "base/statistics.hh"
 #include "base/types.hh"
-#include "cpu/o3/dep_graph.hh"
+#include "cpu/o3/comm.hh"
+#include "cpu/o3/slot_bitmap.hh"
 #include "cpu/inst_seq.hh"
 #include "cpu/op_class.hh"
 #include "cpu/timebuf.hh"
@@ -61,9 +62,11 @@ class FUPool;
 class MemInterface;
 
 /**
- * A standard instruction queue class.  It holds ready instructions, in
- * order, in seperate priority queues to facilitate the scheduling of
- * instructions.  The IQ uses a separate linked list to track dependencies.
+ * A standard instruction queue class.  Each instruction waiting in the
+ * IQ holds a slot, and the IQ tracks ready instructions per op class
+ * and the consumers of each physical register as bitmaps over those
+ * slots; scheduling picks the oldest ready slot among the op classes
+ * that still have a free FU.
  * Similar to the rename map and the free list, it expects that
  * floating point registers have their indices start after the integer
  * registers (ie with 96 int and 96 fp registers, regs 0-95 are integer
@@ -91,7 +94,8 @@ class InstructionQueue
     typedef typename Impl::CPUPol::TimeStruct TimeStruct;
 
     // Typedef of iterator through the list of instructions.
-    typedef typename std::list<DynInstPtr>::iterator ListIt;
+    typedef typename Impl::InstList InstList;
+    typedef typename InstList::iterator ListIt;
 
     /** FU completion event class. */
     class FUCompletion : public Event {
@@ -300,37 +304,15 @@ class InstructionQueue
     //////////////////////////////////////
 
     /** List of all the instructions in the IQ (some of which may be issued). */
-    std::list<DynInstPtr> instList[Impl::MaxThreads];
+    InstList instList[Impl::MaxThreads];
 
     /** List of instructions that are ready to be executed. */
-    std::list<DynInstPtr> instsToExecute;
+    InstList instsToExecute;
 
     /** List of instructions waiting for their DTB translation to
      *  complete (hw page table walk in progress).
      */
-    std::list<DynInstPtr> deferredMemInsts;
-
-    /**
-     * Struct for comparing entries to be added to the priority queue.
-     * This gives reverse ordering to the instructions in terms of
-     * sequence numbers: the instructions with smaller sequence
-     * numbers (and hence are older) will be at the top of the
-     * priority queue.
-     */
-    struct pqCompare {
-        bool operator() (const DynInstPtr &lhs, const DynInstPtr &rhs) const
-        {
-            return lhs->seqNum > rhs->seqNum;
-        }
-    };
-
-    typedef std::priority_queue<DynInstPtr, std::vector<DynInstPtr>, pqCompare>
-    ReadyInstQueue;
-
-    /** List of ready instructions, per op class.  They are separated by op
-     *  class to allow for easy mapping to FUs.
-     */
-    ReadyInstQueue readyInsts[Num_OpClasses];
+    InstList deferredMemInsts;
 
     /** List of non-speculative instructions that will be scheduled
      *  once the IQ gets a signal from commit.  While it's redundant to
@@ -339,45 +321,63 @@ class InstructionQueue
      *  the sequence number will be available.  Thus it is most efficient to be
      *  able to search by the sequence number alone.
      */
-    std::map<InstSeqNum, DynInstPtr> nonSpecInsts;
-
-    typedef typename std::map<InstSeqNum, DynInstPtr>::iterator NonSpecMapIt;
-
-    /** Entry for the list age ordering by op class. */
-    struct ListOrderEntry {
-        OpClass queueType;
-        InstSeqNum oldestInst;
+    typedef std::map<InstSeqNum, DynInstPtr, std::less<InstSeqNum>,
+                     PoolAllocator<std::pair<const InstSeqNum, DynInstPtr> > >
+        NonSpecMap;
+
+    NonSpecMap nonSpecInsts;
+
+    typedef typename NonSpecMap::iterator NonSpecMapIt;
+
+    /** Rows of slotSets besides the per op class ready rows. */
+    enum SlotRow {
+        /** Slots that are ready in any op class. */
+        AnyReadyRow = Num_OpClasses,
+        /** Ready slots still eligible for issue this cycle. */
+        SelectRow,
+        /** Slots whose instruction still occupies an IQ entry. */
+        EntryRow,
+        NumSlotRows
     };
 
-    /** List that contains the age order of the oldest instruction of each
-     *  ready queue.  Used to select the oldest instruction available
-     *  among op classes.
-     *  @todo: Might be better to just move these entries around instead
-     *  of creating new ones every time the position changes due to an
-     *  instruction issuing.  Not sure std::list supports this.
+    /** Ready and occupancy bitmaps over the IQ slots.  Rows below
+     *  Num_OpClasses hold the ready slots of each op class.
      */
-    std::list<ListOrderEntry> listOrder;
+    SlotBitmap slotSets;
 
-    typedef typename std::list<ListOrderEntry>::iterator ListOrderIt;
+    /** Slots of the instructions waiting on each physical register. */
+    SlotBitmap consumers;
 
-    /** Tracks if each ready queue is on the age order list. */
-    bool queueOnList[Num_OpClasses];
+    /** Instruction held in each slot. */
+    std::vector<DynInstPtr> slotInsts;
 
-    /** Iterators of each ready queue.  Points to their spot in the age order
-     *  list.
+    /** Sequence number of the instruction held in each slot, used to
+     *  pick the oldest ready slot.
      */
-    ListOrderIt readyIt[Num_OpClasses];
+    std::vector<InstSeqNum> slotSeqNums;
 
-    /** Add an op class to the age order list. */
-    void addToOrderList(OpClass op_class);
+    /** Slots not held by any instruction. */
+    std::vector<int> freeSlots;
 
-    /**
-     * Called when the oldest instruction has been removed from a ready queue;
-     * this places that ready queue into the proper spot in the age order list.
+    /** Gives an instruction a slot, adding more slots if all are held. */
+    int allocateSlot(DynInstPtr &inst);
+
+    /** Returns a slot to the free list once its instruction holds
+     *  neither an IQ entry nor a place among the ready slots.
      */
-    void moveToYoungerInst(ListOrderIt age_order_it);
+    void releaseSlot(int slot);
+
+    /** Marks an instruction ready to issue in its op class. */
+    void addToReadySlots(DynInstPtr &inst);
+
+    /** Removes a slot from the ready rows. */
+    void removeFromReadySlots(int slot);
+
+    /** Releases the IQ entry an instruction holds in its slot. */
+    void releaseEntry(DynInstPtr &inst);
 
-    DependencyGraph<DynInstPtr> dependGraph;
+    /** Returns the oldest slot in the select row, or -1 if it is empty. */
+    int oldestSelectable() const;
 
     //////////////////////////////////////
     // Various parameters
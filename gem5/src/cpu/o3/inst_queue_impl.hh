@@ -100,9 +100,11 @@ InstructionQueue<Impl>::InstructionQueue(O3CPU *cpu_ptr, IEW *iew_ptr,
     // Set the number of physical registers as the number of int + float
     numPhysRegs = numPhysIntRegs + numPhysFloatRegs;
 
-    //Create an entry for each physical register within the
-    //dependency graph.
-    dependGraph.resize(numPhysRegs);
+    // Start with a slot per IQ entry.  Squashed instructions keep their
+    // slots until select drops them from the ready rows, so the bitmaps
+    // grow if the IQ refills before that happens.
+    slotSets.resize(NumSlotRows, numEntries);
+    consumers.resize(numPhysRegs, numEntries);
 
     // Resize the register scoreboard.
     regScoreboard.resize(numPhysRegs);
@@ -166,11 +168,6 @@ InstructionQueue<Impl>::InstructionQueue(O3CPU *cpu_ptr, IEW *iew_ptr,
 template <class Impl>
 InstructionQueue<Impl>::~InstructionQueue()
 {
-    dependGraph.reset();
-#ifdef DEBUG
-    cprintf("Nodes traversed: %i, removed: %i\n",
-            dependGraph.nodesTraversed, dependGraph.nodesRemoved);
-#endif
 }
 
 template <class Impl>
@@ -403,14 +400,20 @@ InstructionQueue<Impl>::resetState()
         squashedSeqNum[tid] = 0;
     }
 
-    for (int i = 0; i < Num_OpClasses; ++i) {
-        while (!readyInsts[i].empty())
-            readyInsts[i].pop();
-        queueOnList[i] = false;
-        readyIt[i] = listOrder.end();
+    for (int i = 0; i < slotInsts.size(); ++i) {
+        if (slotInsts[i])
+            slotInsts[i]->iqSlot = -1;
+    }
+    slotInsts.assign(slotSets.slots(), DynInstPtr());
+    slotSeqNums.assign(slotSets.slots(), 0);
+    freeSlots.clear();
+    for (int i = slotSets.slots() - 1; i >= 0; --i) {
+        freeSlots.push_back(i);
     }
+    slotSets.clear();
+    consumers.clear();
+
     nonSpecInsts.clear();
-    listOrder.clear();
     deferredMemInsts.clear();
 }
 
@@ -443,13 +446,12 @@ InstructionQueue<Impl>::switchOut()
 {
 /*
     if (!instList[0].empty() || (numEntries != freeEntries) ||
-        !readyInsts[0].empty() || !nonSpecInsts.empty() || !listOrder.empty()) {
+        hasReadyInsts() || !nonSpecInsts.empty()) {
         dumpInsts();
 //        assert(0);
     }
 */
     resetState();
-    dependGraph.reset();
     instsToExecute.clear();
     switchedOut = true;
     for (ThreadID tid = 0; tid < numThreads; ++tid) {
@@ -540,17 +542,7 @@ template <class Impl>
 bool
 InstructionQueue<Impl>::hasReadyInsts()
 {
-    if (!listOrder.empty()) {
-        return true;
-    }
-
-    for (int i = 0; i < Num_OpClasses; ++i) {
-        if (!readyInsts[i].empty()) {
-            return true;
-        }
-    }
-
-    return false;
+    return !slotSets.none(AnyReadyRow);
 }
 
 template <class Impl>
@@ -572,6 +564,8 @@ InstructionQueue<Impl>::insert(DynInstPtr &new_inst)
 
     new_inst->setInIQ();
 
+    slotSets.set(EntryRow, allocateSlot(new_inst));
+
     // Look through its source registers (physical regs), and mark any
     // dependencies.
     addToDependents(new_inst);
@@ -617,6 +611,8 @@ InstructionQueue<Impl>::insertNonSpec(DynInstPtr &new_inst)
 
     new_inst->setInIQ();
 
+    slotSets.set(EntryRow, allocateSlot(new_inst));
+
     // Have this instruction set itself as the producer of its destination
     // register(s).
     addToProducers(new_inst);
@@ -659,56 +655,96 @@ InstructionQueue<Impl>::getInstToExecute()
 }
 
 template <class Impl>
-void
-InstructionQueue<Impl>::addToOrderList(OpClass op_class)
+int
+InstructionQueue<Impl>::allocateSlot(DynInstPtr &inst)
 {
-    assert(!readyInsts[op_class].empty());
+    if (freeSlots.empty()) {
+        int old_slots = slotSets.slots();
 
-    ListOrderEntry queue_entry;
+        slotSets.resize(NumSlotRows, old_slots + numEntries);
+        consumers.resize(numPhysRegs, old_slots + numEntries);
+        slotInsts.resize(slotSets.slots());
+        slotSeqNums.resize(slotSets.slots());
 
-    queue_entry.queueType = op_class;
+        for (int i = slotSets.slots() - 1; i >= old_slots; --i) {
+            freeSlots.push_back(i);
+        }
 
-    queue_entry.oldestInst = readyInsts[op_class].top()->seqNum;
+        DPRINTF(IQ, "Grew the IQ slots to %i.\n", slotSets.slots());
+    }
 
-    ListOrderIt list_it = listOrder.begin();
-    ListOrderIt list_end_it = listOrder.end();
+    int slot = freeSlots.back();
+    freeSlots.pop_back();
 
-    while (list_it != list_end_it) {
-        if ((*list_it).oldestInst > queue_entry.oldestInst) {
-            break;
-        }
+    slotInsts[slot] = inst;
+    slotSeqNums[slot] = inst->seqNum;
+    inst->iqSlot = slot;
 
-        list_it++;
-    }
+    return slot;
+}
 
-    readyIt[op_class] = listOrder.insert(list_it, queue_entry);
-    queueOnList[op_class] = true;
+template <class Impl>
+void
+InstructionQueue<Impl>::releaseSlot(int slot)
+{
+    if (slotSets.test(EntryRow, slot) || slotSets.test(AnyReadyRow, slot))
+        return;
+
+    slotInsts[slot]->iqSlot = -1;
+    slotInsts[slot] = NULL;
+    freeSlots.push_back(slot);
 }
 
 template <class Impl>
 void
-InstructionQueue<Impl>::moveToYoungerInst(ListOrderIt list_order_it)
+InstructionQueue<Impl>::addToReadySlots(DynInstPtr &inst)
 {
-    // Get iterator of next item on the list
-    // Delete the original iterator
-    // Determine if the next item is either the end of the list or younger
-    // than the new instruction.  If so, then add in a new iterator right here.
-    // If not, then move along.
-    ListOrderEntry queue_entry;
-    OpClass op_class = (*list_order_it).queueType;
-    ListOrderIt next_it = list_order_it;
-
-    ++next_it;
-
-    queue_entry.queueType = op_class;
-    queue_entry.oldestInst = readyInsts[op_class].top()->seqNum;
-
-    while (next_it != listOrder.end() &&
-           (*next_it).oldestInst < queue_entry.oldestInst) {
-        ++next_it;
+    int slot = inst->iqSlot >= 0 ? inst->iqSlot : allocateSlot(inst);
+
+    assert(slotInsts[slot] == inst);
+
+    slotSets.set(inst->opClass(), slot);
+    slotSets.set(AnyReadyRow, slot);
+}
+
+template <class Impl>
+void
+InstructionQueue<Impl>::removeFromReadySlots(int slot)
+{
+    slotSets.reset(slotInsts[slot]->opClass(), slot);
+    slotSets.reset(AnyReadyRow, slot);
+    slotSets.reset(SelectRow, slot);
+
+    releaseSlot(slot);
+}
+
+template <class Impl>
+void
+InstructionQueue<Impl>::releaseEntry(DynInstPtr &inst)
+{
+    int slot = inst->iqSlot;
+
+    if (slot < 0)
+        return;
+
+    slotSets.reset(EntryRow, slot);
+
+    releaseSlot(slot);
+}
+
+template <class Impl>
+int
+InstructionQueue<Impl>::oldestSelectable() const
+{
+    int oldest = -1;
+
+    for (int slot = slotSets.findNext(SelectRow, 0); slot >= 0;
+         slot = slotSets.findNext(SelectRow, slot + 1)) {
+        if (oldest < 0 || slotSeqNums[slot] < slotSeqNums[oldest])
+            oldest = slot;
     }
 
-    readyIt[op_class] = listOrder.insert(next_it, queue_entry);
+    return oldest;
 }
 
 template <class Impl>
@@ -757,42 +793,26 @@ InstructionQueue<Impl>::scheduleReadyInsts()
         total_deferred_mem_issued++;
     }
 
-    // Have iterator to head of the list
-    // While I haven't exceeded bandwidth or reached the end of the list,
-    // Try to get a FU that can do what this op needs.
-    // If successful, change the oldestInst to the new top of the list, put
-    // the queue in the proper place in the list.
-    // Increment the iterator.
-    // This will avoid trying to schedule a certain op class if there are no
-    // FUs that handle it.
-    ListOrderIt order_it = listOrder.begin();
-    ListOrderIt order_end_it = listOrder.end();
+    // Each pick is the oldest ready instruction among the op classes
+    // that may still issue this cycle.  An op class whose FUs are all
+    // busy is dropped from the select row for the rest of the cycle.
+    slotSets.copyRow(SelectRow, AnyReadyRow);
     int total_issued = 0;
 
     while (total_issued < (totalWidth - total_deferred_mem_issued) &&
-           iewStage->canIssue() &&
-           order_it != order_end_it) {
-        OpClass op_class = (*order_it).queueType;
+           iewStage->canIssue()) {
+        int slot = oldestSelectable();
 
-        assert(!readyInsts[op_class].empty());
+        if (slot < 0)
+            break;
 
-        DynInstPtr issuing_inst = readyInsts[op_class].top();
+        DynInstPtr issuing_inst = slotInsts[slot];
+        OpClass op_class = issuing_inst->opClass();
 
         issuing_inst->isFloating() ? fpInstQueueReads++ : intInstQueueReads++;
 
-        assert(issuing_inst->seqNum == (*order_it).oldestInst);
-
         if (issuing_inst->isSquashed()) {
-            readyInsts[op_class].pop();
-
-            if (!readyInsts[op_class].empty()) {
-                moveToYoungerInst(order_it);
-            } else {
-                readyIt[op_class] = listOrder.end();
-                queueOnList[op_class] = false;
-            }
-
-            listOrder.erase(order_it++);
+            removeFromReadySlots(slot);
 
             ++iqSquashedInstsIssued;
 
@@ -847,14 +867,7 @@ InstructionQueue<Impl>::scheduleReadyInsts()
                     tid, issuing_inst->pcState(),
                     issuing_inst->seqNum);
 
-            readyInsts[op_class].pop();
-
-            if (!readyInsts[op_class].empty()) {
-                moveToYoungerInst(order_it);
-            } else {
-                readyIt[op_class] = listOrder.end();
-                queueOnList[op_class] = false;
-            }
+            removeFromReadySlots(slot);
 
             issuing_inst->setIssued();
             ++total_issued;
@@ -869,17 +882,17 @@ InstructionQueue<Impl>::scheduleReadyInsts()
                 ++freeEntries;
                 count[tid]--;
                 issuing_inst->clearInIQ();
+                releaseEntry(issuing_inst);
             } else {
                 memDepUnit[tid].issue(issuing_inst);
             }
 
-            listOrder.erase(order_it++);
             statIssuedInstType[tid][op_class]++;
             iewStage->incrWb(issuing_inst->seqNum);
         } else {
             statFuBusy[op_class]++;
             fuBusy[tid]++;
-            ++order_it;
+            slotSets.maskRow(SelectRow, op_class);
         }
     }
 
@@ -993,31 +1006,33 @@ InstructionQueue<Impl>::wakeDependents(DynInstPtr &completed_inst)
         DPRINTF(IQ, "Waking any dependents on register %i.\n",
                 (int) dest_reg);
 
-        //Go through the dependency chain, marking the registers as
-        //ready within the waiting instructions.
-        DynInstPtr dep_inst = dependGraph.pop(dest_reg);
+        // Go through the consumers of the register, marking it as
+        // ready within each of them.  An instruction that reads the
+        // register through several operands was added once for each
+        // of them and has that many operands marked ready here.
+        for (int slot = consumers.findNext(dest_reg, 0); slot >= 0;
+             slot = consumers.findNext(dest_reg, slot + 1)) {
+            DynInstPtr dep_inst = slotInsts[slot];
 
-        while (dep_inst) {
             DPRINTF(IQ, "Waking up a dependent instruction, [sn:%lli] "
                     "PC %s.\n", dep_inst->seqNum, dep_inst->pcState());
 
-            // Might want to give more information to the instruction
-            // so that it knows which of its source registers is
-            // ready.  However that would mean that the dependency
-            // graph entries would need to hold the src_reg_idx.
-            dep_inst->markSrcRegReady();
-
-            addIfReady(dep_inst);
+            for (int src_reg_idx = 0;
+                 src_reg_idx < dep_inst->numSrcRegs();
+                 src_reg_idx++)
+            {
+                if (dep_inst->renamedSrcRegIdx(src_reg_idx) == dest_reg &&
+                    !dep_inst->isReadySrcRegIdx(src_reg_idx)) {
+                    dep_inst->markSrcRegReady();
 
-            dep_inst = dependGraph.pop(dest_reg);
+                    ++dependents;
+                }
+            }
 
-            ++dependents;
+            addIfReady(dep_inst);
         }
 
-        // Reset the head node now that all of its dependents have
-        // been woken up.
-        assert(dependGraph.empty(dest_reg));
-        dependGraph.clearInst(dest_reg);
+        consumers.clearRow(dest_reg);
 
         // Mark the scoreboard as having that register ready.
         regScoreboard[dest_reg] = true;
@@ -1031,17 +1046,7 @@ InstructionQueue<Impl>::addReadyMemInst(DynInstPtr &ready_inst)
 {
     OpClass op_class = ready_inst->opClass();
 
-    readyInsts[op_class].push(ready_inst);
-
-    // Will need to reorder the list if either a queue is not on the list,
-    // or it has an older instruction than last time.
-    if (!queueOnList[op_class]) {
-        addToOrderList(op_class);
-    } else if (readyInsts[op_class].top()->seqNum  <
-               (*readyIt[op_class]).oldestInst) {
-        listOrder.erase(readyIt[op_class]);
-        addToOrderList(op_class);
-    }
+    addToReadySlots(ready_inst);
 
     DPRINTF(IQ, "Instruction is ready to issue, putting it onto "
             "the ready list, PC %s opclass:%i [sn:%lli].\n",
@@ -1080,6 +1085,8 @@ InstructionQueue<Impl>::completeMemInst(DynInstPtr &completed_inst)
 
     ++freeEntries;
 
+    releaseEntry(completed_inst);
+
     completed_inst->memOpDone(true);
 
     memDepUnit[tid].completed(completed_inst);
@@ -1195,7 +1202,7 @@ InstructionQueue<Impl>::doSquash(ThreadID tid)
 
                     if (!squashed_inst->isReadySrcRegIdx(src_reg_idx) &&
                         src_reg < numPhysRegs) {
-                        dependGraph.remove(src_reg, squashed_inst);
+                        consumers.reset(src_reg, squashed_inst->iqSlot);
                     }
 
 
@@ -1233,6 +1240,8 @@ InstructionQueue<Impl>::doSquash(ThreadID tid)
             count[squashed_inst->threadNumber]--;
 
             ++freeEntries;
+
+            releaseEntry(squashed_inst);
         }
 
         instList[tid].erase(squash_it--);
@@ -1268,7 +1277,7 @@ InstructionQueue<Impl>::addToDependents(DynInstPtr &new_inst)
                         "is being added to the dependency chain.\n",
                         new_inst->pcState(), src_reg);
 
-                dependGraph.insert(src_reg, new_inst);
+                consumers.set(src_reg, new_inst->iqSlot);
 
                 // Change the return value to indicate that something
                 // was added to the dependency graph.
@@ -1310,13 +1319,10 @@ InstructionQueue<Impl>::addToProducers(DynInstPtr &new_inst)
             continue;
         }
 
-        if (!dependGraph.empty(dest_reg)) {
-            dependGraph.dump();
+        if (!consumers.none(dest_reg)) {
             panic("Dependency graph %i not empty!", dest_reg);
         }
 
-        dependGraph.setInst(dest_reg, new_inst);
-
         // Mark the scoreboard to say it's not yet ready.
         regScoreboard[dest_reg] = false;
     }
@@ -1348,17 +1354,7 @@ InstructionQueue<Impl>::addIfReady(DynInstPtr &inst)
                 "the ready list, PC %s opclass:%i [sn:%lli].\n",
                 inst->pcState(), op_class, inst->seqNum);
 
-        readyInsts[op_class].push(inst);
-
-        // Will need to reorder the list if either a queue is not on the list,
-        // or it has an older instruction than last time.
-        if (!queueOnList[op_class]) {
-            addToOrderList(op_class);
-        } else if (readyInsts[op_class].top()->seqNum  <
-                   (*readyIt[op_class]).oldestInst) {
-            listOrder.erase(readyIt[op_class]);
-            addToOrderList(op_class);
-        }
+        addToReadySlots(inst);
     }
 }
 
@@ -1403,7 +1399,12 @@ void
 InstructionQueue<Impl>::dumpLists()
 {
     for (int i = 0; i < Num_OpClasses; ++i) {
-        cprintf("Ready list %i size: %i\n", i, readyInsts[i].size());
+        cprintf("Ready list %i: ", i);
+
+        for (int slot = slotSets.findNext(i, 0); slot >= 0;
+             slot = slotSets.findNext(i, slot + 1)) {
+            cprintf("[sn:%lli] ", slotSeqNums[slot]);
+        }
 
         cprintf("\n");
     }
@@ -1423,21 +1424,7 @@ InstructionQueue<Impl>::dumpLists()
 
     cprintf("\n");
 
-    ListOrderIt list_order_it = listOrder.begin();
-    ListOrderIt list_order_end_it = listOrder.end();
-    int i = 1;
-
-    cprintf("List order: ");
-
-    while (list_order_it != list_order_end_it) {
-        cprintf("%i OpClass:%i [sn:%lli] ", i, (*list_order_it).queueType,
-                (*list_order_it).oldestInst);
-
-        ++list_order_it;
-        ++i;
-    }
-
-    cprintf("\n");
+    cprintf("Free slots: %i of %i\n", freeSlots.size(), slotSets.slots());
 }
 
 
@@ -148,7 +148,8 @@ class MemDepUnit
     void dumpLists();
 
   private:
-    typedef typename std::list<DynInstPtr>::iterator ListIt;
+    typedef typename Impl::InstList InstList;
+    typedef typename InstList::iterator ListIt;
 
     class MemDepEntry;
 
@@ -230,10 +231,10 @@ class MemDepUnit
     MemDepHash memDepHash;
 
     /** A list of all instructions in the memory dependence unit. */
-    std::list<DynInstPtr> instList[Impl::MaxThreads];
+    InstList instList[Impl::MaxThreads];
 
     /** A list of all instructions that are going to be replayed. */
-    std::list<DynInstPtr> instsToReplay;
+    InstList instsToReplay;
 
     /** The memory dependence predictor.  It is accessed upon new
      *  instructions being added to the IQ, and responds by telling
@@ -77,8 +77,8 @@ class DefaultRename
     // be added to the front of the list, which is the only reason for
     // using a list instead of a queue. (Most other stages use a
     // queue)
-    typedef std::list<DynInstPtr> InstQueue;
-    typedef typename std::list<DynInstPtr>::iterator ListIt;
+    typedef typename Impl::InstList InstQueue;
+    typedef typename InstQueue::iterator ListIt;
 
   public:
     /** Overall rename status. Used to determine if the CPU can
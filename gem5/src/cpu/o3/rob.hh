@@ -54,7 +54,8 @@ class ROB
     typedef typename Impl::DynInstPtr DynInstPtr;
 
     typedef std::pair<RegIndex, PhysRegIndex> UnmapInfo;
-    typedef typename std::list<DynInstPtr>::iterator InstIt;
+    typedef typename Impl::InstList InstList;
+    typedef typename InstList::iterator InstIt;
 
     /** Possible ROB statuses. */
     enum Status {
@@ -280,7 +281,7 @@ class ROB
     unsigned maxEntries[Impl::MaxThreads];
 
     /** ROB List of Instructions */
-    std::list<DynInstPtr> instList[Impl::MaxThreads];
+    InstList instList[Impl::MaxThreads];
 
     /** Number of instructions that can be squashed in a single cycle. */
     unsigned squashWidth;
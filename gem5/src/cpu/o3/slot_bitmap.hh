@@ -0,0 +1,169 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_O3_SLOT_BITMAP_HH__
+#define __CPU_O3_SLOT_BITMAP_HH__
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#include "base/types.hh"
+
+/**
+ * A fixed number of equally long bit vectors, indexed by IQ slot.
+ * The IQ keeps the ready slots of each op class and the slots waiting
+ * on each physical register in these rows, so that wakeup and select
+ * work a word at a time instead of walking linked lists.
+ */
+class SlotBitmap
+{
+  public:
+    typedef uint64_t Word;
+
+    static const int WordBits = 64;
+
+    SlotBitmap()
+        : numRows(0), numWords(0)
+    { }
+
+    /**
+     * Make the bitmap rows by slots bits.  The slot count is rounded
+     * up to a whole number of words and existing bits are kept.
+     */
+    void
+    resize(int rows, int slots)
+    {
+        int words = (slots + WordBits - 1) / WordBits;
+        std::vector<Word> new_bits(rows * words, 0);
+
+        for (int r = 0; r < std::min(rows, numRows); ++r) {
+            std::copy(bits.begin() + r * numWords,
+                      bits.begin() + r * numWords + std::min(words, numWords),
+                      new_bits.begin() + r * words);
+        }
+
+        bits.swap(new_bits);
+        numRows = rows;
+        numWords = words;
+    }
+
+    /** Number of slots each row can hold. */
+    int slots() const { return numWords * WordBits; }
+
+    void clear() { std::fill(bits.begin(), bits.end(), 0); }
+
+    void set(int row, int slot) { bits[index(row, slot)] |= mask(slot); }
+
+    void reset(int row, int slot) { bits[index(row, slot)] &= ~mask(slot); }
+
+    bool
+    test(int row, int slot) const
+    {
+        return bits[index(row, slot)] & mask(slot);
+    }
+
+    /** Is no bit set in the row? */
+    bool
+    none(int row) const
+    {
+        const Word *w = &bits[row * numWords];
+        for (int i = 0; i < numWords; ++i) {
+            if (w[i])
+                return false;
+        }
+        return true;
+    }
+
+    void
+    clearRow(int row)
+    {
+        std::fill(bits.begin() + row * numWords,
+                  bits.begin() + (row + 1) * numWords, 0);
+    }
+
+    /** Overwrite row dst with row src. */
+    void
+    copyRow(int dst, int src)
+    {
+        std::copy(bits.begin() + src * numWords,
+                  bits.begin() + (src + 1) * numWords,
+                  bits.begin() + dst * numWords);
+    }
+
+    /** Clear the bits of row dst that are set in row src. */
+    void
+    maskRow(int dst, int src)
+    {
+        Word *d = &bits[dst * numWords];
+        const Word *s = &bits[src * numWords];
+        for (int i = 0; i < numWords; ++i)
+            d[i] &= ~s[i];
+    }
+
+    /**
+     * Find the first set bit in a row at or after a slot.
+     * @return The slot index, or -1 if there is none.
+     */
+    int
+    findNext(int row, int slot) const
+    {
+        if (slot >= slots())
+            return -1;
+
+        const Word *w = &bits[row * numWords];
+        int i = slot / WordBits;
+        Word word = w[i] & (~Word(0) << (slot % WordBits));
+
+        while (true) {
+            if (word)
+                return i * WordBits + __builtin_ctzll(word);
+            if (++i == numWords)
+                return -1;
+            word = w[i];
+        }
+    }
+
+  private:
+    int
+    index(int row, int slot) const
+    {
+        assert(row < numRows && slot < slots());
+        return row * numWords + slot / WordBits;
+    }
+
+    static Word mask(int slot) { return Word(1) << (slot % WordBits); }
+
+    /** Number of rows. */
+    int numRows;
+
+    /** Number of words in each row. */
+    int numWords;
+
+    /** The rows, one after another. */
+    std::vector<Word> bits;
+};
+
+#endif // __CPU_O3_SLOT_BITMAP_HH__
@@ -107,6 +107,14 @@ class PCEventQueue
         return doService(tc);
     }
 
+    /** Get the PCs of all the events, in ascending order. */
+    void getPCs(std::vector<Addr> &pcs) const
+    {
+        pcs.clear();
+        for (const_iterator i = pc_map.begin(); i != pc_map.end(); ++i)
+            pcs.push_back((*i)->pc());
+    }
+
     range_t equal_range(Addr pc);
     range_t equal_range(PCEvent *event) { return equal_range(event->pc()); }
 
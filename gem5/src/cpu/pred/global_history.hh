@@ -0,0 +1,143 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_PRED_GLOBAL_HISTORY_HH__
+#define __CPU_PRED_GLOBAL_HISTORY_HH__
+
+#include <cassert>
+#include <vector>
+
+#include "base/intmath.hh"
+#include "base/types.hh"
+
+/**
+ * A long, speculatively updated global branch history with folded
+ * (compressed) copies of its most recent bits, as used to index and
+ * tag the tables of TAGE-like predictors. Each fold keeps the XOR of
+ * successive chunks of the newest length bits in width bits, and is
+ * updated in constant time when a branch outcome is pushed.
+ *
+ * The history is a circular buffer with room for the longest history
+ * and the branches in flight, so going back to an earlier point only
+ * needs the buffer position and the folds, which a Checkpoint holds.
+ */
+class GlobalHistory
+{
+  public:
+    /** Most folds one history can keep. */
+    static const unsigned MaxFolds = 48;
+
+    /** Branches that may be in flight beyond the longest history. */
+    static const unsigned MaxInFlight = 4096;
+
+    struct Checkpoint
+    {
+        unsigned ptr;
+        uint32_t folds[MaxFolds];
+    };
+
+  private:
+    struct Fold
+    {
+        uint32_t comp;
+        unsigned length;
+        unsigned width;
+        unsigned outpoint;
+    };
+
+    /** One byte per outcome, the newest at ptr. */
+    std::vector<uint8_t> hist;
+    unsigned ptr;
+    unsigned mask;
+
+    Fold folds[MaxFolds];
+    unsigned numFolds;
+
+  public:
+    GlobalHistory() : ptr(0), mask(0), numFolds(0) {}
+
+    void
+    init(unsigned max_length)
+    {
+        hist.assign(ceilPow2(max_length + MaxInFlight), 0);
+        mask = hist.size() - 1;
+        ptr = 0;
+    }
+
+    /**
+     * Adds a fold of the newest length outcomes into width bits.
+     * @return The index of the fold.
+     */
+    unsigned
+    addFold(unsigned length, unsigned width)
+    {
+        assert(numFolds < MaxFolds && width > 0 && width < 32);
+        assert(length <= hist.size() - MaxInFlight);
+        Fold &f = folds[numFolds];
+        f.comp = 0;
+        f.length = length;
+        f.width = width;
+        f.outpoint = length % width;
+        return numFolds++;
+    }
+
+    uint32_t fold(unsigned i) const { return folds[i].comp; }
+
+    /** Returns the outcome pos branches back, 0 being the newest. */
+    bool bit(unsigned pos) const { return hist[(ptr + pos) & mask]; }
+
+    void
+    push(bool taken)
+    {
+        ptr = (ptr - 1) & mask;
+        hist[ptr] = taken;
+
+        for (unsigned i = 0; i < numFolds; i++) {
+            Fold &f = folds[i];
+            f.comp = (f.comp << 1) | taken;
+            f.comp ^= uint32_t(hist[(ptr + f.length) & mask]) << f.outpoint;
+            f.comp ^= f.comp >> f.width;
+            f.comp &= (1 << f.width) - 1;
+        }
+    }
+
+    void
+    save(Checkpoint &cp) const
+    {
+        cp.ptr = ptr;
+        for (unsigned i = 0; i < numFolds; i++)
+            cp.folds[i] = folds[i].comp;
+    }
+
+    void
+    restore(const Checkpoint &cp)
+    {
+        ptr = cp.ptr;
+        for (unsigned i = 0; i < numFolds; i++)
+            folds[i].comp = cp.folds[i];
+    }
+};
+
+#endif // __CPU_PRED_GLOBAL_HISTORY_HH__
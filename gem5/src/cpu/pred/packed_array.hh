@@ -0,0 +1,125 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_PRED_PACKED_ARRAY_HH__
+#define __CPU_PRED_PACKED_ARRAY_HH__
+
+#include <cassert>
+#include <vector>
+
+#include "base/intmath.hh"
+#include "base/types.hh"
+
+/**
+ * A table of small fields packed into 64-bit words, for predictor
+ * tables that would otherwise take a SatCounter (or at least a byte)
+ * per entry. The number of fields per word is rounded down to a
+ * power of two so that finding a field takes only shifts and masks;
+ * no field straddles two words.
+ */
+class PackedArray
+{
+  private:
+    std::vector<uint64_t> words;
+
+    /** Width of a field in bits. */
+    unsigned bits;
+
+    /** log2 of the number of fields per word. */
+    unsigned perWordShift;
+
+    uint64_t fieldMask;
+
+    unsigned _size;
+
+  public:
+    PackedArray() : bits(0), perWordShift(0), fieldMask(0), _size(0) {}
+
+    /** Sets the table to size fields of the given width, all zero. */
+    void
+    init(unsigned size, unsigned _bits)
+    {
+        assert(_bits > 0 && _bits <= 32);
+        bits = _bits;
+        perWordShift = floorLog2(64 / bits);
+        fieldMask = (ULL(1) << bits) - 1;
+        _size = size;
+        words.assign(divCeil(size, 1 << perWordShift), 0);
+    }
+
+    unsigned size() const { return _size; }
+
+    uint32_t
+    get(unsigned i) const
+    {
+        assert(i < _size);
+        unsigned shift = (i & ((1 << perWordShift) - 1)) * bits;
+        return (words[i >> perWordShift] >> shift) & fieldMask;
+    }
+
+    void
+    set(unsigned i, uint32_t val)
+    {
+        assert(i < _size);
+        unsigned shift = (i & ((1 << perWordShift) - 1)) * bits;
+        uint64_t &word = words[i >> perWordShift];
+        word = (word & ~(fieldMask << shift)) |
+            ((uint64_t(val) & fieldMask) << shift);
+    }
+
+    /** Reads a field as a two's complement number. */
+    int
+    getSigned(unsigned i) const
+    {
+        return int32_t(get(i) << (32 - bits)) >> (32 - bits);
+    }
+
+    void setSigned(unsigned i, int val) { set(i, val); }
+
+    /** Moves an unsigned saturating counter up or down. */
+    void
+    count(unsigned i, bool up)
+    {
+        uint32_t val = get(i);
+        if (up && val < fieldMask)
+            set(i, val + 1);
+        else if (!up && val > 0)
+            set(i, val - 1);
+    }
+
+    /** Moves a signed saturating counter up or down. */
+    void
+    countSigned(unsigned i, bool up)
+    {
+        int val = getSigned(i);
+        int max = fieldMask >> 1;
+        if (up && val < max)
+            setSigned(i, val + 1);
+        else if (!up && val > -max - 1)
+            setSigned(i, val - 1);
+    }
+};
+
+#endif // __CPU_PRED_PACKED_ARRAY_HH__
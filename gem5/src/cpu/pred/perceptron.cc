@@ -0,0 +1,180 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cmath>
+#include <cstdlib>
+
+#include "base/intmath.hh"
+#include "base/misc.hh"
+#include "cpu/pred/perceptron.hh"
+
+// fatal() takes its arguments by reference
+const unsigned PerceptronBP::MaxTables;
+
+PerceptronBP::PerceptronBP(unsigned _numTables,
+                           unsigned _tableSize,
+                           unsigned weightBits,
+                           unsigned historyBits,
+                           unsigned _instShiftAmt)
+    : numTables(_numTables),
+      tableSize(_tableSize),
+      instShiftAmt(_instShiftAmt),
+      threshold(_numTables),
+      thresholdCtr(0)
+{
+    if (numTables < 2 || numTables > MaxTables)
+        fatal("The perceptron needs 2 to %d tables!\n", MaxTables);
+
+    if (!isPowerOf2(tableSize) || tableSize < 2)
+        fatal("Invalid perceptron table size!\n");
+
+    if (weightBits < 2 || weightBits > 16)
+        fatal("Invalid perceptron weight size!\n");
+
+    if (historyBits < 3)
+        fatal("Invalid perceptron history length!\n");
+
+    ghist.init(historyBits);
+
+    tables.resize(numTables);
+    histFold.resize(numTables);
+    for (unsigned i = 0; i < numTables; i++) {
+        tables[i].init(tableSize, weightBits);
+        if (i == 0)
+            continue;
+
+        // Geometric series of history lengths from 3 to historyBits
+        double ratio = numTables > 2 ?
+            pow(historyBits / 3.0, (double)(i - 1) / (numTables - 2)) : 1;
+        unsigned length = numTables > 2 ?
+            (unsigned)(3 * ratio + 0.5) : historyBits;
+        histFold[i] = ghist.addFold(length, floorLog2(tableSize));
+    }
+}
+
+bool
+PerceptronBP::lookup(Addr branch_addr, void * &bp_history)
+{
+    BPHistory *history = new BPHistory;
+    ghist.save(history->hist);
+    history->uncond = false;
+    history->btbMiss = false;
+
+    Addr pc = branch_addr >> instShiftAmt;
+    unsigned mask = tableSize - 1;
+
+    int sum = 0;
+    for (unsigned i = 0; i < numTables; i++) {
+        unsigned idx = i ?
+            (pc ^ (pc >> (i + 1)) ^ ghist.fold(histFold[i])) & mask :
+            pc & mask;
+        history->index[i] = idx;
+        sum += tables[i].getSigned(idx);
+    }
+    history->sum = sum;
+
+    bool taken = sum >= 0;
+    ghist.push(taken);
+
+    bp_history = (void *)history;
+    return taken;
+}
+
+void
+PerceptronBP::uncondBr(void * &bp_history)
+{
+    BPHistory *history = new BPHistory;
+    ghist.save(history->hist);
+    history->uncond = true;
+    history->btbMiss = false;
+    bp_history = static_cast<void *>(history);
+
+    ghist.push(true);
+}
+
+void
+PerceptronBP::BTBUpdate(Addr branch_addr, void * &bp_history)
+{
+    BPHistory *history = static_cast<BPHistory *>(bp_history);
+
+    ghist.restore(history->hist);
+    history->btbMiss = true;
+    ghist.push(false);
+}
+
+void
+PerceptronBP::update(Addr branch_addr, bool taken, void *bp_history,
+                     bool squashed)
+{
+    BPHistory *history = static_cast<BPHistory *>(bp_history);
+
+    // A branch that was fetched as not taken for lack of a BTB entry
+    // was not taken if it wasn't squashed
+    if (!squashed && history->btbMiss)
+        taken = false;
+
+    if (squashed) {
+        ghist.restore(history->hist);
+        ghist.push(taken);
+    }
+
+    if (!history->uncond) {
+        int sum = history->sum;
+        bool pred = sum >= 0;
+
+        // Tune the threshold so that about as many updates come from
+        // mispredictions as from low confidence correct predictions
+        if (pred != taken) {
+            if (++thresholdCtr >= ThresholdCtrMax) {
+                thresholdCtr = 0;
+                threshold++;
+            }
+        } else if (std::abs(sum) <= threshold) {
+            if (--thresholdCtr <= -ThresholdCtrMax) {
+                thresholdCtr = 0;
+                if (threshold > 1)
+                    threshold--;
+            }
+        }
+
+        if (pred != taken || std::abs(sum) <= threshold) {
+            for (unsigned i = 0; i < numTables; i++)
+                tables[i].countSigned(history->index[i], taken);
+        }
+    }
+
+    delete history;
+}
+
+void
+PerceptronBP::squash(void *bp_history)
+{
+    BPHistory *history = static_cast<BPHistory *>(bp_history);
+
+    // Restore global history to state prior to this branch.
+    ghist.restore(history->hist);
+
+    delete history;
+}
@@ -0,0 +1,142 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_PRED_PERCEPTRON_HH__
+#define __CPU_PRED_PERCEPTRON_HH__
+
+#include <vector>
+
+#include "base/types.hh"
+#include "cpu/pred/global_history.hh"
+#include "cpu/pred/packed_array.hh"
+
+/**
+ * Implements a hashed perceptron branch predictor (Tarjan and
+ * Skadron, "Merging path and gshare indexing in perceptron branch
+ * prediction"). Each table holds signed weights; the first one is
+ * indexed by the branch address alone and the others by the address
+ * hashed with global histories of geometrically increasing length. The
+ * prediction is the sign of the sum of the weights, which are trained
+ * when the prediction was wrong or the sum was below a threshold that
+ * adapts as in O-GEHL. The weight tables are packed bit arrays.
+ */
+class PerceptronBP
+{
+  public:
+    /** Most weight tables there can be. */
+    static const unsigned MaxTables = 32;
+
+    /**
+     * Default branch predictor constructor.
+     * @param numTables Number of weight tables.
+     * @param tableSize Weights per table.
+     * @param weightBits Bits of a weight.
+     * @param historyBits Global history length of the last table.
+     */
+    PerceptronBP(unsigned numTables,
+                 unsigned tableSize,
+                 unsigned weightBits,
+                 unsigned historyBits,
+                 unsigned instShiftAmt);
+
+    /**
+     * Looks up the given address in the branch predictor and returns
+     * a true/false value as to whether it is taken.  Also creates a
+     * BPHistory object to store any state it will need on squash/update.
+     * @param branch_addr The address of the branch to look up.
+     * @param bp_history Pointer that will be set to the BPHistory object.
+     * @return Whether or not the branch is taken.
+     */
+    bool lookup(Addr branch_addr, void * &bp_history);
+
+    /**
+     * Records that there was an unconditional branch.
+     * @param bp_history Pointer that will be set to the BPHistory object.
+     */
+    void uncondBr(void * &bp_history);
+
+    /**
+     * Makes the speculative history show the branch as not taken
+     * after the BTB had no target for it.
+     * @param branch_addr The address of the branch to look up.
+     * @param bp_history Pointer to any bp history state.
+     */
+    void BTBUpdate(Addr branch_addr, void * &bp_history);
+
+    /**
+     * Updates the branch predictor with the actual result of a branch.
+     * @param branch_addr The address of the branch to update.
+     * @param taken Whether or not the branch was taken.
+     * @param bp_history Pointer to the BPHistory object that was created
+     * when the branch was predicted.
+     * @param squashed is set when this function is called during a squash
+     * operation.
+     */
+    void update(Addr branch_addr, bool taken, void *bp_history,
+                bool squashed);
+
+    /**
+     * Restores the global history on a squash.
+     * @param bp_history Pointer to the BPHistory object of the branch.
+     */
+    void squash(void *bp_history);
+
+  private:
+    /** Limit of the counter that tunes the training threshold. */
+    static const int ThresholdCtrMax = 63;
+
+    /**
+     * The branch history information that is created upon predicting
+     * a branch.  It will be passed back upon updating and squashing,
+     * when the BP can use this information to update/restore its
+     * state properly.
+     */
+    struct BPHistory
+    {
+        GlobalHistory::Checkpoint hist;
+        bool uncond;
+        bool btbMiss;
+        unsigned index[MaxTables];
+        int sum;
+    };
+
+    /** Weight tables. */
+    std::vector<PackedArray> tables;
+
+    unsigned numTables;
+    unsigned tableSize;
+    unsigned instShiftAmt;
+
+    /** Fold numbers of the history of tables 1 to numTables - 1. */
+    std::vector<unsigned> histFold;
+
+    GlobalHistory ghist;
+
+    /** Sums with a smaller magnitude than this are trained. */
+    int threshold;
+    int thresholdCtr;
+};
+
+#endif // __CPU_PRED_PERCEPTRON_HH__
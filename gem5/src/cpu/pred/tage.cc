@@ -0,0 +1,618 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "base/intmath.hh"
+#include "base/misc.hh"
+#include "cpu/pred/tage.hh"
+
+const unsigned TageBP::SCHistLength[SCTables] = { 0, 4, 8, 16 };
+
+// fatal() and std::min() take their arguments by reference
+const unsigned TageBP::MaxTables;
+const unsigned TageBP::PathBits;
+
+TageBP::TageBP(unsigned _numTables,
+               unsigned _tableBits,
+               unsigned _tagBits,
+               unsigned minHist,
+               unsigned maxHist,
+               unsigned _bimodalSize,
+               unsigned _loopSize,
+               unsigned _scSize,
+               unsigned _instShiftAmt)
+    : numTables(_numTables),
+      tableBits(_tableBits),
+      tagBits(_tagBits),
+      bimodalSize(_bimodalSize),
+      instShiftAmt(_instShiftAmt),
+      pathHist(0),
+      useAltOnNA(0),
+      tick(0),
+      seed(1),
+      loopSize(_loopSize),
+      loopUseCtr(-1),
+      scSize(_scSize),
+      scThreshold(24),
+      scThresholdCtr(0)
+{
+    if (numTables < 2 || numTables > MaxTables)
+        fatal("TAGE needs 2 to %d tagged tables!\n", MaxTables);
+
+    if (tableBits < 2 || tableBits > 24)
+        fatal("Invalid TAGE table size!\n");
+
+    if (tagBits < 2 || tagBits + UBits + CtrBits > 32)
+        fatal("Invalid TAGE tag size!\n");
+
+    if (minHist < 1 || maxHist <= minHist)
+        fatal("Invalid TAGE history lengths!\n");
+
+    if (!isPowerOf2(bimodalSize))
+        fatal("Invalid TAGE bimodal predictor size!\n");
+
+    if (loopSize && (!isPowerOf2(loopSize) || loopSize < LoopWays))
+        fatal("Invalid loop predictor size!\n");
+
+    if (scSize && (!isPowerOf2(scSize) || scSize < 2))
+        fatal("Invalid statistical corrector size!\n");
+
+    ghist.init(std::max(maxHist, SCHistLength[SCTables - 1]));
+
+    // Geometric series of history lengths from minHist to maxHist
+    histLength.resize(numTables + 1);
+    indexFold.resize(numTables + 1);
+    tagFold.resize(numTables + 1);
+    tagFold2.resize(numTables + 1);
+    tables.resize(numTables + 1);
+    for (unsigned i = 1; i <= numTables; i++) {
+        double ratio = pow((double)maxHist / minHist,
+                           (double)(i - 1) / (numTables - 1));
+        histLength[i] = (unsigned)(minHist * ratio + 0.5);
+
+        tables[i].init(1 << tableBits, tagBits + UBits + CtrBits);
+        indexFold[i] = ghist.addFold(histLength[i], tableBits);
+        tagFold[i] = ghist.addFold(histLength[i], tagBits);
+        tagFold2[i] = ghist.addFold(histLength[i], tagBits - 1);
+    }
+
+    bimodal.init(bimodalSize, 2);
+
+    loops.resize(loopSize);
+    for (unsigned i = 0; i < loopSize; i++) {
+        LoopEntry &e = loops[i];
+        e.tag = e.numIter = e.currentIter = e.currentIterSpec = 0;
+        e.conf = e.age = 0;
+    }
+
+    if (scSize) {
+        scTables.resize(SCTables);
+        for (unsigned i = 0; i < SCTables; i++) {
+            scTables[i].init(scSize, SCCtrBits);
+            if (SCHistLength[i])
+                scFold[i] = ghist.addFold(SCHistLength[i], floorLog2(scSize));
+        }
+    }
+}
+
+uint32_t
+TageBP::nextRandom()
+{
+    // xorshift, so that runs are repeatable
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+unsigned
+TageBP::pathHash(unsigned path, unsigned size, unsigned bank)
+{
+    unsigned mask = (1 << tableBits) - 1;
+    bank %= tableBits;
+
+    path &= (1 << size) - 1;
+    unsigned a1 = path & mask;
+    unsigned a2 = path >> tableBits;
+    a2 = ((a2 << bank) & mask) + (a2 >> (tableBits - bank));
+    path = a1 ^ a2;
+    return ((path << bank) & mask) + (path >> (tableBits - bank));
+}
+
+unsigned
+TageBP::gindex(Addr branch_addr, unsigned bank, unsigned path)
+{
+    Addr pc = branch_addr >> instShiftAmt;
+    unsigned shift = (tableBits > bank ? tableBits - bank : bank - tableBits) + 1;
+    unsigned path_len = std::min(histLength[bank], PathBits);
+
+    return (pc ^ (pc >> shift) ^ ghist.fold(indexFold[bank]) ^
+            pathHash(path, path_len, bank)) & ((1 << tableBits) - 1);
+}
+
+unsigned
+TageBP::gtag(Addr branch_addr, unsigned bank)
+{
+    Addr pc = branch_addr >> instShiftAmt;
+
+    return (pc ^ ghist.fold(tagFold[bank]) ^
+            (ghist.fold(tagFold2[bank]) << 1)) & ((1 << tagBits) - 1);
+}
+
+void
+TageBP::ctrUpdate(unsigned bank, unsigned idx, bool taken)
+{
+    unsigned c = ctr(bank, idx);
+    if (taken && c < (1 << CtrBits) - 1)
+        c++;
+    else if (!taken && c > 0)
+        c--;
+    setEntry(bank, idx, entryTag(bank, idx), useful(bank, idx), c);
+}
+
+void
+TageBP::usefulUpdate(unsigned bank, unsigned idx, bool up)
+{
+    unsigned u = useful(bank, idx);
+    if (up && u < (1 << UBits) - 1)
+        u++;
+    else if (!up && u > 0)
+        u--;
+    setEntry(bank, idx, entryTag(bank, idx), u, ctr(bank, idx));
+}
+
+void
+TageBP::pushHistory(BPHistory *history, Addr branch_addr, bool taken)
+{
+    ghist.push(taken);
+    // Unconditional branches don't give their address
+    if (!history->uncond) {
+        pathHist = ((pathHist << 1) | pathBit(branch_addr)) &
+            ((1 << PathBits) - 1);
+    }
+}
+
+bool
+TageBP::lookup(Addr branch_addr, void * &bp_history)
+{
+    BPHistory *history = new BPHistory;
+    ghist.save(history->hist);
+    history->pathHist = pathHist;
+    history->uncond = false;
+    history->btbMiss = false;
+
+    history->bimodalIdx = (branch_addr >> instShiftAmt) & (bimodalSize - 1);
+    for (unsigned i = 1; i <= numTables; i++) {
+        history->index[i] = gindex(branch_addr, i, pathHist);
+        history->tag[i] = gtag(branch_addr, i);
+    }
+
+    // The longest matching table provides the prediction, and the
+    // next longest one the alternate prediction
+    unsigned hit = 0;
+    unsigned alt = 0;
+    for (unsigned i = numTables; i > 0; i--) {
+        if (entryTag(i, history->index[i]) == history->tag[i]) {
+            hit = i;
+            break;
+        }
+    }
+    for (unsigned i = hit ? hit - 1 : 0; i > 0; i--) {
+        if (entryTag(i, history->index[i]) == history->tag[i]) {
+            alt = i;
+            break;
+        }
+    }
+    history->hitBank = hit;
+    history->altBank = alt;
+
+    unsigned half = 1 << (CtrBits - 1);
+    bool bimodal_pred = bimodal.get(history->bimodalIdx) >= 2;
+    if (hit) {
+        history->altPred = alt ?
+            ctr(alt, history->index[alt]) >= half : bimodal_pred;
+
+        unsigned c = ctr(hit, history->index[hit]);
+        history->longestPred = c >= half;
+
+        // A newly allocated entry is less reliable than the alternate
+        // prediction, as long as that proves true
+        bool newly = (c == half || c == half - 1) &&
+            useful(hit, history->index[hit]) == 0;
+        history->tagePred = useAltOnNA >= 0 && newly ?
+            history->altPred : history->longestPred;
+    } else {
+        history->altPred = bimodal_pred;
+        history->longestPred = bimodal_pred;
+        history->tagePred = bimodal_pred;
+    }
+    history->pred = history->tagePred;
+
+    if (scSize)
+        scLookup(branch_addr, history);
+
+    history->loopIdx = -1;
+    if (loopSize)
+        loopLookup(branch_addr, history);
+
+    pushHistory(history, branch_addr, history->pred);
+    loopSpecUpdate(history, history->pred);
+
+    bp_history = (void *)history;
+    return history->pred;
+}
+
+void
+TageBP::uncondBr(void * &bp_history)
+{
+    BPHistory *history = new BPHistory;
+    ghist.save(history->hist);
+    history->pathHist = pathHist;
+    history->uncond = true;
+    history->btbMiss = false;
+    history->loopIdx = -1;
+    history->pred = true;
+    bp_history = static_cast<void *>(history);
+
+    pushHistory(history, 0, true);
+}
+
+void
+TageBP::BTBUpdate(Addr branch_addr, void * &bp_history)
+{
+    BPHistory *history = static_cast<BPHistory *>(bp_history);
+
+    ghist.restore(history->hist);
+    pathHist = history->pathHist;
+    if (history->loopIdx >= 0)
+        loops[history->loopIdx].currentIterSpec = history->loopIterSpec;
+
+    history->btbMiss = true;
+    pushHistory(history, branch_addr, false);
+    loopSpecUpdate(history, false);
+}
+
+void
+TageBP::update(Addr branch_addr, bool taken, void *bp_history,
+               bool squashed)
+{
+    BPHistory *history = static_cast<BPHistory *>(bp_history);
+
+    // A branch that was fetched as not taken for lack of a BTB entry
+    // was not taken if it wasn't squashed
+    if (!squashed && history->btbMiss)
+        taken = false;
+
+    if (squashed) {
+        // Redo the speculative updates with the actual outcome
+        ghist.restore(history->hist);
+        pathHist = history->pathHist;
+        if (history->loopIdx >= 0)
+            loops[history->loopIdx].currentIterSpec = history->loopIterSpec;
+
+        pushHistory(history, branch_addr, taken);
+        loopSpecUpdate(history, taken);
+    }
+
+    if (!history->uncond) {
+        if (loopSize)
+            loopUpdate(branch_addr, taken, history);
+        if (scSize)
+            scUpdate(taken, history);
+        tageUpdate(taken, history);
+    }
+
+    delete history;
+}
+
+void
+TageBP::squash(void *bp_history)
+{
+    BPHistory *history = static_cast<BPHistory *>(bp_history);
+
+    // Restore the histories to the state prior to this branch.
+    ghist.restore(history->hist);
+    pathHist = history->pathHist;
+    if (history->loopIdx >= 0)
+        loops[history->loopIdx].currentIterSpec = history->loopIterSpec;
+
+    delete history;
+}
+
+void
+TageBP::tageUpdate(bool taken, BPHistory *history)
+{
+    unsigned hit = history->hitBank;
+    unsigned alt = history->altBank;
+    unsigned half = 1 << (CtrBits - 1);
+
+    // The entries may have been replaced since the prediction
+    bool hit_valid = hit &&
+        entryTag(hit, history->index[hit]) == history->tag[hit];
+    bool alt_valid = alt &&
+        entryTag(alt, history->index[alt]) == history->tag[alt];
+
+    if (hit_valid) {
+        unsigned c = ctr(hit, history->index[hit]);
+        bool newly = (c == half || c == half - 1) &&
+            useful(hit, history->index[hit]) == 0;
+
+        // Learn whether newly allocated entries are to be trusted
+        if (newly && history->longestPred != history->altPred) {
+            if (history->altPred == taken) {
+                if (useAltOnNA < 7)
+                    useAltOnNA++;
+            } else if (useAltOnNA > -8) {
+                useAltOnNA--;
+            }
+        }
+    }
+
+    // Allocate an entry in a table with a longer history when the
+    // longest match was wrong, or age the candidates if none is free
+    if (history->longestPred != taken && hit < numTables) {
+        unsigned min_u = (1 << UBits) - 1;
+        for (unsigned i = hit + 1; i <= numTables; i++)
+            min_u = std::min(min_u, useful(i, history->index[i]));
+
+        if (min_u > 0) {
+            for (unsigned i = hit + 1; i <= numTables; i++)
+                usefulUpdate(i, history->index[i], false);
+        } else {
+            // Skip a table or two at random to spread allocations
+            unsigned first = hit + 1;
+            uint32_t r = nextRandom();
+            if ((r & 1) && first < numTables) {
+                first++;
+                if ((r & 2) && first < numTables)
+                    first++;
+            }
+            for (unsigned i = first; i <= numTables; i++) {
+                if (useful(i, history->index[i]) == 0) {
+                    setEntry(i, history->index[i], history->tag[i], 0,
+                             taken ? half : half - 1);
+                    break;
+                }
+            }
+        }
+    }
+
+    // Age the useful counters now and then, so that entries that
+    // were useful once can be replaced
+    if ((++tick & ((ULL(1) << 18) - 1)) == 0) {
+        for (unsigned i = 1; i <= numTables; i++) {
+            for (unsigned j = 0; j < tables[i].size(); j++) {
+                unsigned u = useful(i, j);
+                if (u)
+                    setEntry(i, j, entryTag(i, j), u >> 1, ctr(i, j));
+            }
+        }
+    }
+
+    if (hit_valid) {
+        unsigned idx = history->index[hit];
+        ctrUpdate(hit, idx, taken);
+
+        // An entry that isn't useful yet doesn't replace the
+        // alternate prediction, which keeps learning
+        if (useful(hit, idx) == 0) {
+            if (alt_valid)
+                ctrUpdate(alt, history->index[alt], taken);
+            else if (!alt)
+                bimodal.count(history->bimodalIdx, taken);
+        }
+
+        if (history->longestPred != history->altPred)
+            usefulUpdate(hit, idx, history->longestPred == taken);
+    } else if (!hit) {
+        bimodal.count(history->bimodalIdx, taken);
+    }
+}
+
+unsigned
+TageBP::loopTag(Addr branch_addr)
+{
+    Addr pc = branch_addr >> instShiftAmt;
+    return (pc >> floorLog2(loopSize / LoopWays)) &
+        ((1 << LoopTagBits) - 1);
+}
+
+void
+TageBP::loopLookup(Addr branch_addr, BPHistory *history)
+{
+    Addr pc = branch_addr >> instShiftAmt;
+    unsigned set = (pc & (loopSize / LoopWays - 1)) * LoopWays;
+    unsigned tag = loopTag(branch_addr);
+
+    history->loopValid = false;
+    for (unsigned w = 0; w < LoopWays; w++) {
+        LoopEntry &e = loops[set + w];
+        if (e.tag == tag) {
+            history->loopIdx = set + w;
+            history->loopIterSpec = e.currentIterSpec;
+            history->loopValid = e.conf == LoopMaxConf;
+            // The loop branch is taken until the trip count is reached
+            history->loopPred = e.currentIterSpec != e.numIter;
+            break;
+        }
+    }
+
+    if (history->loopValid && loopUseCtr >= 0)
+        history->pred = history->loopPred;
+}
+
+void
+TageBP::loopSpecUpdate(BPHistory *history, bool taken)
+{
+    if (history->loopIdx < 0)
+        return;
+
+    LoopEntry &e = loops[history->loopIdx];
+    e.currentIterSpec = taken ?
+        (e.currentIterSpec + 1) & ((1 << LoopIterBits) - 1) : 0;
+}
+
+void
+TageBP::loopUpdate(Addr branch_addr, bool taken, BPHistory *history)
+{
+    unsigned tag = loopTag(branch_addr);
+
+    if (history->loopIdx >= 0 && loops[history->loopIdx].tag == tag) {
+        LoopEntry &e = loops[history->loopIdx];
+
+        if (history->loopValid) {
+            if (history->loopPred != taken) {
+                // The trip count changed, start over
+                e.numIter = 0;
+                e.currentIter = 0;
+                e.conf = 0;
+                e.age = 0;
+                return;
+            }
+
+            if (history->loopPred != history->tagePred) {
+                if (loopUseCtr < 63)
+                    loopUseCtr++;
+                if (e.age < LoopMaxAge)
+                    e.age++;
+            }
+        } else if (e.conf == LoopMaxConf &&
+                   history->loopPred != history->tagePred) {
+            // Train the choice even while it isn't used
+            if (history->loopPred == taken) {
+                if (loopUseCtr < 63)
+                    loopUseCtr++;
+            } else if (loopUseCtr > -64) {
+                loopUseCtr--;
+            }
+        }
+
+        if (taken) {
+            e.currentIter = (e.currentIter + 1) & ((1 << LoopIterBits) - 1);
+            // Longer than the trip count that was learnt
+            if (e.numIter && e.currentIter > e.numIter) {
+                e.numIter = 0;
+                e.conf = 0;
+            }
+        } else {
+            if (e.currentIter == e.numIter) {
+                if (e.conf < LoopMaxConf)
+                    e.conf++;
+                // Short loops are left to TAGE
+                if (e.numIter < 3) {
+                    e.numIter = 0;
+                    e.conf = 0;
+                    e.age = 0;
+                }
+            } else if (e.numIter == 0) {
+                // The first complete trip
+                e.numIter = e.currentIter;
+                e.conf = 0;
+            } else {
+                e.numIter = 0;
+                e.conf = 0;
+            }
+            e.currentIter = 0;
+        }
+    } else if (taken && history->tagePred != taken && !(nextRandom() & 3)) {
+        // Replace an entry that hasn't been useful for a while
+        Addr pc = branch_addr >> instShiftAmt;
+        unsigned set = (pc & (loopSize / LoopWays - 1)) * LoopWays;
+        LoopEntry &e = loops[set + (nextRandom() & (LoopWays - 1))];
+        if (e.age == 0) {
+            e.tag = tag;
+            e.numIter = 0;
+            e.currentIter = 0;
+            e.currentIterSpec = 0;
+            e.conf = 0;
+            e.age = LoopMaxAge;
+        } else {
+            e.age--;
+        }
+    }
+}
+
+void
+TageBP::scLookup(Addr branch_addr, BPHistory *history)
+{
+    Addr pc = branch_addr >> instShiftAmt;
+    unsigned mask = scSize - 1;
+
+    // TAGE's prediction is part of the index, so that the corrector
+    // learns where it goes wrong
+    unsigned pred_bit = history->tagePred ? scSize >> 1 : 0;
+
+    int sum = 0;
+    for (unsigned i = 0; i < SCTables; i++) {
+        unsigned h = SCHistLength[i] ? ghist.fold(scFold[i]) : 0;
+        unsigned idx = ((pc ^ (pc >> (i + 2)) ^ h) & mask) ^ pred_bit;
+        history->scIdx[i] = idx;
+        sum += 2 * scTables[i].getSigned(idx) + 1;
+    }
+
+    // TAGE votes with the confidence of its counter
+    int conf = 1;
+    if (history->hitBank) {
+        int c = ctr(history->hitBank, history->index[history->hitBank]);
+        conf = std::abs(2 * c - ((1 << CtrBits) - 1));
+    }
+    sum += (history->tagePred ? 16 : -16) * conf;
+
+    history->scSum = sum;
+    history->scPred = sum >= 0;
+    if (history->scPred != history->tagePred &&
+        std::abs(sum) >= scThreshold)
+        history->pred = history->scPred;
+}
+
+void
+TageBP::scUpdate(bool taken, BPHistory *history)
+{
+    int sum = history->scSum;
+
+    // Only the threshold for overriding TAGE is tuned
+    if (history->scPred != history->tagePred) {
+        if (history->scPred != taken) {
+            if (++scThresholdCtr >= ThresholdCtrMax) {
+                scThresholdCtr = 0;
+                scThreshold++;
+            }
+        } else if (std::abs(sum) < scThreshold) {
+            if (--scThresholdCtr <= -ThresholdCtrMax) {
+                scThresholdCtr = 0;
+                if (scThreshold > 1)
+                    scThreshold--;
+            }
+        }
+    }
+
+    if (history->scPred != taken || std::abs(sum) < scThreshold) {
+        for (unsigned i = 0; i < SCTables; i++)
+            scTables[i].countSigned(history->scIdx[i], taken);
+    }
+}
@@ -0,0 +1,277 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_PRED_TAGE_HH__
+#define __CPU_PRED_TAGE_HH__
+
+#include <vector>
+
+#include "base/types.hh"
+#include "cpu/pred/global_history.hh"
+#include "cpu/pred/packed_array.hh"
+
+/**
+ * Implements a TAGE branch predictor (Seznec and Michaud, "A case for
+ * (partially) TAgged GEometric history length branch prediction")
+ * with a loop predictor and a statistical corrector, in the spirit of
+ * L-TAGE and TAGE-SC-L. A bimodal table is backed by tagged tables
+ * indexed with global histories of geometrically increasing length;
+ * the longest matching table provides the prediction. The corrector
+ * may then revert predictions that TAGE is statistically bad at, and
+ * a loop predictor takes over for loops with a constant trip count.
+ *
+ * The global and path histories (and the loop iteration counts) are
+ * updated speculatively and restored from the BPHistory on a squash;
+ * the tables are updated when branches commit or mispredict. Tables
+ * are packed bit arrays.
+ */
+class TageBP
+{
+  public:
+    /** Most tagged tables there can be. */
+    static const unsigned MaxTables = 15;
+
+    /**
+     * Default branch predictor constructor.
+     * @param numTables Number of tagged tables.
+     * @param tableBits log2 of the number of entries per tagged table.
+     * @param tagBits Bits of the tags.
+     * @param minHist History length of the first tagged table.
+     * @param maxHist History length of the last tagged table.
+     * @param bimodalSize Entries of the base predictor.
+     * @param loopSize Entries of the loop predictor, 0 for none.
+     * @param scSize Entries per corrector table, 0 for no corrector.
+     */
+    TageBP(unsigned numTables,
+           unsigned tableBits,
+           unsigned tagBits,
+           unsigned minHist,
+           unsigned maxHist,
+           unsigned bimodalSize,
+           unsigned loopSize,
+           unsigned scSize,
+           unsigned instShiftAmt);
+
+    /**
+     * Looks up the given address in the branch predictor and returns
+     * a true/false value as to whether it is taken.  Also creates a
+     * BPHistory object to store any state it will need on squash/update.
+     * @param branch_addr The address of the branch to look up.
+     * @param bp_history Pointer that will be set to the BPHistory object.
+     * @return Whether or not the branch is taken.
+     */
+    bool lookup(Addr branch_addr, void * &bp_history);
+
+    /**
+     * Records that there was an unconditional branch.
+     * @param bp_history Pointer that will be set to the BPHistory object.
+     */
+    void uncondBr(void * &bp_history);
+
+    /**
+     * Makes the speculative history show the branch as not taken
+     * after the BTB had no target for it.
+     * @param branch_addr The address of the branch to look up.
+     * @param bp_history Pointer to any bp history state.
+     */
+    void BTBUpdate(Addr branch_addr, void * &bp_history);
+
+    /**
+     * Updates the branch predictor with the actual result of a branch.
+     * @param branch_addr The address of the branch to update.
+     * @param taken Whether or not the branch was taken.
+     * @param bp_history Pointer to the BPHistory object that was created
+     * when the branch was predicted.
+     * @param squashed is set when this function is called during a squash
+     * operation.
+     */
+    void update(Addr branch_addr, bool taken, void *bp_history,
+                bool squashed);
+
+    /**
+     * Restores the speculative state on a squash.
+     * @param bp_history Pointer to the BPHistory object of the branch.
+     */
+    void squash(void *bp_history);
+
+  private:
+    /** Sizes of the fields of a tagged entry; the tag is on top. */
+    static const unsigned CtrBits = 3;
+    static const unsigned UBits = 2;
+
+    /** Corrector tables and their history lengths. */
+    static const unsigned SCTables = 4;
+    static const unsigned SCCtrBits = 6;
+    static const unsigned SCHistLength[SCTables];
+
+    /**
+     * Limit of the counter that tunes the corrector's threshold, as in
+     * O-GEHL: mispredictions move it up, correct predictions that the
+     * corrector was not confident about move it down.
+     */
+    static const int ThresholdCtrMax = 63;
+
+    /** Path history length. */
+    static const unsigned PathBits = 16;
+
+    /** Loop predictor geometry and field limits. */
+    static const unsigned LoopWays = 4;
+    static const unsigned LoopTagBits = 14;
+    static const unsigned LoopIterBits = 14;
+    static const unsigned LoopMaxConf = 3;
+    static const unsigned LoopMaxAge = 255;
+
+    struct LoopEntry
+    {
+        uint16_t tag;
+        uint16_t numIter;
+        uint16_t currentIter;
+        uint16_t currentIterSpec;
+        uint8_t conf;
+        uint8_t age;
+    };
+
+    /**
+     * The branch history information that is created upon predicting
+     * a branch.  It will be passed back upon updating and squashing,
+     * when the BP can use this information to update/restore its
+     * state properly.
+     */
+    struct BPHistory
+    {
+        GlobalHistory::Checkpoint hist;
+        unsigned pathHist;
+
+        bool uncond;
+        bool btbMiss;
+
+        unsigned bimodalIdx;
+        unsigned index[MaxTables + 1];
+        unsigned tag[MaxTables + 1];
+        unsigned hitBank;
+        unsigned altBank;
+        bool tagePred;
+        bool altPred;
+        bool longestPred;
+        bool pred;
+
+        int loopIdx;
+        unsigned loopIterSpec;
+        bool loopValid;
+        bool loopPred;
+
+        unsigned scIdx[SCTables];
+        int scSum;
+        bool scPred;
+    };
+
+    /** Bit of the branch address that goes into the path history. */
+    unsigned pathBit(Addr branch_addr)
+    { return (branch_addr >> instShiftAmt) & 1; }
+
+    /** Mixes the path history into a table index (Seznec's F). */
+    unsigned pathHash(unsigned path, unsigned size, unsigned bank);
+
+    unsigned gindex(Addr branch_addr, unsigned bank, unsigned path);
+    unsigned gtag(Addr branch_addr, unsigned bank);
+
+    unsigned ctr(unsigned bank, unsigned idx)
+    { return tables[bank].get(idx) & ((1 << CtrBits) - 1); }
+    unsigned useful(unsigned bank, unsigned idx)
+    { return (tables[bank].get(idx) >> CtrBits) & ((1 << UBits) - 1); }
+    unsigned entryTag(unsigned bank, unsigned idx)
+    { return tables[bank].get(idx) >> (CtrBits + UBits); }
+    void setEntry(unsigned bank, unsigned idx, unsigned tag,
+                  unsigned u, unsigned ctr)
+    {
+        tables[bank].set(idx, (tag << (CtrBits + UBits)) |
+                         (u << CtrBits) | ctr);
+    }
+
+    /** Trains the bimodal and tagged tables on the outcome. */
+    void tageUpdate(bool taken, BPHistory *history);
+
+    /** Moves a tagged entry's counter towards the outcome. */
+    void ctrUpdate(unsigned bank, unsigned idx, bool taken);
+    void usefulUpdate(unsigned bank, unsigned idx, bool up);
+
+    /** Pushes an outcome onto the speculative histories. */
+    void pushHistory(BPHistory *history, Addr branch_addr, bool taken);
+
+    /** Loop predictor lookup; sets the loop fields of the history. */
+    void loopLookup(Addr branch_addr, BPHistory *history);
+    unsigned loopTag(Addr branch_addr);
+    void loopSpecUpdate(BPHistory *history, bool taken);
+    void loopUpdate(Addr branch_addr, bool taken, BPHistory *history);
+
+    void scLookup(Addr branch_addr, BPHistory *history);
+    void scUpdate(bool taken, BPHistory *history);
+
+    /** Tagged tables, 1 to numTables; 0 is unused. */
+    std::vector<PackedArray> tables;
+
+    /** The base predictor's 2-bit counters. */
+    PackedArray bimodal;
+
+    unsigned numTables;
+    unsigned tableBits;
+    unsigned tagBits;
+    unsigned bimodalSize;
+    unsigned instShiftAmt;
+
+    /** History length of each table. */
+    std::vector<unsigned> histLength;
+
+    /** Fold numbers of each table's index and tag histories. */
+    std::vector<unsigned> indexFold;
+    std::vector<unsigned> tagFold;
+    std::vector<unsigned> tagFold2;
+
+    GlobalHistory ghist;
+    unsigned pathHist;
+
+    /** Use the alternate prediction for newly allocated entries? */
+    int useAltOnNA;
+
+    /** Updates since the useful bits were last aged. */
+    uint64_t tick;
+
+    /** Pseudo-random state for picking entries to allocate. */
+    uint32_t seed;
+    uint32_t nextRandom();
+
+    std::vector<LoopEntry> loops;
+    unsigned loopSize;
+    /** Is the loop predictor better than TAGE? (7-bit, >= 0) */
+    int loopUseCtr;
+
+    std::vector<PackedArray> scTables;
+    unsigned scSize;
+    unsigned scFold[SCTables];
+    int scThreshold;
+    int scThresholdCtr;
+};
+
+#endif // __CPU_PRED_TAGE_HH__
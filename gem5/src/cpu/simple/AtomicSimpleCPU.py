@@ -47,3 +47,16 @@ class AtomicSimpleCPU(BaseSimpleCPU):
     simulate_data_stalls = Param.Bool(False, "Simulate dcache stall cycles")
     simulate_inst_stalls = Param.Bool(False, "Simulate icache stall cycles")
     fastmem = Param.Bool(False, "Access memory directly")
+    block_cache = Param.Bool(False, "Cache decoded straight-line code; " \
+        "only the first instruction of a block is fetched, and only " \
+        "writes by this CPU drop stale code, so it needs a single CPU " \
+        "in syscall-emulation mode and fixed-length instructions")
+    quantum = Param.Unsigned(0, "Instructions to execute per tick event; " \
+        "other events due meanwhile are serviced at the end of the " \
+        "quantum (0 executes one cycle per event)")
+    parallel = Param.Bool(False, "Run on a host thread of its own, a " \
+        "quantum at a time, alongside the other parallel CPUs; needs " \
+        "full-system mode, fastmem and a quantum, and memory is only " \
+        "loosely coherent between the CPUs, so use it to fast-forward; " \
+        "on Alpha, ARM and MIPS all stores take a shared lock to check " \
+        "the load-locked reservations, so only loads scale")
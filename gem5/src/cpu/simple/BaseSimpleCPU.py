@@ -35,6 +35,11 @@ class BaseSimpleCPU(BaseCPU):
     type = 'BaseSimpleCPU'
     abstract = True
 
+    bbv_interval = Param.Counter(0, "Instructions per basic-block vector "
+                                 "(0 to not collect them)")
+    bbv_file = Param.String("simpoint.bb", "Basic-block vector file, "
+                            "after the CPU name")
+
     def addCheckerCpu(self):
         if buildEnv['TARGET_ISA'] in ['arm']:
             from ArmTLB import ArmTLB
@@ -40,6 +40,8 @@
  * Authors: Steve Reinhardt
  */
 
+#include <algorithm>
+
 #include "arch/locked_mem.hh"
 #include "arch/mmapped_ipr.hh"
 #include "arch/utility.hh"
@@ -60,6 +62,44 @@
 using namespace std;
 using namespace TheISA;
 
+// The TLBs of these ISAs walk the page tables through the memory
+// system, so CPUs running in parallel translate under the group lock
+#if THE_ISA == ARM_ISA || THE_ISA == X86_ISA
+static const bool walksThroughMemory = true;
+#else
+static const bool walksThroughMemory = false;
+#endif
+
+// The load-locked reservations of these ISAs are kept by the memory,
+// and every store has to check them, so CPUs running in parallel
+// store under the group lock. This serialises all the stores of the
+// group, which for store-heavy code costs most of the parallel
+// speedup; only loads and instruction fetches still run in parallel.
+#if THE_ISA == ALPHA_ISA || THE_ISA == ARM_ISA || THE_ISA == MIPS_ISA
+static const bool storesCheckReservations = true;
+#else
+static const bool storesCheckReservations = false;
+#endif
+
+// Decoded blocks are stepped through sizeof(MachInst) at a time, so
+// the block cache only works for fixed-length instructions
+#if THE_ISA == X86_ISA
+static const bool variableInstSize = true;
+#else
+static const bool variableInstSize = false;
+#endif
+
+static inline bool
+fixedInstSize(const TheISA::PCState &pc)
+{
+#if THE_ISA == ARM_ISA
+    // Thumb instructions are 2 or 4 bytes long
+    return !pc.thumb();
+#else
+    return !variableInstSize;
+#endif
+}
+
 AtomicSimpleCPU::TickEvent::TickEvent(AtomicSimpleCPU *c)
     : Event(CPU_Tick_Pri), cpu(c)
 {
@@ -101,15 +141,57 @@ AtomicSimpleCPU::init()
     data_write_req.setThreadContext(_cpuId, 0); // Add thread ID here too
 }
 
+void
+AtomicSimpleCPU::startup()
+{
+    BaseSimpleCPU::startup();
+
+    // All the CPUs have registered their contexts by now. The block
+    // cache doesn't see the stores of the others.
+    if (blockCache && system->numContexts() > 1)
+        fatal("%s: block_cache doesn't see the writes of other CPUs to "
+              "code and can only be used with a single CPU\n", name());
+}
+
 AtomicSimpleCPU::AtomicSimpleCPU(AtomicSimpleCPUParams *p)
     : BaseSimpleCPU(p), tickEvent(this), width(p->width), locked(false),
       simulate_data_stalls(p->simulate_data_stalls),
       simulate_inst_stalls(p->simulate_inst_stalls),
       icachePort(name() + ".icache_port", this),
       dcachePort(name() + ".dcache_port", this),
-      fastmem(p->fastmem)
+      fastmem(p->fastmem), quantum(p->quantum), deviceAccessed(false),
+      parallelGroup(NULL), parallelPhase(false), nextSysInstEvent(MaxTick),
+      blockCache(NULL), curBlock(NULL),
+      curBlockIdx(0), curBlockGen(0), recBlockPaddr(0)
 {
     _status = Idle;
+
+    if (p->parallel) {
+        // Devices, caches and buses are not thread safe, and neither
+        // are the page allocation and system calls of SE mode
+        if (!FullSystem)
+            fatal("%s: parallel CPUs need full-system mode\n", name());
+        if (!fastmem)
+            fatal("%s: parallel CPUs need fastmem\n", name());
+        if (!quantum)
+            fatal("%s: parallel CPUs need a quantum\n", name());
+        parallelGroup = ParallelAtomicGroup::group();
+        parallelGroup->add(this);
+    }
+
+    if (p->block_cache) {
+        if (simulate_inst_stalls)
+            fatal("%s: block_cache skips instruction fetches and can't be "
+                  "used with simulate_inst_stalls\n", name());
+        if (variableInstSize)
+            fatal("%s: block_cache needs fixed-length instructions\n",
+                  name());
+        // Only the CPU's own stores drop the blocks they overwrite
+        if (FullSystem)
+            fatal("%s: block_cache doesn't see DMA writes to code and "
+                  "can't be used in full-system mode\n", name());
+        blockCache = new DecodedBlockCache;
+    }
 }
 
 
@@ -118,6 +200,7 @@ AtomicSimpleCPU::~AtomicSimpleCPU()
     if (tickEvent.scheduled()) {
         deschedule(tickEvent);
     }
+    delete blockCache;
 }
 
 void
@@ -150,6 +233,10 @@ AtomicSimpleCPU::resume()
     DPRINTF(SimpleCPU, "Resume\n");
     assert(system->getMemoryMode() == Enums::atomic);
 
+    // Memory may have been changed behind our back while drained
+    if (blockCache)
+        blockCache->flush();
+
     changeState(SimObject::Running);
     if (thread->status() == ThreadContext::Active) {
         if (!tickEvent.scheduled())
@@ -175,6 +262,9 @@ AtomicSimpleCPU::takeOverFrom(BaseCPU *oldCPU)
 
     assert(!tickEvent.scheduled());
 
+    if (blockCache)
+        blockCache->flush();
+
     // if any of this CPU's ThreadContexts are active, mark the CPU as
     // running and schedule its tick event.
     ThreadID size = threadContexts.size();
@@ -264,11 +354,21 @@ AtomicSimpleCPU::readMem(Addr addr, uint8_t * data,
 
     dcache_latency = 0;
 
+    // In parallel, a locked read-modify-write holds the group lock
+    // until its write is done
+    bool lock_rmw = parallelPhase && (flags & Request::LOCKED);
+    if (lock_rmw)
+        parallelGroup->lock();
+
     while (1) {
         req->setVirt(0, addr, size, flags, dataMasterId(), thread->pcState().instAddr());
 
         // translate to physical address
+        if (parallelPhase && walksThroughMemory)
+            parallelGroup->lock();
         Fault fault = thread->dtb->translateAtomic(req, tc, BaseTLB::Read);
+        if (parallelPhase && walksThroughMemory)
+            parallelGroup->unlock();
 
         // Now do the access.
         if (fault == NoFault && !req->getFlags().isSet(Request::NO_ACCESS)) {
@@ -277,10 +377,21 @@ AtomicSimpleCPU::readMem(Addr addr, uint8_t * data,
                                 MemCmd::ReadReq);
             pkt.dataStatic(data);
 
+            // In parallel, only plain loads from memory go ahead
+            // without the group lock
+            bool serial = parallelPhase &&
+                (req->isLLSC() || req->isMmappedIpr() ||
+                 !isMemAddr(pkt.getAddr()));
+            if (serial)
+                parallelGroup->lock();
+
+            if (req->isUncacheable() || req->isMmappedIpr())
+                deviceAccessed = true;
+
             if (req->isMmappedIpr())
                 dcache_latency += TheISA::handleIprRead(thread->getTC(), &pkt);
             else {
-                if (fastmem && system->isMemAddr(pkt.getAddr()))
+                if (fastmem && isMemAddr(pkt.getAddr()))
                     system->getPhysMem().access(&pkt);
                 else
                     dcache_latency += dcachePort.sendAtomic(&pkt);
@@ -292,10 +403,15 @@ AtomicSimpleCPU::readMem(Addr addr, uint8_t * data,
             if (req->isLLSC()) {
                 TheISA::handleLockedRead(thread, req);
             }
+
+            if (serial)
+                parallelGroup->unlock();
         }
 
         //If there's a fault, return it
         if (fault != NoFault) {
+            if (lock_rmw)
+                parallelGroup->unlock();
             if (req->isPrefetch()) {
                 return NoFault;
             } else {
@@ -356,13 +472,27 @@ AtomicSimpleCPU::writeMem(uint8_t *data, unsigned size,
         req->setVirt(0, addr, size, flags, dataMasterId(), thread->pcState().instAddr());
 
         // translate to physical address
+        if (parallelPhase && walksThroughMemory)
+            parallelGroup->lock();
         Fault fault = thread->dtb->translateAtomic(req, tc, BaseTLB::Write);
+        if (parallelPhase && walksThroughMemory)
+            parallelGroup->unlock();
 
         // Now do the access.
         if (fault == NoFault) {
             MemCmd cmd = MemCmd::WriteReq; // default
             bool do_access = true;  // flag to suppress cache access
 
+            // In parallel, only plain stores to memory go ahead without
+            // the group lock, and only if they can't clear a
+            // load-locked reservation
+            bool serial = parallelPhase &&
+                (storesCheckReservations || req->isLLSC() ||
+                 req->isSwap() || req->isMmappedIpr() ||
+                 !isMemAddr(req->getPaddr()));
+            if (serial)
+                parallelGroup->lock();
+
             if (req->isLLSC()) {
                 cmd = MemCmd::StoreCondReq;
                 do_access = TheISA::handleLockedWrite(thread, req);
@@ -378,14 +508,20 @@ AtomicSimpleCPU::writeMem(uint8_t *data, unsigned size,
                 Packet pkt = Packet(req, cmd);
                 pkt.dataStatic(data);
 
+                if (req->isUncacheable() || req->isMmappedIpr())
+                    deviceAccessed = true;
+
                 if (req->isMmappedIpr()) {
                     dcache_latency +=
                         TheISA::handleIprWrite(thread->getTC(), &pkt);
                 } else {
-                    if (fastmem && system->isMemAddr(pkt.getAddr()))
+                    if (fastmem && isMemAddr(pkt.getAddr()))
                         system->getPhysMem().access(&pkt);
                     else
                         dcache_latency += dcachePort.sendAtomic(&pkt);
+
+                    if (blockCache)
+                        blockCache->write(req->getPaddr());
                 }
                 dcache_access = true;
                 assert(!pkt.isError());
@@ -399,6 +535,9 @@ AtomicSimpleCPU::writeMem(uint8_t *data, unsigned size,
             if (res && !req->isSwap()) {
                 *res = req->getExtraData();
             }
+
+            if (serial)
+                parallelGroup->unlock();
         }
 
         //If there's a fault or we don't need to access a second cache line,
@@ -408,6 +547,8 @@ AtomicSimpleCPU::writeMem(uint8_t *data, unsigned size,
             if (req->isLocked() && fault == NoFault) {
                 assert(locked);
                 locked = false;
+                if (parallelPhase)
+                    parallelGroup->unlock();
             }
             if (fault != NoFault && req->isPrefetch()) {
                 return NoFault;
@@ -435,29 +576,123 @@ AtomicSimpleCPU::tick()
 {
     DPRINTF(SimpleCPU, "Tick\n");
 
+    if (parallelGroup) {
+        parallelGroup->tick(this);
+        return;
+    }
+
+    Tick latency = runQuantum();
+    if (_status != Idle)
+        schedule(tickEvent, curTick() + latency);
+}
+
+Tick
+AtomicSimpleCPU::runQuantum()
+{
+    Tick latency = 0;
+    Counter executed = 0;
+
+    deviceAccessed = false;
+
+    // In quantum mode keep executing cycles until the quantum is used up,
+    // leaving other events for later.  Stop early if the CPU stopped,
+    // if something was scheduled to happen now (e.g. an exit after an
+    // instruction count), or if a device was accessed, so that its
+    // events (and any interrupt it raises) are serviced before the CPU
+    // goes on.  In parallel, whatever may schedule something is done
+    // under the group lock and sets deviceAccessed, and the event
+    // queue can't be looked at without the lock.
+    do {
+        latency += executeCycle(executed);
+    } while (executed < quantum && _status == Running && !deviceAccessed &&
+             (parallelPhase || mainEventQueue.empty() ||
+              mainEventQueue.nextTick() > curTick()));
+
+    return latency;
+}
+
+void
+AtomicSimpleCPU::copySystemEvents()
+{
+    EventQueue *sys_queue = &system->instEventQueue;
+
+    system->pcEventQueue.getPCs(pcEventPCs);
+    nextSysInstEvent = sys_queue->empty() ? MaxTick : sys_queue->nextTick();
+}
+
+bool
+AtomicSimpleCPU::eventsDue()
+{
+    EventQueue *inst_queue = comInstEventQueue[0];
+
+    return binary_search(pcEventPCs.begin(), pcEventPCs.end(),
+                         thread->instAddr()) ||
+        (!inst_queue->empty() && inst_queue->nextTick() <= numInst) ||
+        nextSysInstEvent <= system->totalNumInsts;
+}
+
+bool
+AtomicSimpleCPU::isMemAddr(Addr paddr)
+{
+    // The system's lookup caches the last range it found, which the
+    // host threads of parallel CPUs would race on
+    if (parallelPhase)
+        return system->getPhysMem().isMemAddrUncached(paddr);
+    return system->isMemAddr(paddr);
+}
+
+Tick
+AtomicSimpleCPU::executeCycle(Counter &executed)
+{
     Tick latency = 0;
 
     for (int i = 0; i < width || locked; ++i) {
         numCycles++;
+        executed++;
+
+        if (!curStaticInst || !curStaticInst->isDelayedCommit()) {
+            // Other CPUs and devices post interrupts under the group
+            // lock, so one that seems pending is taken under it
+            if (!parallelPhase) {
+                checkForInterrupts();
+            } else if (checkInterrupts(tc)) {
+                parallelGroup->lock();
+                checkForInterrupts();
+                parallelGroup->unlock();
+            }
+        }
 
-        if (!curStaticInst || !curStaticInst->isDelayedCommit())
-            checkForInterrupts();
+        bool serial = parallelPhase && eventsDue();
+        if (serial)
+            parallelGroup->lock();
 
-        checkPcEventQueue();
+        if (!parallelPhase || serial)
+            checkPcEventQueue();
         // We must have just got suspended by a PC event
-        if (_status == Idle)
-            return;
+        if (_status == Idle) {
+            if (serial) {
+                parallelGroup->unlock();
+                deviceAccessed = true;
+            }
+            return 0;
+        }
 
         Fault fault = NoFault;
 
         TheISA::PCState pcState = thread->pcState();
 
-        bool needToFetch = !isRomMicroPC(pcState.microPC()) &&
+        StaticInstPtr block_inst = nextBlockInst(pcState);
+
+        bool needToFetch = !block_inst && !isRomMicroPC(pcState.microPC()) &&
                            !curMacroStaticInst;
         if (needToFetch) {
             setupFetchRequest(&ifetch_req);
+            if (parallelPhase && walksThroughMemory)
+                parallelGroup->lock();
             fault = thread->itb->translateAtomic(&ifetch_req, tc,
                                                  BaseTLB::Execute);
+            if (parallelPhase && walksThroughMemory)
+                parallelGroup->unlock();
         }
 
         if (fault == NoFault) {
@@ -477,10 +712,15 @@ AtomicSimpleCPU::tick()
                     Packet ifetch_pkt = Packet(&ifetch_req, MemCmd::ReadReq);
                     ifetch_pkt.dataStatic(&inst);
 
-                    if (fastmem && system->isMemAddr(ifetch_pkt.getAddr()))
+                    if (fastmem && isMemAddr(ifetch_pkt.getAddr())) {
                         system->getPhysMem().access(&ifetch_pkt);
-                    else
+                    } else {
+                        if (parallelPhase)
+                            parallelGroup->lock();
                         icache_latency = icachePort.sendAtomic(&ifetch_pkt);
+                        if (parallelPhase)
+                            parallelGroup->unlock();
+                    }
 
                     assert(!ifetch_pkt.isError());
 
@@ -489,9 +729,24 @@ AtomicSimpleCPU::tick()
                 //}
             }
 
-            preExecute();
+            preExecute(block_inst);
+
+            if (blockCache && needToFetch && curStaticInst)
+                recordBlockInst(pcState, ifetch_req.getPaddr());
 
             if (curStaticInst) {
+                // Instructions that may change state beyond the CPU's
+                // registers and memory are the ones that flush the
+                // block cache; a load may trigger a load count event
+                if (parallelPhase && !serial &&
+                    (DecodedBlockCache::flushesCache(curStaticInst) ||
+                     (curStaticInst->isLoad() &&
+                      !comLoadEventQueue[0]->empty() &&
+                      comLoadEventQueue[0]->nextTick() <= numLoad + 1))) {
+                    serial = true;
+                    parallelGroup->lock();
+                }
+
                 fault = curStaticInst->execute(this, traceData);
 
                 // keep an instruction count
@@ -503,6 +758,10 @@ AtomicSimpleCPU::tick()
                 }
 
                 postExecute();
+
+                if (blockCache &&
+                    DecodedBlockCache::flushesCache(curStaticInst))
+                    blockCache->flush();
             }
 
             // @todo remove me after debugging with legion done
@@ -528,16 +787,101 @@ AtomicSimpleCPU::tick()
         }
         if(fault != NoFault || !stayAtPC)
             advancePC(fault);
+
+        if (serial) {
+            parallelGroup->unlock();
+            // Whatever the events or the instruction scheduled is
+            // serviced before this CPU goes on
+            deviceAccessed = true;
+        }
     }
 
     // instruction takes at least one cycle
     if (latency < clockPeriod())
         latency = clockPeriod();
 
-    if (_status != Idle)
-        schedule(tickEvent, curTick() + latency);
+    return latency;
+}
+
+
+StaticInstPtr
+AtomicSimpleCPU::nextBlockInst(const TheISA::PCState &pc)
+{
+    if (!curBlock)
+        return NULL;
+
+    // Leave the block when something other than falling through to
+    // its next instruction happened, or the block may be stale
+    if (blockCache->generation() != curBlockGen || curMacroStaticInst ||
+        isRomMicroPC(pc.microPC()) ||
+        pc.instAddr() != curBlock->pc + curBlockIdx * sizeof(MachInst)) {
+        curBlock = NULL;
+        return NULL;
+    }
+
+    StaticInstPtr inst = curBlock->insts[curBlockIdx];
+    if (++curBlockIdx == curBlock->insts.size())
+        curBlock = NULL;
+
+    return inst;
+}
+
+void
+AtomicSimpleCPU::recordBlockInst(const TheISA::PCState &pc_state,
+                                 Addr paddr)
+{
+    if (!fixedInstSize(pc_state)) {
+        finishBlock();
+        return;
+    }
+
+    Addr pc = pc_state.instAddr();
+    const DecodedBlockCache::Block *blk =
+        blockCache->lookup(pc, paddr, curStaticInst);
+
+    if (blk) {
+        recBlock.insts.clear();
+        curBlock = blk;
+        curBlockIdx = 1;
+        curBlockGen = blockCache->generation();
+        // The decoder won't see the rest of the block
+        thread->decoder.reset();
+        return;
+    }
+
+    // Extend the block being recorded if this instruction follows its
+    // last one on the same page, otherwise start a new block here
+    Addr offset = recBlock.insts.size() * sizeof(MachInst);
+    if (pc != recBlock.pc + offset || paddr != recBlockPaddr + offset) {
+        finishBlock();
+        recBlock.pc = pc;
+        recBlockPaddr = paddr;
+    }
+
+    if (curMacroStaticInst || curStaticInst->isMicroop() ||
+        DecodedBlockCache::flushesCache(curStaticInst)) {
+        finishBlock();
+        return;
+    }
+
+    recBlock.insts.push_back(curStaticInst);
+
+    Addr next_paddr = paddr + sizeof(MachInst);
+    if (curStaticInst->isControl() ||
+        recBlock.insts.size() == DecodedBlockCache::MaxBlockInsts ||
+        (next_paddr & ~(PageBytes - 1)) != (paddr & ~(PageBytes - 1))) {
+        finishBlock();
+    }
 }
 
+void
+AtomicSimpleCPU::finishBlock()
+{
+    // A single instruction saves nothing over decoding it
+    if (recBlock.insts.size() > 1)
+        blockCache->insert(recBlockPaddr, recBlock);
+    recBlock.insts.clear();
+}
 
 void
 AtomicSimpleCPU::printAddr(Addr a)
@@ -44,6 +44,8 @@
 #define __CPU_SIMPLE_ATOMIC_HH__
 
 #include "cpu/simple/base.hh"
+#include "cpu/simple/block_cache.hh"
+#include "cpu/simple/parallel_group.hh"
 #include "params/AtomicSimpleCPU.hh"
 
 class AtomicSimpleCPU : public BaseSimpleCPU
@@ -54,9 +56,12 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     virtual ~AtomicSimpleCPU();
 
     virtual void init();
+    virtual void startup();
 
   private:
 
+    friend class ParallelAtomicGroup;
+
     struct TickEvent : public Event
     {
         AtomicSimpleCPU *cpu;
@@ -73,9 +78,23 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     const bool simulate_data_stalls;
     const bool simulate_inst_stalls;
 
-    // main simulation loop (one cycle)
+    // main simulation loop (one cycle, or a quantum of them)
     void tick();
 
+    /**
+     * Executes a quantum's worth of cycles, or one cycle if there is
+     * no quantum.
+     * @return The time the cycles took.
+     */
+    Tick runQuantum();
+
+    /**
+     * Executes one cycle's worth of instructions.
+     * @param executed Incremented for each instruction slot used.
+     * @return The length of the cycle in ticks.
+     */
+    Tick executeCycle(Counter &executed);
+
     /**
      * An AtomicCPUPort overrides the default behaviour of the
      * recvAtomic and ignores the packet instead of panicking.
@@ -110,6 +129,82 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     bool dcache_access;
     Tick dcache_latency;
 
+    /** Instructions to execute per tick event, or 0 for one cycle. */
+    const Counter quantum;
+
+    /**
+     * Set by a device or IPR access, or by anything that had to be
+     * done under the lock of the parallel group, which ends the
+     * quantum.
+     */
+    bool deviceAccessed;
+
+    /** Group of CPUs this one runs in parallel with, or NULL. */
+    ParallelAtomicGroup *parallelGroup;
+
+    /** Is the CPU running in parallel with others right now? */
+    bool parallelPhase;
+
+    /**
+     * Is an instruction or PC event due before the next instruction?
+     * Events may reach beyond the CPU, so in parallel they are only
+     * serviced under the group lock.
+     */
+    bool eventsDue();
+
+    /**
+     * Copy what eventsDue() needs to know about the system's PC and
+     * instruction event queues. Other CPUs may change the queues
+     * during a parallel quantum, so the group takes the copies before
+     * it, and events scheduled by other CPUs during the quantum are
+     * only seen from the next one.
+     */
+    void copySystemEvents();
+
+    /** PCs of the system's PC events, in ascending order. */
+    std::vector<Addr> pcEventPCs;
+
+    /** Instruction count of the system's next instruction event. */
+    Tick nextSysInstEvent;
+
+    /** Is the physical address in memory? Safe to use in parallel. */
+    bool isMemAddr(Addr paddr);
+
+    /** Decoded straight-line code, or NULL if the cache is disabled. */
+    DecodedBlockCache *blockCache;
+
+    /** Block being executed, or NULL if none. */
+    const DecodedBlockCache::Block *curBlock;
+
+    /** Index of the next instruction to take from curBlock. */
+    unsigned curBlockIdx;
+
+    /** Block cache generation curBlock was found in. */
+    uint64_t curBlockGen;
+
+    /** Block being recorded from freshly decoded instructions. */
+    DecodedBlockCache::Block recBlock;
+
+    /** Physical address of the first instruction in recBlock. */
+    Addr recBlockPaddr;
+
+    /**
+     * Returns the next instruction of the current block if the thread
+     * is about to execute it, or NULL if the instruction must be
+     * fetched and decoded.
+     */
+    StaticInstPtr nextBlockInst(const TheISA::PCState &pc);
+
+    /**
+     * Follows a cached block starting at a freshly decoded instruction,
+     * or adds the instruction to the block being recorded. Variable
+     * length instructions (e.g. Thumb) are neither cached nor looked up.
+     */
+    void recordBlockInst(const TheISA::PCState &pc_state, Addr paddr);
+
+    /** Adds the block being recorded to the cache and starts anew. */
+    void finishBlock();
+
   protected:
 
     /** Return a reference to the data port. */
@@ -46,6 +46,7 @@
 #include "arch/utility.hh"
 #include "arch/vtophys.hh"
 #include "base/loader/symtab.hh"
+#include "base/callback.hh"
 #include "base/cp_annotate.hh"
 #include "base/cprintf.hh"
 #include "base/inifile.hh"
@@ -76,6 +77,7 @@
 #include "sim/faults.hh"
 #include "sim/full_system.hh"
 #include "sim/sim_events.hh"
+#include "sim/sim_exit.hh"
 #include "sim/sim_object.hh"
 #include "sim/stats.hh"
 #include "sim/system.hh"
@@ -121,10 +123,19 @@ BaseSimpleCPU::BaseSimpleCPU(BaseSimpleCPUParams *p)
 
     fetchOffset = 0;
     stayAtPC = false;
+
+    bbvProfiler = NULL;
+    if (p->bbv_interval) {
+        bbvProfiler = new BBVProfiler(p->bbv_interval,
+                                      csprintf("%s.%s", name(), p->bbv_file));
+        registerExitCallback(
+            new MakeCallback<BBVProfiler, &BBVProfiler::flush>(bbvProfiler));
+    }
 }
 
 BaseSimpleCPU::~BaseSimpleCPU()
 {
+    delete bbvProfiler;
 }
 
 void
@@ -352,7 +363,7 @@ BaseSimpleCPU::setupFetchRequest(Request *req)
 
 
 void
-BaseSimpleCPU::preExecute()
+BaseSimpleCPU::preExecute(const StaticInstPtr &decoded)
 {
     // maintain $r0 semantics
     thread->setIntReg(ZeroReg, 0);
@@ -364,12 +375,13 @@ BaseSimpleCPU::preExecute()
     comInstEventQueue[0]->serviceEvents(numInst);
     system->instEventQueue.serviceEvents(system->totalNumInsts);
 
-    // decode the instruction
-    inst = gtoh(inst);
-
     TheISA::PCState pcState = thread->pcState();
 
-    if (isRomMicroPC(pcState.microPC())) {
+    if (decoded) {
+        // The caller skipped the fetch, so there is nothing to decode
+        stayAtPC = false;
+        curStaticInst = decoded;
+    } else if (isRomMicroPC(pcState.microPC())) {
         stayAtPC = false;
         curStaticInst = microcodeRom.fetchMicroop(pcState.microPC(),
                                                   curMacroStaticInst);
@@ -377,6 +389,9 @@ BaseSimpleCPU::preExecute()
         //We're not in the middle of a macro instruction
         StaticInstPtr instPtr = NULL;
 
+        // decode the instruction
+        inst = gtoh(inst);
+
         TheISA::Decoder *decoder = &(thread->decoder);
 
         //Predecode, ie bundle up an ExtMachInst
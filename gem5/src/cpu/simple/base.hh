@@ -50,6 +50,7 @@
 #include "cpu/base.hh"
 #include "cpu/checker/cpu.hh"
 #include "cpu/pc_event.hh"
+#include "cpu/simple/bbv_profiler.hh"
 #include "cpu/simple_thread.hh"
 #include "cpu/static_inst.hh"
 #include "mem/packet.hh"
@@ -162,7 +163,11 @@ class BaseSimpleCPU : public BaseCPU
 
     void checkForInterrupts();
     void setupFetchRequest(Request *req);
-    void preExecute();
+    /**
+     * Sets up the next instruction for execution, decoding it from
+     * the fetched bytes unless the caller already has it decoded.
+     */
+    void preExecute(const StaticInstPtr &decoded = StaticInstPtr());
     void postExecute();
     void advancePC(Fault fault);
 
@@ -181,11 +186,17 @@ class BaseSimpleCPU : public BaseCPU
     Counter startNumOp;
     Stats::Scalar numOps;
 
+    /** Basic-block vector collector, NULL unless enabled. */
+    BBVProfiler *bbvProfiler;
+
     void countInst()
     {
         if (!curStaticInst->isMicroop() || curStaticInst->isLastMicroop()) {
             numInst++;
             numInsts++;
+            if (bbvProfiler)
+                bbvProfiler->commit(thread->instAddr(),
+                                    curStaticInst->isControl());
         }
         numOp++;
         numOps++;
@@ -204,6 +215,11 @@ class BaseSimpleCPU : public BaseCPU
         return numOp - startNumOp;
     }
 
+    virtual Counter getCurrentInstCount(ThreadID tid)
+    {
+        return numInst;
+    }
+
     //number of integer alu accesses
     Stats::Scalar numIntAluAccesses;
 
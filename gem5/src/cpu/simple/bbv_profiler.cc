@@ -0,0 +1,153 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <ostream>
+
+#include "base/misc.hh"
+#include "base/output.hh"
+#include "cpu/simple/bbv_profiler.hh"
+
+BBVProfiler::BBVProfiler(Counter _interval, const std::string &filename)
+    : interval(_interval), blockStart(0), blockInsts(0),
+      blocks(1024), mask(1023), numBlocks(0), intervalInsts(0)
+{
+    if (interval <= 0)
+        fatal("Invalid basic-block vector interval!\n");
+
+    buffer.reserve(BufferSize + 256);
+    stream = simout.create(filename);
+}
+
+void
+BBVProfiler::endBlock()
+{
+    uint32_t slot = lookup(blockStart);
+    Block &block = blocks[slot];
+    if (!block.count)
+        touched.push_back(slot);
+    block.count += blockInsts;
+
+    intervalInsts += blockInsts;
+    blockInsts = 0;
+
+    if (intervalInsts >= interval)
+        endInterval();
+}
+
+uint32_t
+BBVProfiler::lookup(Addr pc)
+{
+    // Fibonacci hashing spreads the aligned PCs over the table
+    uint32_t slot = (uint32_t)((pc * ULL(0x9E3779B97F4A7C15)) >> 32) & mask;
+    while (blocks[slot].id) {
+        if (blocks[slot].pc == pc)
+            return slot;
+        slot = (slot + 1) & mask;
+    }
+
+    // Keep the table at most half full
+    if (2 * (numBlocks + 1) > blocks.size()) {
+        grow();
+        return lookup(pc);
+    }
+
+    blocks[slot].pc = pc;
+    blocks[slot].id = ++numBlocks;
+    blocks[slot].count = 0;
+    return slot;
+}
+
+void
+BBVProfiler::grow()
+{
+    std::vector<Block> old(2 * blocks.size());
+    old.swap(blocks);
+    mask = blocks.size() - 1;
+
+    // Block counts move with the blocks, so the touched list has to
+    // be rebuilt
+    touched.clear();
+    for (size_t i = 0; i < old.size(); i++) {
+        if (!old[i].id)
+            continue;
+        uint32_t slot =
+            (uint32_t)((old[i].pc * ULL(0x9E3779B97F4A7C15)) >> 32) & mask;
+        while (blocks[slot].id)
+            slot = (slot + 1) & mask;
+        blocks[slot] = old[i];
+        if (blocks[slot].count)
+            touched.push_back(slot);
+    }
+}
+
+void
+BBVProfiler::append(uint64_t val)
+{
+    char digits[20];
+    int n = 0;
+    do {
+        digits[n++] = '0' + val % 10;
+        val /= 10;
+    } while (val);
+    while (n)
+        buffer += digits[--n];
+}
+
+void
+BBVProfiler::endInterval()
+{
+    buffer += 'T';
+    for (size_t i = 0; i < touched.size(); i++) {
+        Block &block = blocks[touched[i]];
+        buffer += ':';
+        append(block.id);
+        buffer += ':';
+        append(block.count);
+        buffer += ' ';
+        block.count = 0;
+    }
+    buffer += '\n';
+
+    touched.clear();
+    intervalInsts = 0;
+
+    if (buffer.size() >= BufferSize) {
+        stream->write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+}
+
+void
+BBVProfiler::flush()
+{
+    if (blockInsts)
+        endBlock();
+    if (intervalInsts)
+        endInterval();
+
+    stream->write(buffer.data(), buffer.size());
+    stream->flush();
+    buffer.clear();
+}
@@ -0,0 +1,127 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_SIMPLE_BBV_PROFILER_HH__
+#define __CPU_SIMPLE_BBV_PROFILER_HH__
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "base/types.hh"
+
+/**
+ * Collects basic-block vectors (BBVs) in the format the SimPoint tool
+ * reads. A basic block starts at the first instruction committed after
+ * a control instruction and is identified by its entry PC. For every
+ * interval of the given number of instructions, one line lists the
+ * instructions each block that ran in it contributed:
+ *
+ *   T:<block id>:<instructions> :<block id>:<instructions> ...
+ *
+ * Block ids are numbered from 1 in order of first appearance. As in
+ * Valgrind's exp-bbv, an interval ends at the first block boundary
+ * after it is full.
+ *
+ * The blocks are kept in an open-addressed hash table keyed by the
+ * entry PC, and the blocks touched in the current interval are listed
+ * separately, so writing the sparse vector does not scan the table.
+ * The lines are formatted into a buffer that goes to the file in large
+ * chunks.
+ */
+class BBVProfiler
+{
+  public:
+    /**
+     * @param interval Instructions per vector.
+     * @param filename File in the output directory to write to.
+     */
+    BBVProfiler(Counter interval, const std::string &filename);
+
+    /**
+     * Count a committed instruction.
+     * @param pc Address of the instruction.
+     * @param control Whether it may change the control flow.
+     */
+    void
+    commit(Addr pc, bool control)
+    {
+        if (!blockInsts)
+            blockStart = pc;
+        blockInsts++;
+        if (control)
+            endBlock();
+    }
+
+    /** Write out the partial interval and any buffered output; this
+     *  is done at exit. */
+    void flush();
+
+  private:
+    struct Block
+    {
+        /** Entry PC; only valid if id is not 0. */
+        Addr pc;
+        /** SimPoint block id, 0 for an empty slot. */
+        uint32_t id;
+        /** Instructions in the current interval. */
+        uint32_t count;
+    };
+
+    /** Output is written when the buffer grows past this. */
+    static const size_t BufferSize = 64 * 1024;
+
+    /** Add the finished block to the current interval. */
+    void endBlock();
+
+    /** Find the slot of a block, allocating one if it is new. */
+    uint32_t lookup(Addr pc);
+
+    /** Double the size of the table. */
+    void grow();
+
+    /** Format the vector of the current interval and clear it. */
+    void endInterval();
+
+    void append(uint64_t val);
+
+    Counter interval;
+
+    Addr blockStart;
+    uint32_t blockInsts;
+
+    std::vector<Block> blocks;
+    uint32_t mask;
+    uint32_t numBlocks;
+
+    /** Slots of the blocks that ran in the current interval. */
+    std::vector<uint32_t> touched;
+    Counter intervalInsts;
+
+    std::string buffer;
+    std::ostream *stream;
+};
+
+#endif // __CPU_SIMPLE_BBV_PROFILER_HH__
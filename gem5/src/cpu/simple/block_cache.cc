@@ -0,0 +1,96 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/simple/block_cache.hh"
+
+DecodedBlockCache::DecodedBlockCache()
+    : lastDataPage(1), epoch(0), gen(0)
+{
+}
+
+const DecodedBlockCache::Block *
+DecodedBlockCache::lookup(Addr pc, Addr paddr, const StaticInstPtr &first)
+{
+    BlockMap::iterator it = blocks.find(paddr);
+    if (it == blocks.end())
+        return NULL;
+
+    const Block &blk = it->second;
+    if (blk.epoch != epoch || blk.pc != pc || blk.insts[0] != first)
+        return NULL;
+
+    return &blk;
+}
+
+void
+DecodedBlockCache::insert(Addr paddr, Block &blk)
+{
+    assert(!blk.insts.empty());
+
+    // Blocks from earlier epochs are only dropped when they are
+    // replaced, so bound the footprint by starting over
+    if (blocks.size() >= MaxBlocks) {
+        blocks.clear();
+        codePages.clear();
+        lastDataPage = 1;
+        ++gen;
+    }
+
+    std::pair<BlockMap::iterator, bool> res =
+        blocks.insert(BlockMap::value_type(paddr, Block()));
+    Block &entry = res.first->second;
+
+    if (res.second) {
+        Addr page = paddr & ~(TheISA::PageBytes - 1);
+        codePages[page].push_back(paddr);
+        if (page == lastDataPage)
+            lastDataPage = 1;
+    } else {
+        // A stale block may still be in use
+        ++gen;
+    }
+
+    entry.pc = blk.pc;
+    entry.epoch = epoch;
+    entry.insts.swap(blk.insts);
+}
+
+void
+DecodedBlockCache::invalidatePage(Addr page)
+{
+    PageMap::iterator it = codePages.find(page);
+    if (it == codePages.end()) {
+        lastDataPage = page;
+        return;
+    }
+
+    const std::vector<Addr> &starts = it->second;
+    for (int i = 0; i < starts.size(); ++i)
+        blocks.erase(starts[i]);
+
+    codePages.erase(it);
+    lastDataPage = page;
+    ++gen;
+}
@@ -0,0 +1,144 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_SIMPLE_BLOCK_CACHE_HH__
+#define __CPU_SIMPLE_BLOCK_CACHE_HH__
+
+#include <vector>
+
+#include "arch/isa_traits.hh"
+#include "base/hashmap.hh"
+#include "base/types.hh"
+#include "config/the_isa.hh"
+#include "cpu/static_inst.hh"
+
+/**
+ * A cache of decoded straight-line code.  A block is a run of
+ * instructions at consecutive addresses within one physical page
+ * that ends at the first instruction that may change the flow of
+ * control or the translation state.  Blocks are found by the
+ * physical address of their first instruction, and the pages that
+ * hold blocks are tracked so that a write to one of them drops its
+ * blocks.  Only the writes of the CPU that owns the cache are seen,
+ * so it can't be used with other CPUs or DMA devices that may write
+ * code, and instructions must all be sizeof(MachInst) long.
+ */
+class DecodedBlockCache
+{
+  public:
+    /** Longest block that is recorded. */
+    static const unsigned MaxBlockInsts = 64;
+
+    /** Number of blocks at which the cache is emptied. */
+    static const unsigned MaxBlocks = 1 << 16;
+
+    struct Block
+    {
+        /** Virtual address of the first instruction. */
+        Addr pc;
+
+        /** Flush epoch the block was recorded in. */
+        uint64_t epoch;
+
+        /** The decoded instructions, in address order. */
+        std::vector<StaticInstPtr> insts;
+    };
+
+    DecodedBlockCache();
+
+    /**
+     * Find the block starting at a physical address.  The block must
+     * have been recorded at the same virtual address and start with
+     * the same decoded instruction, which catches a change of mode
+     * that would decode the same bytes differently.
+     */
+    const Block *lookup(Addr pc, Addr paddr, const StaticInstPtr &first);
+
+    /**
+     * Add a block starting at a physical address, replacing any
+     * block already there.  The instructions are taken from blk.
+     */
+    void insert(Addr paddr, Block &blk);
+
+    /** Note a write to a physical address, dropping any code on it. */
+    void
+    write(Addr paddr)
+    {
+        Addr page = paddr & ~(TheISA::PageBytes - 1);
+        if (page != lastDataPage)
+            invalidatePage(page);
+    }
+
+    /** Drop all blocks. */
+    void
+    flush()
+    {
+        ++epoch;
+        ++gen;
+    }
+
+    /**
+     * Count of changes that may have dropped a block.  A user holding
+     * on to a block must stop using it when this changes.
+     */
+    uint64_t generation() const { return gen; }
+
+    /**
+     * Does the instruction possibly remap or rewrite code in a way
+     * the cache can't see, e.g. a syscall reading into a code page?
+     * These are never cached and flush the cache when executed.
+     */
+    static bool
+    flushesCache(const StaticInstPtr &inst)
+    {
+        return inst->isSerializing() || inst->isNonSpeculative() ||
+            inst->isIprAccess() || inst->isSyscall() || inst->isQuiesce();
+    }
+
+  private:
+    void invalidatePage(Addr page);
+
+    typedef m5::hash_map<Addr, Block> BlockMap;
+
+    /** Blocks by the physical address of their first instruction. */
+    BlockMap blocks;
+
+    typedef m5::hash_map<Addr, std::vector<Addr> > PageMap;
+
+    /** Start addresses of the blocks on each physical page. */
+    PageMap codePages;
+
+    /** The last page written that was found to hold no blocks, or 1,
+     *  which is no page address, if there is none.
+     */
+    Addr lastDataPage;
+
+    /** Blocks recorded in an earlier epoch have been flushed. */
+    uint64_t epoch;
+
+    uint64_t gen;
+};
+
+#endif // __CPU_SIMPLE_BLOCK_CACHE_HH__
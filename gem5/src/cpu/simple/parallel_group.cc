@@ -0,0 +1,180 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/callback.hh"
+#include "base/misc.hh"
+#include "cpu/simple/atomic.hh"
+#include "cpu/simple/parallel_group.hh"
+#include "sim/core.hh"
+
+ParallelAtomicGroup::ParallelAtomicGroup()
+    : quantumStart(NULL), quantumEnd(NULL), stopping(false)
+{
+    // A CPU that holds the lock for a locked read-modify-write may
+    // need it again for the accesses in between
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+ParallelAtomicGroup *
+ParallelAtomicGroup::group()
+{
+    static ParallelAtomicGroup *the_group = NULL;
+    if (the_group == NULL)
+        the_group = new ParallelAtomicGroup;
+    return the_group;
+}
+
+void
+ParallelAtomicGroup::add(AtomicSimpleCPU *cpu)
+{
+    assert(quantumStart == NULL);
+    cpus.push_back(cpu);
+    active.push_back(false);
+    latency.push_back(0);
+}
+
+void
+ParallelAtomicGroup::startThreads()
+{
+    // This thread is the first of the CPU threads
+    int num_threads = cpus.size();
+    quantumStart = new Barrier(num_threads);
+    quantumEnd = new Barrier(num_threads);
+    threads.resize(num_threads - 1);
+    threadArgs.resize(num_threads - 1);
+    for (int t = 0; t < num_threads - 1; t++) {
+        threadArgs[t].group = this;
+        threadArgs[t].idx = t + 1;
+        if (pthread_create(&threads[t], NULL, threadMain,
+                           &threadArgs[t]) != 0)
+            fatal("Could not create parallel CPU thread\n");
+    }
+
+    registerExitCallback(
+        new MakeCallback<ParallelAtomicGroup,
+                         &ParallelAtomicGroup::stopThreads>(this));
+}
+
+void
+ParallelAtomicGroup::stopThreads()
+{
+    if (quantumStart == NULL)
+        return;
+
+    stopping = true;
+    quantumStart->wait();
+    for (int t = 0; t < threads.size(); t++)
+        pthread_join(threads[t], NULL);
+    threads.clear();
+
+    delete quantumStart;
+    delete quantumEnd;
+    quantumStart = NULL;
+    quantumEnd = NULL;
+}
+
+void *
+ParallelAtomicGroup::threadMain(void *arg)
+{
+    CPUThread *thread = (CPUThread *)arg;
+    ParallelAtomicGroup *group = thread->group;
+
+    while (true) {
+        group->quantumStart->wait();
+        if (group->stopping)
+            return NULL;
+        group->runCPU(thread->idx);
+        group->quantumEnd->wait();
+    }
+}
+
+void
+ParallelAtomicGroup::runCPU(int idx)
+{
+    if (active[idx])
+        latency[idx] = cpus[idx]->runQuantum();
+}
+
+/*
+ * The CPUs that join the quantum start it now even if their ticks
+ * were a little later, and the ones that were not due stay where
+ * they are, so CPUs whose quanta take different times keep roughly
+ * in step. Nothing but the CPUs runs while they are in parallel: the
+ * event queue is only touched under the lock, and the events that
+ * were scheduled meanwhile are serviced after the quantum.
+ */
+void
+ParallelAtomicGroup::tick(AtomicSimpleCPU *cpu)
+{
+    if (quantumStart == NULL && cpus.size() > 1)
+        startThreads();
+
+    int num_active = 0;
+    for (int i = 0; i < cpus.size(); i++) {
+        AtomicSimpleCPU *c = cpus[i];
+        active[i] = c == cpu ||
+            (c->_status == BaseSimpleCPU::Running &&
+             c->tickEvent.scheduled() &&
+             c->tickEvent.when() <=
+             curTick() + c->quantum * c->clockPeriod());
+
+        if (active[i]) {
+            if (c != cpu)
+                c->deschedule(c->tickEvent);
+            num_active++;
+        }
+    }
+
+    if (num_active > 1) {
+        for (int i = 0; i < cpus.size(); i++) {
+            cpus[i]->parallelPhase = active[i];
+            if (active[i])
+                cpus[i]->copySystemEvents();
+        }
+
+        quantumStart->wait();
+        runCPU(0);
+        quantumEnd->wait();
+
+        for (int i = 0; i < cpus.size(); i++)
+            cpus[i]->parallelPhase = false;
+    } else {
+        for (int i = 0; i < cpus.size(); i++)
+            runCPU(i);
+    }
+
+    // A CPU that was suspended and woken up again during the quantum
+    // already has its tick scheduled
+    for (int i = 0; i < cpus.size(); i++) {
+        AtomicSimpleCPU *c = cpus[i];
+        if (active[i] && c->_status != BaseSimpleCPU::Idle &&
+            !c->tickEvent.scheduled())
+            c->schedule(c->tickEvent, curTick() + latency[i]);
+    }
+}
@@ -0,0 +1,103 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_SIMPLE_PARALLEL_GROUP_HH__
+#define __CPU_SIMPLE_PARALLEL_GROUP_HH__
+
+#include <pthread.h>
+
+#include <vector>
+
+#include "base/barrier.hh"
+#include "base/types.hh"
+
+class AtomicSimpleCPU;
+
+/**
+ * The atomic CPUs that run in parallel, each on a host thread of its
+ * own. Whenever the tick of one of them comes up, every CPU whose
+ * tick is due within a quantum of it runs its quantum at the same
+ * time, and the CPUs then wait for each other before the event queue
+ * goes on. Only accesses to memory proceed freely; anything that
+ * reaches beyond a CPU and its memory (devices, interrupts, locked
+ * accesses, instruction and PC events) is done under a lock that the
+ * group holds for all of them.
+ */
+class ParallelAtomicGroup
+{
+  private:
+    struct CPUThread
+    {
+        ParallelAtomicGroup *group;
+        int idx;
+    };
+
+    /** The CPUs of the group, each of which runs on thread idx. */
+    std::vector<AtomicSimpleCPU *> cpus;
+
+    /** Does the CPU run in the current quantum? */
+    std::vector<bool> active;
+
+    /** Time the CPU took for its quantum. */
+    std::vector<Tick> latency;
+
+    /** Threads for all CPUs but the first, which runs on this one. */
+    std::vector<pthread_t> threads;
+    std::vector<CPUThread> threadArgs;
+    Barrier *quantumStart;
+    Barrier *quantumEnd;
+    bool stopping;
+
+    /** Lock for everything but memory accesses; it is recursive. */
+    pthread_mutex_t mutex;
+
+    ParallelAtomicGroup();
+
+    static void *threadMain(void *arg);
+    void startThreads();
+    void runCPU(int idx);
+
+    /**
+     * Release the threads from the quantum barrier and join them. This
+     * is an exit callback rather than a destructor: the group is never
+     * destroyed, so an exit() from within a quantum doesn't wait on
+     * threads that will never reach the barrier.
+     */
+    void stopThreads();
+
+  public:
+    /** The group all parallel CPUs belong to. */
+    static ParallelAtomicGroup *group();
+
+    void add(AtomicSimpleCPU *cpu);
+
+    /** Runs the quantum of a CPU whose tick came up, and its peers. */
+    void tick(AtomicSimpleCPU *cpu);
+
+    void lock() { pthread_mutex_lock(&mutex); }
+    void unlock() { pthread_mutex_unlock(&mutex); }
+};
+
+#endif // __CPU_SIMPLE_PARALLEL_GROUP_HH__
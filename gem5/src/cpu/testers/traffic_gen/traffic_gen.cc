@@ -39,6 +39,12 @@
  *          Sascha Bischoff
  */
 
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstring>
 #include <sstream>
 
 #include "base/random.hh"
@@ -493,25 +499,122 @@ TrafficGen::StateGraph::RandomGen::nextExecuteTick()
     }
 }
 
-Tick
-TrafficGen::StateGraph::TraceGen::nextExecuteTick() {
-    // We need to look at the next line to calculate the next time an
-    // event occurs, or potentially return MaxTick to signal that
-    // nothing has to be done.
-    string buffer;
-    if (!traceComplete && trace.good()){
-        getline(trace, buffer);
-        DPRINTF(TrafficGen, "Input trace: %s\n", buffer);
-    } else {
-        // We are at the end of the file, thus we have no more data in
-        // the trace Return MaxTick to signal that there will be no
-        // more transactions in this active period for the state.
-        return MaxTick;
+const char TrafficGen::StateGraph::TraceGen::binaryTraceMagic[8] =
+    { 'g', 'e', 'm', '5', 't', 'g', 'e', 'n' };
+
+TrafficGen::StateGraph::TraceGen::TraceGen(QueuedMasterPort& _port,
+                                           MasterID master_id,
+                                           Tick _duration,
+                                           const string& trace_file,
+                                           Addr addr_offset)
+    : BaseGen(_port, master_id, _duration),
+      traceFile(trace_file),
+      readBuffer(NULL),
+      binary(false),
+      binaryMap(NULL),
+      binaryMapSize(0),
+      binaryBegin(NULL),
+      binaryPos(NULL),
+      binaryEnd(NULL),
+      addrOffset(addr_offset),
+      traceComplete(false)
+{
+    binary = mapBinaryTrace();
+
+    if (!binary) {
+        /**
+         * Create a 4MB read buffer for the input trace
+         * file. This is to reduce the number of disk accesses
+         * and thereby speed up the execution of the code.
+         */
+        readBuffer = new char[4 * 1024 * 1024];
+        trace.rdbuf()->pubsetbuf(readBuffer, 4 * 1024 * 1024);
+        trace.open(traceFile.c_str(), ifstream::in);
+
+        if (!trace.is_open()) {
+            fatal("Traffic generator %s trace file could not be"
+                  " opened: %s\n", name(), traceFile);
+        }
     }
+}
 
-    //Reset the nextElement to the default values
-    currElement = nextElement;
-    nextElement.clear();
+TrafficGen::StateGraph::TraceGen::~TraceGen()
+{
+    if (binaryMap)
+        munmap(binaryMap, binaryMapSize);
+
+    // free the memory used by the readBuffer
+    delete[] readBuffer;
+}
+
+bool
+TrafficGen::StateGraph::TraceGen::mapBinaryTrace()
+{
+    int fd = open(traceFile.c_str(), O_RDONLY);
+    if (fd < 0) {
+        fatal("Traffic generator %s trace file could not be"
+              " opened: %s\n", name(), traceFile);
+    }
+
+    struct stat sb;
+    if (fstat(fd, &sb) != 0) {
+        fatal("Traffic generator %s could not stat trace file %s\n",
+              name(), traceFile);
+    }
+
+    // anything without the binary header is treated as a text trace
+    BinaryTraceHeader header;
+    if (sb.st_size < (off_t)sizeof(header) ||
+        pread(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header) ||
+        memcmp(header.magic, binaryTraceMagic, sizeof(header.magic)) != 0) {
+        close(fd);
+        return false;
+    }
+
+    if (header.version != 1 ||
+        header.recordSize != sizeof(BinaryTraceRecord)) {
+        fatal("Traffic generator %s: binary trace %s has version %d and "
+              "%d-byte records, expected version 1 and %d-byte records\n",
+              name(), traceFile, header.version, header.recordSize,
+              sizeof(BinaryTraceRecord));
+    }
+
+    size_t record_bytes = sb.st_size - sizeof(header);
+    if (record_bytes % sizeof(BinaryTraceRecord) != 0) {
+        warn("Traffic generator %s: binary trace %s ends with a partial "
+             "record, ignoring it\n", name(), traceFile);
+    }
+
+    binaryMapSize = sb.st_size;
+    binaryMap = mmap(NULL, binaryMapSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (binaryMap == MAP_FAILED) {
+        fatal("Traffic generator %s could not map trace file %s\n",
+              name(), traceFile);
+    }
+
+    // the trace is consumed front to back, so let the kernel read
+    // ahead aggressively and drop pages once they have been used
+    madvise(binaryMap, binaryMapSize, MADV_SEQUENTIAL);
+
+    binaryBegin = reinterpret_cast<const BinaryTraceRecord*>(
+        static_cast<const char*>(binaryMap) + sizeof(header));
+    binaryEnd = binaryBegin + record_bytes / sizeof(BinaryTraceRecord);
+    binaryPos = binaryBegin;
+
+    DPRINTF(TrafficGen, "Mapped binary trace %s with %d records\n",
+            traceFile, binaryEnd - binaryBegin);
+
+    return true;
+}
+
+bool
+TrafficGen::StateGraph::TraceGen::readTextElement()
+{
+    string buffer;
+    getline(trace, buffer);
+    DPRINTF(TrafficGen, "Input trace: %s\n", buffer);
 
     // Check that we have something to process. This assume no EOF at
     // the end of the line.
@@ -549,6 +652,53 @@ TrafficGen::StateGraph::TraceGen::nextExecuteTick() {
             warn("%s", buffer);
         }
 
+        return false;
+    }
+
+    return true;
+}
+
+bool
+TrafficGen::StateGraph::TraceGen::readBinaryElement()
+{
+    if (binaryPos == binaryEnd)
+        return false;
+
+    const BinaryTraceRecord& record = *binaryPos++;
+
+    nextElement.addr = record.addr;
+    nextElement.blocksize = record.blocksize;
+    nextElement.tick = record.tick;
+
+    if (record.cmd == 'r') {
+        nextElement.cmd = MemCmd::ReadReq;
+    } else if (record.cmd == 'w') {
+        nextElement.cmd = MemCmd::WriteReq;
+    } else {
+        fatal("Incorrect command in record %d of binary trace %s\n",
+              binaryPos - binaryBegin - 1, traceFile);
+    }
+
+    return true;
+}
+
+Tick
+TrafficGen::StateGraph::TraceGen::nextExecuteTick() {
+    // We need to look at the next element to calculate the next time
+    // an event occurs, or potentially return MaxTick to signal that
+    // nothing has to be done.
+    if (traceComplete || (!binary && !trace.good())) {
+        // We are at the end of the file, thus we have no more data in
+        // the trace Return MaxTick to signal that there will be no
+        // more transactions in this active period for the state.
+        return MaxTick;
+    }
+
+    //Reset the nextElement to the default values
+    currElement = nextElement;
+    nextElement.clear();
+
+    if (!(binary ? readBinaryElement() : readTextElement())) {
         traceComplete = true;
         return MaxTick;
     }
@@ -575,9 +725,14 @@ TrafficGen::StateGraph::TraceGen::enter() {
     // update the trace offset to the time where the state was entered.
     tickOffset = curTick();
 
-    // seek to the start of the input trace file
-    trace.seekg(0, ifstream::beg);
-    trace.clear();
+    if (binary) {
+        // rewind to the first record
+        binaryPos = binaryBegin;
+    } else {
+        // seek to the start of the input trace file
+        trace.seekg(0, ifstream::beg);
+        trace.clear();
+    }
 
     // clear everything
     nextElement.clear();
@@ -619,13 +774,14 @@ TrafficGen::StateGraph::TraceGen::exit() {
     // Check if we reached the end of the trace file. If we did not
     // then we want to generate a warning stating that not the entire
     // trace was played.
-    if (!trace.eof()) {
+    if (binary ? binaryPos != binaryEnd : !trace.eof()) {
         warn("Trace player %s was unable to replay the entire trace!\n",
              name());
     }
 
     // clear any previous error flags for the input trace file
-    trace.clear();
+    if (!binary)
+        trace.clear();
 }
 
 bool
@@ -399,6 +399,13 @@ class TrafficGen : public MemObject
          * The trace replay generator reads a trace file and plays
          * back the transactions. The trace is offset with respect to
          * the time when the state was entered.
+         *
+         * Two trace formats are supported. The text format has one
+         * "r|w,addr,size,tick" transaction per line. The binary
+         * format, recognised by its header, is a sequence of
+         * fixed-size records that are decoded straight from a
+         * memory-mapped view of the file, avoiding any parsing on the
+         * critical path of long replays.
          */
         class TraceGen : public BaseGen
         {
@@ -441,6 +448,46 @@ class TrafficGen : public MemObject
 
           public:
 
+            /**
+             * Header of a binary trace file. All fields, as well as
+             * the records that follow, are in host byte order.
+             */
+            struct BinaryTraceHeader {
+
+                /** Identifies the file as a binary trace */
+                char magic[8];
+
+                /** Format version, currently always 1 */
+                uint32_t version;
+
+                /** Size of each record in bytes */
+                uint32_t recordSize;
+            };
+
+            /**
+             * A single transaction in a binary trace file.
+             */
+            struct BinaryTraceRecord {
+
+                /** The time at which the request should be sent */
+                uint64_t tick;
+
+                /** The address for the request */
+                uint64_t addr;
+
+                /** The size of the access for the request */
+                uint32_t blocksize;
+
+                /** 'r' for a read, 'w' for a write */
+                uint8_t cmd;
+
+                /** Padding to keep the records naturally aligned */
+                uint8_t pad[3];
+            };
+
+            /** Magic string at the start of a binary trace */
+            static const char binaryTraceMagic[8];
+
            /**
              * Create a trace generator.
              *
@@ -452,31 +499,9 @@ class TrafficGen : public MemObject
              */
             TraceGen(QueuedMasterPort& _port, MasterID master_id,
                      Tick _duration, const std::string& trace_file,
-                     Addr addr_offset)
-                : BaseGen(_port, master_id, _duration),
-                  traceFile(trace_file),
-                  addrOffset(addr_offset),
-                  traceComplete(false)
-            {
-                /**
-                 * Create a 4MB read buffer for the input trace
-                 * file. This is to reduce the number of disk accesses
-                 * and thereby speed up the execution of the code.
-                 */
-                readBuffer = new char[4 * 1024 * 1024];
-                trace.rdbuf()->pubsetbuf(readBuffer, 4 * 1024 * 1024);
-                trace.open(traceFile.c_str(), std::ifstream::in);
-
-                if (!trace.is_open()) {
-                    fatal("Traffic generator %s trace file could not be"
-                          " opened: %s\n", name(), traceFile);
-                }
-            }
+                     Addr addr_offset);
 
-            ~TraceGen() {
-                // free the memory used by the readBuffer
-                delete[] readBuffer;
-            }
+            ~TraceGen();
 
             void enter();
 
@@ -494,6 +519,28 @@ class TrafficGen : public MemObject
 
           private:
 
+            /**
+             * Try to map the trace file as a binary trace.
+             *
+             * @return true if the file is a binary trace
+             */
+            bool mapBinaryTrace();
+
+            /**
+             * Parse the next line of a text trace into nextElement.
+             *
+             * @return false if the end of the trace is reached
+             */
+            bool readTextElement();
+
+            /**
+             * Decode the next record of a binary trace into
+             * nextElement.
+             *
+             * @return false if the end of the trace is reached
+             */
+            bool readBinaryElement();
+
             /** Path to the trace file */
             std::string traceFile;
 
@@ -503,6 +550,18 @@ class TrafficGen : public MemObject
             /** Larger buffer used for reading from the stream */
             char* readBuffer;
 
+            /** Is the trace in the binary format? */
+            bool binary;
+
+            /** Start and size of the mapping of a binary trace */
+            void* binaryMap;
+            size_t binaryMapSize;
+
+            /** First, next and one past the last binary record */
+            const BinaryTraceRecord* binaryBegin;
+            const BinaryTraceRecord* binaryPos;
+            const BinaryTraceRecord* binaryEnd;
+
             /** Store the current and next element in the trace */
             TraceElement currElement;
             TraceElement nextElement;
@@ -42,12 +42,21 @@
 from m5.params import *
 from MemObject import MemObject
 
+# Enum for the on-disk format of the memory contents in a checkpoint.
+# 'gzip' streams the whole memory through a single gzip file,
+# 'sparse' writes the non-zero pages to a sparse raw file that is
+# mapped copy-on-write on restore, and 'chunked' compresses the
+# non-zero pages in independent chunks in parallel, with an index
+class MemCptFormat(Enum): vals = ['gzip', 'sparse', 'chunked']
+
 class AbstractMemory(MemObject):
     type = 'AbstractMemory'
     abstract = True
     range = Param.AddrRange(AddrRange('128MB'), "Address range")
     null = Param.Bool(False, "Do not store data, always return zero")
     zero = Param.Bool(False, "Initialize memory with zeros")
+    cpt_format = Param.MemCptFormat('gzip',
+                                    "Format of the memory in a checkpoint")
 
     # All memories are passed to the global physical memory, and
     # certain memories may be excluded from the global address map,
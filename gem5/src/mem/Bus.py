@@ -71,3 +71,8 @@ class NoncoherentBus(BaseBus):
 
 class CoherentBus(BaseBus):
     type = 'CoherentBus'
+
+    # Track which upstream ports may hold each block and only snoop
+    # those, rather than broadcasting to all snooping ports
+    snoop_filter = Param.Bool(False, "Filter snoops using an exact " \
+                                  "sparse directory")
@@ -95,3 +95,25 @@ class CommMonitor(MemObject):
     read_addr_mask = Param.Addr(MaxAddr, "Address mask for read address")
     write_addr_mask = Param.Addr(MaxAddr, "Address mask for write address")
     disable_addr_dists = Param.Bool(True, "Disable address distributions")
+
+    # block address trace of all the requests passing the monitor, one
+    # 64-bit address per request, e.g. the stream past the L1 caches as
+    # the oracle of the Ruby OPT replacement policy
+    block_trace = Param.String("", "File in the output directory to " \
+                                   "record block addresses to")
+    block_trace_size = Param.Unsigned(64, "Block size used to align the " \
+                                          "recorded addresses")
+
+    # LRU stack (reuse) distances of the requests passing the monitor,
+    # in blocks, and the number of distinct blocks accessed per sample
+    # period; a sample rate below one tracks only that fraction of the
+    # blocks and scales the results up (SHARDS)
+    reuse_dist_bins = Param.Unsigned('20', "# bins in reuse distance " \
+                                         "histograms")
+    working_set_bins = Param.Unsigned('20', "# bins in working set " \
+                                          "histograms")
+    reuse_block_size = Param.Unsigned(64, "Block size of reuse distances")
+    reuse_sample_rate = Param.Float(1.0, "Fraction of blocks sampled for " \
+                                        "reuse distances")
+    disable_reuse_dists = Param.Bool(True, "Disable reuse distance and " \
+                                         "working set histograms")
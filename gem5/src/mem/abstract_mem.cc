@@ -43,17 +43,21 @@
  */
 
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/user.h>
 #include <fcntl.h>
+#include <pthread.h>
 #include <unistd.h>
 #include <zlib.h>
 
+#include <algorithm>
 #include <cerrno>
 #include <cstdio>
 #include <climits>
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include "arch/registers.hh"
 #include "config/the_isa.hh"
@@ -444,22 +448,251 @@ AbstractMemory::functionalAccess(PacketPtr pkt)
     }
 }
 
+/**
+ * A chunk of non-zero memory in a chunked checkpoint. The index file
+ * holds one of these per chunk.
+ */
+struct CptChunk
+{
+    /** Offset of the chunk from the start of the memory. */
+    uint64_t memOffset;
+    /** Uncompressed size of the chunk. */
+    uint64_t size;
+    /** Offset of the compressed data in the data file. */
+    uint64_t fileOffset;
+    /** Compressed size of the chunk. */
+    uint64_t compSize;
+};
+
+typedef std::vector<CptChunk> CptChunkList;
+
+/** Size of a chunk compressed independently in a chunked checkpoint. */
+static const uint64_t cptChunkBytes = 4 * 1024 * 1024;
+
+/** Magic number at the start of a chunked checkpoint index. */
+static const uint64_t cptChunkMagic = 0x6d656d63686e6b31ULL; // "memchnk1"
+
+/**
+ * Check if a page of memory contains only zeros. Both the address
+ * and the size are multiples of the word size.
+ */
+static bool
+pageIsZero(const uint8_t *page, Addr bytes)
+{
+    const long *p = (const long *)page;
+    const long *end = (const long *)(page + bytes);
+    while (p != end) {
+        if (*p++ != 0)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Write or read all of a buffer at the given file offset, retrying
+ * on short transfers.
+ */
+static bool
+pwriteAll(int fd, const uint8_t *buf, uint64_t len, uint64_t off)
+{
+    while (len) {
+        ssize_t ret = pwrite(fd, buf, len, off);
+        if (ret < 0 && errno == EINTR)
+            continue;
+        if (ret <= 0)
+            return false;
+        buf += ret;
+        off += ret;
+        len -= ret;
+    }
+    return true;
+}
+
+static bool
+preadAll(int fd, uint8_t *buf, uint64_t len, uint64_t off)
+{
+    while (len) {
+        ssize_t ret = pread(fd, buf, len, off);
+        if (ret < 0 && errno == EINTR)
+            continue;
+        if (ret <= 0)
+            return false;
+        buf += ret;
+        off += ret;
+        len -= ret;
+    }
+    return true;
+}
+
+/**
+ * State shared by the threads (de)compressing the chunks of a
+ * chunked checkpoint. Thread t handles chunks begin + t, begin + t +
+ * numThreads, and so on up to end.
+ */
+struct CptChunkWork
+{
+    uint8_t *pmem;
+    int fd;
+    CptChunkList *chunks;
+    std::vector<std::vector<uint8_t> > *bufs;
+    int begin;
+    int end;
+    int numThreads;
+};
+
+/** A thread of the work, with a status only it writes. */
+struct CptChunkThread
+{
+    CptChunkWork *work;
+    int tid;
+    bool failed;
+};
+
+static void *
+compressChunks(void *arg)
+{
+    CptChunkThread *thread = (CptChunkThread *)arg;
+    CptChunkWork *work = thread->work;
+
+    for (int i = work->begin + thread->tid; i < work->end;
+         i += work->numThreads) {
+        CptChunk &chunk = (*work->chunks)[i];
+        std::vector<uint8_t> &buf = (*work->bufs)[i - work->begin];
+
+        uLongf comp_size = compressBound(chunk.size);
+        buf.resize(comp_size);
+        if (compress2(&buf[0], &comp_size, work->pmem + chunk.memOffset,
+                      chunk.size, Z_BEST_SPEED) != Z_OK) {
+            thread->failed = true;
+            return NULL;
+        }
+        chunk.compSize = comp_size;
+    }
+    return NULL;
+}
+
+static void *
+uncompressChunks(void *arg)
+{
+    CptChunkThread *thread = (CptChunkThread *)arg;
+    CptChunkWork *work = thread->work;
+    std::vector<uint8_t> buf;
+
+    for (int i = work->begin + thread->tid; i < work->end;
+         i += work->numThreads) {
+        const CptChunk &chunk = (*work->chunks)[i];
+
+        buf.resize(chunk.compSize);
+        if (!preadAll(work->fd, &buf[0], chunk.compSize, chunk.fileOffset)) {
+            thread->failed = true;
+            return NULL;
+        }
+
+        uLongf size = chunk.size;
+        if (uncompress(work->pmem + chunk.memOffset, &size, &buf[0],
+                       chunk.compSize) != Z_OK || size != chunk.size) {
+            thread->failed = true;
+            return NULL;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Run a (de)compression function on as many threads as the host has
+ * processors, and wait for them to finish.
+ *
+ * @return true if all the threads succeeded
+ */
+static bool
+runChunkThreads(CptChunkWork &work, void *(*func)(void *))
+{
+    std::vector<pthread_t> threads(work.numThreads);
+    std::vector<CptChunkThread> args(work.numThreads);
+
+    for (int t = 0; t < work.numThreads; t++) {
+        args[t].work = &work;
+        args[t].tid = t;
+        args[t].failed = false;
+        if (pthread_create(&threads[t], NULL, func, &args[t]) != 0)
+            fatal("Could not create checkpoint thread\n");
+    }
+
+    // The statuses are only read once their threads have been joined
+    bool ok = true;
+    for (int t = 0; t < work.numThreads; t++) {
+        pthread_join(threads[t], NULL);
+        ok = ok && !args[t].failed;
+    }
+    return ok;
+}
+
+static int
+cptNumThreads()
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus > 0 ? cpus : 1;
+}
+
+Addr
+AbstractMemory::cptPageBytes() const
+{
+    Addr host_page = sysconf(_SC_PAGESIZE);
+    return std::max(host_page, (Addr)TheISA::PageBytes);
+}
+
 void
 AbstractMemory::serialize(ostream &os)
 {
     if (!pmemAddr)
         return;
 
-    gzFile compressedMem;
     string filename = name() + ".physmem";
     long _size = range.size();
+    string format = Enums::MemCptFormatStrings[params()->cpt_format];
 
     SERIALIZE_SCALAR(filename);
     SERIALIZE_SCALAR(_size);
+    SERIALIZE_SCALAR(format);
+
+    // Unlink rather than truncate any old file, since it may still be
+    // mapped by a memory that was restored from it
+    string thefile = Checkpoint::dir() + "/" + filename;
+    unlink(thefile.c_str());
+
+    switch (params()->cpt_format) {
+      case Enums::gzip:
+        serializeGzip(thefile);
+        break;
+      case Enums::sparse:
+        serializeSparse(thefile);
+        break;
+      case Enums::chunked:
+        serializeChunked(thefile);
+        break;
+      default:
+        panic("Unknown memory checkpoint format\n");
+    }
+
+    list<LockedAddr>::iterator i = lockedAddrList.begin();
+
+    vector<Addr> lal_addr;
+    vector<int> lal_cid;
+    while (i != lockedAddrList.end()) {
+        lal_addr.push_back(i->addr);
+        lal_cid.push_back(i->contextId);
+        i++;
+    }
+    arrayParamOut(os, "lal_addr", lal_addr);
+    arrayParamOut(os, "lal_cid", lal_cid);
+}
+
+void
+AbstractMemory::serializeGzip(const string &filename)
+{
+    gzFile compressedMem;
 
-    // write memory file
-    string thefile = Checkpoint::dir() + "/" + filename.c_str();
-    int fd = creat(thefile.c_str(), 0664);
+    int fd = creat(filename.c_str(), 0664);
     if (fd < 0) {
         perror("creat");
         fatal("Can't open physical memory checkpoint file '%s'\n", filename);
@@ -486,55 +719,148 @@ AbstractMemory::serialize(ostream &os)
     if (gzclose(compressedMem))
         fatal("Close failed on physical memory checkpoint file '%s'\n",
               filename);
+}
 
-    list<LockedAddr>::iterator i = lockedAddrList.begin();
+void
+AbstractMemory::serializeSparse(const string &filename)
+{
+    int fd = creat(filename.c_str(), 0664);
+    if (fd < 0) {
+        perror("creat");
+        fatal("Can't open physical memory checkpoint file '%s'\n", filename);
+    }
 
-    vector<Addr> lal_addr;
-    vector<int> lal_cid;
-    while (i != lockedAddrList.end()) {
-        lal_addr.push_back(i->addr);
-        lal_cid.push_back(i->contextId);
-        i++;
+    // The file mirrors the memory byte for byte, but only runs of
+    // non-zero pages are written, leaving the rest as holes
+    Addr page_bytes = cptPageBytes();
+    uint64_t offset = 0;
+    while (offset < size()) {
+        Addr len = std::min((uint64_t)page_bytes, size() - offset);
+        if (pageIsZero(pmemAddr + offset, len)) {
+            offset += len;
+            continue;
+        }
+
+        uint64_t start = offset;
+        while (offset < size()) {
+            len = std::min((uint64_t)page_bytes, size() - offset);
+            if (pageIsZero(pmemAddr + offset, len))
+                break;
+            offset += len;
+        }
+
+        if (!pwriteAll(fd, pmemAddr + start, offset - start, start))
+            fatal("Write failed on physical memory checkpoint file '%s'\n",
+                  filename);
     }
-    arrayParamOut(os, "lal_addr", lal_addr);
-    arrayParamOut(os, "lal_cid", lal_cid);
+
+    if (ftruncate(fd, size()) != 0 || close(fd) != 0)
+        fatal("Close failed on physical memory checkpoint file '%s'\n",
+              filename);
 }
 
 void
-AbstractMemory::unserialize(Checkpoint *cp, const string &section)
+AbstractMemory::serializeChunked(const string &filename)
 {
-    if (!pmemAddr)
-        return;
+    // Split the non-zero runs of pages into chunks that can be
+    // compressed independently
+    CptChunkList chunks;
+    Addr page_bytes = cptPageBytes();
+    for (uint64_t offset = 0; offset < size(); offset += page_bytes) {
+        Addr len = std::min((uint64_t)page_bytes, size() - offset);
+        if (pageIsZero(pmemAddr + offset, len))
+            continue;
+
+        if (!chunks.empty()) {
+            CptChunk &last = chunks.back();
+            if (last.memOffset + last.size == offset &&
+                last.size + len <= cptChunkBytes) {
+                last.size += len;
+                continue;
+            }
+        }
 
-    gzFile compressedMem;
-    long *tempPage;
-    long *pmem_current;
-    uint64_t curSize;
-    uint32_t bytesRead;
-    const uint32_t chunkSize = 16384;
+        CptChunk chunk;
+        chunk.memOffset = offset;
+        chunk.size = len;
+        chunk.fileOffset = 0;
+        chunk.compSize = 0;
+        chunks.push_back(chunk);
+    }
 
-    string filename;
+    int fd = creat(filename.c_str(), 0664);
+    if (fd < 0) {
+        perror("creat");
+        fatal("Can't open physical memory checkpoint file '%s'\n", filename);
+    }
 
-    UNSERIALIZE_SCALAR(filename);
+    // Compress a bounded window of chunks at a time, so that the
+    // compressed data never has to be held in memory all at once
+    CptChunkWork work;
+    work.pmem = pmemAddr;
+    work.fd = fd;
+    work.chunks = &chunks;
+    work.numThreads = cptNumThreads();
+
+    int window = work.numThreads * 4;
+    std::vector<std::vector<uint8_t> > bufs(window);
+    work.bufs = &bufs;
+
+    uint64_t file_offset = 0;
+    for (int begin = 0; begin < chunks.size(); begin += window) {
+        work.begin = begin;
+        work.end = std::min(begin + window, (int)chunks.size());
+        if (!runChunkThreads(work, compressChunks))
+            fatal("Compression failed on physical memory checkpoint "
+                  "file '%s'\n", filename);
+
+        for (int i = work.begin; i < work.end; i++) {
+            chunks[i].fileOffset = file_offset;
+            if (!pwriteAll(fd, &bufs[i - begin][0], chunks[i].compSize,
+                           file_offset))
+                fatal("Write failed on physical memory checkpoint "
+                      "file '%s'\n", filename);
+            file_offset += chunks[i].compSize;
+        }
+    }
 
-    filename = cp->cptDir + "/" + filename;
+    if (close(fd) != 0)
+        fatal("Close failed on physical memory checkpoint file '%s'\n",
+              filename);
 
-    // mmap memoryfile
-    int fd = open(filename.c_str(), O_RDONLY);
+    // Write the index
+    string idxfile = filename + ".idx";
+    unlink(idxfile.c_str());
+    fd = creat(idxfile.c_str(), 0664);
     if (fd < 0) {
-        perror("open");
-        fatal("Can't open physical memory checkpoint file '%s'", filename);
+        perror("creat");
+        fatal("Can't open physical memory index file '%s'\n", idxfile);
     }
 
-    compressedMem = gzdopen(fd, "rb");
-    if (compressedMem == NULL)
-        fatal("Insufficient memory to allocate compression state for %s\n",
-                filename);
+    uint64_t header[2] = { cptChunkMagic, chunks.size() };
+    if (!pwriteAll(fd, (const uint8_t *)header, sizeof(header), 0) ||
+        (!chunks.empty() &&
+         !pwriteAll(fd, (const uint8_t *)&chunks[0],
+                    chunks.size() * sizeof(CptChunk), sizeof(header))))
+        fatal("Write failed on physical memory index file '%s'\n", idxfile);
 
-    // unmap file that was mmapped in the constructor
-    // This is done here to make sure that gzip and open don't muck with our
-    // nice large space of memory before we reallocate it
-    munmap((char*)pmemAddr, size());
+    if (close(fd) != 0)
+        fatal("Close failed on physical memory index file '%s'\n", idxfile);
+}
+
+void
+AbstractMemory::unserialize(Checkpoint *cp, const string &section)
+{
+    if (!pmemAddr)
+        return;
+
+    string filename;
+    UNSERIALIZE_SCALAR(filename);
+    filename = cp->cptDir + "/" + filename;
+
+    // Checkpoints predating the format parameter are gzip files
+    string format = "gzip";
+    UNSERIALIZE_OPT_SCALAR(format);
 
     long _size;
     UNSERIALIZE_SCALAR(_size);
@@ -542,6 +868,9 @@ AbstractMemory::unserialize(Checkpoint *cp, const string &section)
         fatal("Memory size has changed! size %lld, param size %lld\n",
               _size, params()->range.size());
 
+    // Replace the memory mapped in the constructor by a fresh zero
+    // mapping, so only the non-zero parts need to be filled in
+    munmap((char*)pmemAddr, size());
     pmemAddr = (uint8_t *)mmap(NULL, size(),
         PROT_READ | PROT_WRITE, MAP_ANON | MAP_PRIVATE, -1, 0);
 
@@ -550,6 +879,44 @@ AbstractMemory::unserialize(Checkpoint *cp, const string &section)
         fatal("Could not mmap physical memory!\n");
     }
 
+    if (format == "gzip")
+        unserializeGzip(filename);
+    else if (format == "sparse")
+        unserializeSparse(filename);
+    else if (format == "chunked")
+        unserializeChunked(filename);
+    else
+        fatal("Unknown memory checkpoint format '%s'\n", format);
+
+    vector<Addr> lal_addr;
+    vector<int> lal_cid;
+    arrayParamIn(cp, section, "lal_addr", lal_addr);
+    arrayParamIn(cp, section, "lal_cid", lal_cid);
+    for(int i = 0; i < lal_addr.size(); i++)
+        lockedAddrList.push_front(LockedAddr(lal_addr[i], lal_cid[i]));
+}
+
+void
+AbstractMemory::unserializeGzip(const string &filename)
+{
+    gzFile compressedMem;
+    long *tempPage;
+    long *pmem_current;
+    uint64_t curSize;
+    uint32_t bytesRead;
+    const uint32_t chunkSize = 16384;
+
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        perror("open");
+        fatal("Can't open physical memory checkpoint file '%s'", filename);
+    }
+
+    compressedMem = gzdopen(fd, "rb");
+    if (compressedMem == NULL)
+        fatal("Insufficient memory to allocate compression state for %s\n",
+                filename);
+
     curSize = 0;
     tempPage = (long*)malloc(chunkSize);
     if (tempPage == NULL)
@@ -578,11 +945,94 @@ AbstractMemory::unserialize(Checkpoint *cp, const string &section)
     if (gzclose(compressedMem))
         fatal("Close failed on physical memory checkpoint file '%s'\n",
               filename);
+}
 
-    vector<Addr> lal_addr;
-    vector<int> lal_cid;
-    arrayParamIn(cp, section, "lal_addr", lal_addr);
-    arrayParamIn(cp, section, "lal_cid", lal_cid);
-    for(int i = 0; i < lal_addr.size(); i++)
-        lockedAddrList.push_front(LockedAddr(lal_addr[i], lal_cid[i]));
+void
+AbstractMemory::unserializeSparse(const string &filename)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        perror("open");
+        fatal("Can't open physical memory checkpoint file '%s'", filename);
+    }
+
+    struct stat sb;
+    if (fstat(fd, &sb) != 0)
+        fatal("Can't stat physical memory checkpoint file '%s'", filename);
+
+    // Map the page-aligned part of the file copy-on-write on top of
+    // the memory; pages are only read in when they are touched. Any
+    // unaligned tail is small enough to simply be read.
+    uint64_t file_size = std::min((uint64_t)sb.st_size, size());
+    uint64_t mapped = file_size - file_size % sysconf(_SC_PAGESIZE);
+
+    if (mapped) {
+        void *addr = mmap(pmemAddr, mapped, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_FIXED, fd, 0);
+        if (addr == MAP_FAILED) {
+            perror("mmap");
+            fatal("Could not mmap physical memory checkpoint file '%s'\n",
+                  filename);
+        }
+    }
+
+    if (mapped < file_size &&
+        !preadAll(fd, pmemAddr + mapped, file_size - mapped, mapped))
+        fatal("Read failed on physical memory checkpoint file '%s'\n",
+              filename);
+
+    // The mapping holds its own reference to the file
+    close(fd);
+}
+
+void
+AbstractMemory::unserializeChunked(const string &filename)
+{
+    string idxfile = filename + ".idx";
+    int fd = open(idxfile.c_str(), O_RDONLY);
+    if (fd < 0) {
+        perror("open");
+        fatal("Can't open physical memory index file '%s'", idxfile);
+    }
+
+    uint64_t header[2];
+    if (!preadAll(fd, (uint8_t *)header, sizeof(header), 0) ||
+        header[0] != cptChunkMagic)
+        fatal("Bad physical memory index file '%s'\n", idxfile);
+
+    CptChunkList chunks(header[1]);
+    if (!chunks.empty() &&
+        !preadAll(fd, (uint8_t *)&chunks[0], chunks.size() * sizeof(CptChunk),
+                  sizeof(header)))
+        fatal("Read failed on physical memory index file '%s'\n", idxfile);
+    close(fd);
+
+    for (int i = 0; i < chunks.size(); i++) {
+        if (chunks[i].memOffset + chunks[i].size > size())
+            fatal("Physical memory index file '%s' exceeds the memory\n",
+                  idxfile);
+    }
+
+    fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        perror("open");
+        fatal("Can't open physical memory checkpoint file '%s'", filename);
+    }
+
+    // Chunks are independent, so each thread inflates straight into
+    // the memory without any further coordination
+    CptChunkWork work;
+    work.pmem = pmemAddr;
+    work.fd = fd;
+    work.chunks = &chunks;
+    work.bufs = NULL;
+    work.begin = 0;
+    work.end = chunks.size();
+    work.numThreads = std::min(cptNumThreads(), std::max(work.end, 1));
+
+    if (!runChunkThreads(work, uncompressChunks))
+        fatal("Decompression failed on physical memory checkpoint file '%s'\n",
+              filename);
+
+    close(fd);
 }
@@ -109,6 +109,17 @@ class AbstractMemory : public MemObject
 
     std::list<LockedAddr> lockedAddrList;
 
+    /** Granularity at which zero pages are skipped in a checkpoint. */
+    Addr cptPageBytes() const;
+
+    void serializeGzip(const std::string &filename);
+    void serializeSparse(const std::string &filename);
+    void serializeChunked(const std::string &filename);
+
+    void unserializeGzip(const std::string &filename);
+    void unserializeSparse(const std::string &filename);
+    void unserializeChunked(const std::string &filename);
+
     // helper function for checkLockedAddrs(): we really want to
     // inline a quick check for an empty locked addr list (hopefully
     // the common case), and do the full list search (if necessary) in
@@ -142,6 +153,11 @@ class AbstractMemory : public MemObject
         }
     }
 
+    // CPUs running in parallel (see ParallelAtomicGroup) access the
+    // memory without a lock and may lose updates of the statistics
+    // below. Nothing in the simulation reads them, so the only effect
+    // is that they may undercount in that mode.
+
     /** Number of total bytes read from this memory */
     Stats::Vector bytesRead;
     /** Number of instruction bytes read from this memory */
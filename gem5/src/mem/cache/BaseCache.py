@@ -64,3 +64,12 @@ class BaseCache(MemObject):
     mem_side = MasterPort("Port on side closer to MEM")
     addr_ranges = VectorParam.AddrRange([AllMemory], "The address range for the CPU-side port")
     system = Param.System(Parent.any, "System we belong to")
+
+    @classmethod
+    def export_methods(cls, code):
+        code('''
+    void beginWarmup();
+    void fillWarmupData();
+    void endWarmup();
+    void memWriteback();
+''')
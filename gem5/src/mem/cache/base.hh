@@ -271,6 +271,14 @@ class BaseCache : public MemObject
     /** The drain event. */
     Event *drainEvent;
 
+    /**
+     * Is the cache in functional warm-up mode? While set, atomic
+     * accesses only update the tags and replacement state and are
+     * forwarded unchanged to the next level, leaving memory as the
+     * sole holder of up-to-date data.
+     */
+    bool warmingUp;
+
     /**
      * The address range to which the cache responds on the CPU side.
      * Normally this is all possible memory addresses. */
@@ -542,6 +550,31 @@ class BaseCache : public MemObject
 
     virtual unsigned int drain(Event *de);
 
+    /**
+     * Enter functional warm-up mode. The cache must be drained; any
+     * dirty blocks are written back functionally so that memory holds
+     * the only modified copy of the data.
+     */
+    virtual void beginWarmup() = 0;
+
+    /**
+     * Refresh the data of all valid blocks from the memory side. This
+     * must be called on every cache of the hierarchy before any of
+     * them leaves warm-up mode, as the lower levels have to keep
+     * ignoring their stale data until then.
+     */
+    virtual void fillWarmupData() = 0;
+
+    /** Leave functional warm-up mode. */
+    virtual void endWarmup() = 0;
+
+    /**
+     * Functionally copy the data of all dirty blocks to memory, while
+     * keeping them dirty, so that memory is up to date when it is
+     * checkpointed. The cache must be drained.
+     */
+    virtual void memWriteback() = 0;
+
     virtual bool inCache(Addr addr) = 0;
 
     virtual bool inMissQueue(Addr addr) = 0;
@@ -281,6 +281,17 @@ class CacheBlk
     }
 };
 
+/**
+ * Base class for operations applied to every block of a tag store.
+ * @sa BaseTags::forEachBlk()
+ */
+class CacheBlkVisitor
+{
+  public:
+    virtual ~CacheBlkVisitor() {}
+    virtual void visit(CacheBlk &blk) = 0;
+};
+
 /**
  * Simple class to provide virtual print() method on cache blocks
  * without allocating a vtable pointer for every single cache block.
@@ -249,6 +249,61 @@ class Cache : public BaseCache
     void handleSnoop(PacketPtr ptk, BlkType *blk,
                      bool is_timing, bool is_deferred, bool pending_inval);
 
+    /**
+     * Wrapper that lets a member function of the cache be applied to
+     * every block of the tag store.
+     */
+    class BlkVisitorWrapper : public CacheBlkVisitor
+    {
+      public:
+        typedef void (Cache<TagStore>::*VisitorPtr)(BlkType &blk);
+
+        BlkVisitorWrapper(Cache<TagStore> &_cache, VisitorPtr _visitor)
+            : cache(_cache), visitor(_visitor)
+        { }
+
+        void visit(CacheBlk &blk)
+        {
+            (cache.*visitor)(static_cast<BlkType &>(blk));
+        }
+
+      private:
+        Cache<TagStore> &cache;
+        VisitorPtr visitor;
+    };
+
+    /**
+     * Functionally write a dirty block back to the memory side and
+     * mark it clean and not writable.
+     * @param blk The block to write back.
+     */
+    void writebackVisitor(BlkType &blk);
+
+    /**
+     * Functionally copy the data of a dirty block to the memory side,
+     * leaving the block dirty.
+     * @param blk The block to copy.
+     */
+    void memWritebackVisitor(BlkType &blk);
+
+    /**
+     * Functionally reload the data of a valid block from the memory
+     * side.
+     * @param blk The block to refresh.
+     */
+    void fillVisitor(BlkType &blk);
+
+    /**
+     * Performs an atomic access in functional warm-up mode. Only the
+     * tags and replacement state are updated; no data is moved, no
+     * statistics are collected and the request is passed on unchanged
+     * to the next level. Blocks are never made writable, as other
+     * caches do not see the access.
+     * @param pkt The request to perform.
+     * @return The latency reported by the next level.
+     */
+    Tick warmupAccess(PacketPtr pkt);
+
     /**
      * Create a writeback request for the given block.
      * @param blk The block to writeback.
@@ -372,8 +427,17 @@ class Cache : public BaseCache
      */
     Tick nextMSHRReadyTime();
 
-    /** serialize the state of the caches
-     * We currently don't support checkpointing cache state, so this panics.
+    void beginWarmup();
+    void fillWarmupData();
+    void endWarmup();
+    void memWriteback();
+
+    /**
+     * Serialize the state of the cache. The tags, replacement order
+     * and data, including dirty data, are saved by the tag store, so
+     * the checkpoint must be restored into caches of the same
+     * geometry. memWriteback() has already copied the dirty data to
+     * memory, so the checkpoint can also be restored without caches.
      */
     virtual void serialize(std::ostream &os);
     void unserialize(Checkpoint *cp, const std::string &section);
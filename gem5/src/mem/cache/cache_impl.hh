@@ -667,6 +667,9 @@ Cache<TagStore>::atomicAccess(PacketPtr pkt)
         return lat;
     }
 
+    if (warmingUp)
+        return warmupAccess(pkt);
+
     // should assert here that there are no outstanding MSHRs or
     // writebacks... that would mean that someone used an atomic
     // access in timing mode
@@ -753,12 +756,156 @@ Cache<TagStore>::atomicAccess(PacketPtr pkt)
 }
 
 
+template<class TagStore>
+Tick
+Cache<TagStore>::warmupAccess(PacketPtr pkt)
+{
+    // only demand reads and writes train the tags, everything else
+    // (uncacheable accesses, writebacks from above, cache
+    // maintenance) just passes through
+    if (!pkt->req->isUncacheable() && pkt->cmd != MemCmd::Writeback &&
+        (pkt->isRead() || pkt->isWrite())) {
+        Addr addr = pkt->getAddr();
+        int lat = hitLatency;
+        int id = pkt->req->hasContextId() ? pkt->req->contextId() : -1;
+        BlkType *blk = tags->accessBlock(addr, lat, id);
+
+        if (blk == NULL) {
+            PacketList writebacks;
+            blk = tags->findVictim(addr, writebacks);
+            // no block is dirty while warming up, so there is nothing
+            // to write back
+            while (!writebacks.empty()) {
+                delete writebacks.front();
+                writebacks.pop_front();
+            }
+
+            if (blk->isValid()) {
+                DPRINTF(Cache, "warm-up: replacing %x with %x\n",
+                        tags->regenerateBlkAddr(blk->tag, blk->set), addr);
+            }
+
+            // fill as a shared, clean copy, even for a write, as the
+            // write is not snooped and peers may hold the block too;
+            // the first write after warm-up has to upgrade the block
+            tags->insertBlock(addr, blk, pkt->req->masterId());
+            blk->status = BlkValid | BlkReadable;
+            blk->whenReady = 0;
+        }
+    }
+
+    return memSidePort->sendAtomic(pkt);
+}
+
+
+template<class TagStore>
+void
+Cache<TagStore>::writebackVisitor(BlkType &blk)
+{
+    if (blk.isDirty()) {
+        memWritebackVisitor(blk);
+        blk.status &= ~BlkDirty;
+    }
+
+    // warm-up accesses are not snooped, so no copy may stay writable
+    blk.status &= ~BlkWritable;
+}
+
+
+template<class TagStore>
+void
+Cache<TagStore>::memWritebackVisitor(BlkType &blk)
+{
+    if (blk.isDirty()) {
+        assert(blk.isValid());
+
+        Request request(tags->regenerateBlkAddr(blk.tag, blk.set),
+                        blkSize, 0, Request::wbMasterId);
+        Packet packet(&request, MemCmd::MemWritebackReq);
+        packet.dataStatic(blk.data);
+
+        memSidePort->sendFunctional(&packet);
+    }
+}
+
+
+template<class TagStore>
+void
+Cache<TagStore>::fillVisitor(BlkType &blk)
+{
+    if (blk.isValid()) {
+        Request request(tags->regenerateBlkAddr(blk.tag, blk.set),
+                        blkSize, 0, Request::funcMasterId);
+        Packet packet(&request, MemCmd::ReadReq);
+        packet.dataStatic(blk.data);
+
+        memSidePort->sendFunctional(&packet);
+    }
+}
+
+
+template<class TagStore>
+void
+Cache<TagStore>::beginWarmup()
+{
+    if (getState() != SimObject::Drained)
+        fatal("Cache %s must be drained before entering warm-up mode\n",
+              name());
+
+    if (warmingUp)
+        return;
+
+    DPRINTF(Cache, "entering warm-up mode\n");
+
+    BlkVisitorWrapper visitor(*this, &Cache<TagStore>::writebackVisitor);
+    tags->forEachBlk(visitor);
+
+    warmingUp = true;
+}
+
+
+template<class TagStore>
+void
+Cache<TagStore>::fillWarmupData()
+{
+    if (!warmingUp)
+        return;
+
+    BlkVisitorWrapper visitor(*this, &Cache<TagStore>::fillVisitor);
+    tags->forEachBlk(visitor);
+}
+
+
+template<class TagStore>
+void
+Cache<TagStore>::endWarmup()
+{
+    DPRINTF(Cache, "leaving warm-up mode\n");
+    warmingUp = false;
+}
+
+
+template<class TagStore>
+void
+Cache<TagStore>::memWriteback()
+{
+    if (getState() != SimObject::Drained)
+        fatal("Cache %s must be drained before writing back to memory\n",
+              name());
+
+    BlkVisitorWrapper visitor(*this, &Cache<TagStore>::memWritebackVisitor);
+    tags->forEachBlk(visitor);
+}
+
+
 template<class TagStore>
 void
 Cache<TagStore>::functionalAccess(PacketPtr pkt, bool fromCpuSide)
 {
     Addr blk_addr = blockAlign(pkt->getAddr());
-    BlkType *blk = tags->findBlock(pkt->getAddr());
+    // during warm-up the block data is stale and memory holds the
+    // authoritative copy, so act as if the block was not present
+    BlkType *blk = warmingUp ? NULL : tags->findBlock(pkt->getAddr());
     MSHR *mshr = mshrQueue.findMatch(blk_addr);
 
     pkt->pushLabel(name());
@@ -780,6 +927,12 @@ Cache<TagStore>::functionalAccess(PacketPtr pkt, bool fromCpuSide)
         have_data && (blk->isDirty() ||
                       (mshr && mshr->inService && mshr->isPendingDirty()));
 
+    // the memory writebacks of the caches above are meant for memory,
+    // so update our copy on the way but do not stop them, even if our
+    // (older) copy is dirty
+    if (pkt->cmd == MemCmd::MemWritebackReq)
+        have_dirty = false;
+
     bool done = have_dirty
         || cpuSidePort->checkFunctional(pkt)
         || mshrQueue.checkFunctional(pkt, blk_addr)
@@ -1565,17 +1718,14 @@ template<class TagStore>
 void
 Cache<TagStore>::serialize(std::ostream &os)
 {
-    warn("*** Creating checkpoints with caches is not supported. ***\n");
-    warn("    Remove any caches before taking checkpoints\n");
-    warn("    This checkpoint will not restore correctly and dirty data in "
-         "the cache will be lost!\n");
-
-    // Since we don't write back the data dirty in the caches to the physical
-    // memory if caches exist in the system we won't be able to restore
-    // from the checkpoint as any data dirty in the caches will be lost.
-
-    bool bad_checkpoint = true;
+    // The cache is drained, so there are no outstanding misses or
+    // writebacks and the tag store holds all of the state. Dirty
+    // blocks go into the checkpoint along with the clean ones, and
+    // memWriteback() has copied their data to memory as well.
+    bool bad_checkpoint = false;
     SERIALIZE_SCALAR(bad_checkpoint);
+
+    tags->serialize(os);
 }
 
 template<class TagStore>
@@ -1589,6 +1739,8 @@ Cache<TagStore>::unserialize(Checkpoint *cp, const std::string &section)
               "classic memory system. Please remove any caches before taking "
               "checkpoints.\n");
     }
+
+    tags->unserialize(cp, section);
 }
 
 ///////////////
@@ -34,9 +34,12 @@
  * Definitions of BaseTags.
  */
 
+#include <fcntl.h>
+
 #include "cpu/smt.hh" //maxThreadsPerCPU
 #include "mem/cache/tags/base.hh"
 #include "mem/cache/base.hh"
+#include "mem/cache/blk.hh"
 #include "sim/sim_exit.hh"
 
 using namespace std;
@@ -109,3 +112,85 @@ BaseTags::regStats(const string &name)
 
     registerExitCallback(new BaseTagsCallback(this));
 }
+
+gzFile
+BaseTags::cptOpen(const string &filename, bool write)
+{
+    int fd = write ? creat(filename.c_str(), 0664) :
+        open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        perror(write ? "creat" : "open");
+        fatal("Can't open cache tag checkpoint file '%s'\n", filename);
+    }
+
+    gzFile file = gzdopen(fd, write ? "wb" : "rb");
+    if (file == NULL)
+        fatal("Insufficient memory to allocate compression state for %s\n",
+              filename);
+    return file;
+}
+
+void
+BaseTags::cptWrite(gzFile file, const void *buf, unsigned len)
+{
+    if (gzwrite(file, buf, len) != (int)len)
+        fatal("Write failed on cache tag checkpoint of %s\n", name());
+}
+
+void
+BaseTags::cptRead(gzFile file, void *buf, unsigned len)
+{
+    if (gzread(file, buf, len) != (int)len)
+        fatal("Read failed on cache tag checkpoint of %s\n", name());
+}
+
+void
+BaseTags::cptClose(gzFile file)
+{
+    if (gzclose(file))
+        fatal("Close failed on cache tag checkpoint of %s\n", name());
+}
+
+void
+BaseTags::serializeBlk(gzFile file, const CacheBlk *blk, unsigned blk_size)
+{
+    uint64_t tag = blk->tag;
+    uint32_t status = blk->status;
+    int32_t master_id = blk->srcMasterId;
+    int32_t ref_count = blk->refCount;
+
+    cptWrite(file, &tag, sizeof(tag));
+    cptWrite(file, &status, sizeof(status));
+    cptWrite(file, &master_id, sizeof(master_id));
+    cptWrite(file, &ref_count, sizeof(ref_count));
+    if (blk_size)
+        cptWrite(file, blk->data, blk_size);
+}
+
+void
+BaseTags::unserializeBlk(gzFile file, CacheBlk *blk, unsigned blk_size)
+{
+    uint64_t tag;
+    uint32_t status;
+    int32_t master_id;
+    int32_t ref_count;
+
+    cptRead(file, &tag, sizeof(tag));
+    cptRead(file, &status, sizeof(status));
+    cptRead(file, &master_id, sizeof(master_id));
+    cptRead(file, &ref_count, sizeof(ref_count));
+    if (blk_size)
+        cptRead(file, blk->data, blk_size);
+
+    blk->tag = tag;
+    blk->status = status;
+    blk->refCount = ref_count;
+    blk->whenReady = 0;
+    blk->isTouched = blk->isValid();
+
+    // Master IDs are only stable if the system is built the same way
+    if (blk->isValid() && master_id >= cache->system->maxMasters())
+        fatal("%s: block owner %d in the checkpoint is not in the system\n",
+              name(), master_id);
+    blk->srcMasterId = blk->isValid() ? master_id : Request::invldMasterId;
+}
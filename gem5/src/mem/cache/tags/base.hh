@@ -37,12 +37,16 @@
 #ifndef __BASE_TAGS_HH__
 #define __BASE_TAGS_HH__
 
+#include <zlib.h>
+
 #include <string>
 
 #include "base/callback.hh"
 #include "base/statistics.hh"
 
 class BaseCache;
+class CacheBlk;
+class CacheBlkVisitor;
 
 /**
  * A common base class of Cache tagstore objects.
@@ -107,6 +111,43 @@ class BaseTags
      * @}
      */
 
+    /**
+     * @defgroup TagCheckpoint Helpers for checkpointing the tag store.
+     * The tags and data of a cache do not go into the checkpoint
+     * itself but into a compressed file next to it, which is written
+     * and read sequentially with these helpers.
+     * @{
+     */
+
+    /**
+     * Open the tag checkpoint file.
+     * @param filename Path of the file.
+     * @param write True to create the file, false to read it.
+     * @return The opened file, fatal on failure.
+     */
+    gzFile cptOpen(const std::string &filename, bool write);
+
+    void cptWrite(gzFile file, const void *buf, unsigned len);
+    void cptRead(gzFile file, void *buf, unsigned len);
+    void cptClose(gzFile file);
+
+    /**
+     * Write the tag, state and data of a block.
+     * @param file The tag checkpoint file.
+     * @param blk The block to write.
+     * @param blk_size Number of data bytes, 0 if blocks hold no data.
+     */
+    void serializeBlk(gzFile file, const CacheBlk *blk, unsigned blk_size);
+
+    /**
+     * Read back a block written by serializeBlk().
+     */
+    void unserializeBlk(gzFile file, CacheBlk *blk, unsigned blk_size);
+
+    /**
+     * @}
+     */
+
   public:
 
     /**
@@ -147,6 +188,12 @@ class BaseTags
      *Needed to clear all lock tracking at once
      */
     virtual void clearLocks() {}
+
+    /**
+     * Apply a visitor to every block in the tag store, valid or not.
+     * @param visitor The visitor to apply.
+     */
+    virtual void forEachBlk(CacheBlkVisitor &visitor) = 0;
 };
 
 class BaseTagsCallback : public Callback
@@ -39,6 +39,7 @@
 #include "base/intmath.hh"
 #include "base/misc.hh"
 #include "mem/cache/tags/fa_lru.hh"
+#include "sim/serialize.hh"
 
 using namespace std;
 
@@ -299,3 +300,64 @@ FALRU::clearLocks()
         blks[i].clearLoadLocks();
     }
 }
+
+void
+FALRU::forEachBlk(CacheBlkVisitor &visitor)
+{
+    for (unsigned i = 0; i < numBlocks; ++i)
+        visitor.visit(blks[i]);
+}
+
+void
+FALRU::serialize(ostream &os)
+{
+    string filename = name() + ".tags";
+    unsigned blk_size = blkSize;
+    unsigned cache_size = size;
+
+    SERIALIZE_SCALAR(filename);
+    SERIALIZE_SCALAR(blk_size);
+    SERIALIZE_SCALAR(cache_size);
+
+    // FALRU blocks carry no data, only the LRU stack, which is
+    // written from the LRU to the MRU end
+    gzFile file = cptOpen(Checkpoint::dir() + "/" + filename, true);
+    for (FALRUBlk *blk = tail; blk; blk = blk->prev)
+        serializeBlk(file, blk, 0);
+    cptClose(file);
+}
+
+void
+FALRU::unserialize(Checkpoint *cp, const string &section)
+{
+    string filename;
+    unsigned blk_size;
+    unsigned cache_size;
+
+    UNSERIALIZE_SCALAR(filename);
+    UNSERIALIZE_SCALAR(blk_size);
+    UNSERIALIZE_SCALAR(cache_size);
+
+    if (blk_size != blkSize || cache_size != size)
+        fatal("%s: cache geometry changed since the checkpoint (%d bytes, "
+              "%d byte blocks)\n", name(), cache_size, blk_size);
+
+    // Rotate the tail to the head once per block, filling it in from
+    // the LRU end of the stack. After all blocks have gone around the
+    // list is in the checkpointed order, and moveToHead() has kept the
+    // cache size boundaries up to date.
+    tagHash.clear();
+    gzFile file = cptOpen(cp->cptDir + "/" + filename, false);
+    for (unsigned i = 0; i < numBlocks; ++i) {
+        FALRUBlk *blk = tail;
+        moveToHead(blk);
+        unserializeBlk(file, blk, 0);
+
+        if (blk->isValid()) {
+            tagHash[blk->tag] = blk;
+            tagsInUse++;
+        }
+    }
+    cptClose(file);
+    assert(check());
+}
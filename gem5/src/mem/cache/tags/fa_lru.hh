@@ -43,6 +43,8 @@
 #include "mem/cache/blk.hh"
 #include "mem/packet.hh"
 
+class Checkpoint;
+
 /**
  * A fully associative cache block.
  */
@@ -287,6 +289,24 @@ public:
      *Needed to clear all lock tracking at once
      */
     virtual void clearLocks();
+
+    /**
+     * Apply a visitor to every block in the tag store.
+     * @param visitor The visitor to apply.
+     */
+    virtual void forEachBlk(CacheBlkVisitor &visitor);
+
+    /**
+     * Checkpoint the tags and the LRU order of the blocks.
+     * @param os The checkpoint stream.
+     */
+    void serialize(std::ostream &os);
+
+    /**
+     * Restore the tag store from a checkpoint. The cache geometry
+     * must be the same as when the checkpoint was taken.
+     */
+    void unserialize(Checkpoint *cp, const std::string &section);
 };
 
 #endif // __MEM_CACHE_TAGS_FA_LRU_HH__
@@ -46,6 +46,7 @@
 #include "mem/cache/tags/iic.hh"
 #include "mem/cache/base.hh"
 #include "sim/core.hh"
+#include "sim/serialize.hh"
 
 using namespace std;
 
@@ -638,6 +639,13 @@ IIC::clearLocks()
     }
 }
 
+void
+IIC::forEachBlk(CacheBlkVisitor &visitor)
+{
+    for (unsigned i = 0; i < numTags; ++i)
+        visitor.visit(tagStore[i]);
+}
+
 void
 IIC::cleanupRefs()
 {
@@ -648,3 +656,73 @@ IIC::cleanupRefs()
         }
     }
 }
+
+void
+IIC::serialize(ostream &os)
+{
+    string filename = name() + ".tags";
+    unsigned blk_size = blkSize;
+    unsigned num_tags = numTags;
+    unsigned num_valid = 0;
+
+    for (unsigned i = 0; i < numTags; ++i) {
+        if (tagStore[i].isValid())
+            ++num_valid;
+    }
+
+    SERIALIZE_SCALAR(filename);
+    SERIALIZE_SCALAR(blk_size);
+    SERIALIZE_SCALAR(num_tags);
+    SERIALIZE_SCALAR(num_valid);
+
+    gzFile file = cptOpen(Checkpoint::dir() + "/" + filename, true);
+    for (unsigned i = 0; i < numTags; ++i) {
+        if (tagStore[i].isValid())
+            serializeBlk(file, &tagStore[i], blkSize);
+    }
+    cptClose(file);
+}
+
+void
+IIC::unserialize(Checkpoint *cp, const string &section)
+{
+    string filename;
+    unsigned blk_size;
+    unsigned num_tags;
+    unsigned num_valid;
+
+    UNSERIALIZE_SCALAR(filename);
+    UNSERIALIZE_SCALAR(blk_size);
+    UNSERIALIZE_SCALAR(num_tags);
+    UNSERIALIZE_SCALAR(num_valid);
+
+    if (blk_size != blkSize || num_tags != numTags)
+        fatal("%s: cache geometry changed since the checkpoint (%d tags, "
+              "%d byte blocks)\n", name(), num_tags, blk_size);
+
+    // Blocks are put back through the normal allocation path so the
+    // hash chains and the replacement policy are rebuilt. The state
+    // of the replacement policy itself is not checkpointed; it sees
+    // the blocks as inserted in tag store order.
+    CacheBlk tmp;
+    std::vector<uint8_t> tmp_data(blkSize);
+    tmp.data = &tmp_data[0];
+
+    gzFile file = cptOpen(cp->cptDir + "/" + filename, false);
+    for (unsigned i = 0; i < num_valid; ++i) {
+        unserializeBlk(file, &tmp, blkSize);
+
+        PacketList writebacks;
+        IICTag *tag_ptr = findVictim(regenerateBlkAddr(tmp.tag, 0),
+                                     writebacks);
+        assert(writebacks.empty());
+
+        tag_ptr->tag = tmp.tag;
+        tag_ptr->status = tmp.status;
+        tag_ptr->refCount = tmp.refCount;
+        tag_ptr->srcMasterId = tmp.srcMasterId;
+        tag_ptr->whenReady = 0;
+        memcpy(tag_ptr->data, tmp.data, blkSize);
+    }
+    cptClose(file);
+}
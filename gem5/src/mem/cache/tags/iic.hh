@@ -46,6 +46,7 @@
 #include "mem/packet.hh"
 
 class BaseCache; // Forward declaration
+class Checkpoint;
 
 /**
  * IIC cache blk.
@@ -445,11 +446,29 @@ class IIC : public BaseTags
      */
     virtual void clearLocks();
 
+    /**
+     * Apply a visitor to every block in the tag store.
+     * @param visitor The visitor to apply.
+     */
+    virtual void forEachBlk(CacheBlkVisitor &visitor);
+
     /**
      * Called at end of simulation to complete average block reference stats.
      */
     virtual void cleanupRefs();
 
+    /**
+     * Checkpoint the tags and data of all valid blocks.
+     * @param os The checkpoint stream.
+     */
+    void serialize(std::ostream &os);
+
+    /**
+     * Restore the tag store from a checkpoint. The cache geometry
+     * must be the same as when the checkpoint was taken.
+     */
+    void unserialize(Checkpoint *cp, const std::string &section);
+
 private:
     /**
      * Return the hash of the address.
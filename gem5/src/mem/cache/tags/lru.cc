@@ -41,6 +41,7 @@
 #include "mem/cache/tags/lru.hh"
 #include "mem/cache/base.hh"
 #include "sim/core.hh"
+#include "sim/serialize.hh"
 
 using namespace std;
 
@@ -226,6 +227,13 @@ LRU::clearLocks()
     }
 }
 
+void
+LRU::forEachBlk(CacheBlkVisitor &visitor)
+{
+    for (unsigned i = 0; i < numBlocks; ++i)
+        visitor.visit(blks[i]);
+}
+
 void
 LRU::cleanupRefs()
 {
@@ -236,3 +244,59 @@ LRU::cleanupRefs()
         }
     }
 }
+
+void
+LRU::serialize(ostream &os)
+{
+    string filename = name() + ".tags";
+    unsigned num_sets = numSets;
+    unsigned blk_size = blkSize;
+    unsigned ways = assoc;
+
+    SERIALIZE_SCALAR(filename);
+    SERIALIZE_SCALAR(num_sets);
+    SERIALIZE_SCALAR(blk_size);
+    SERIALIZE_SCALAR(ways);
+
+    // Write every set in MRU to LRU order, so the position of a block
+    // in the file is its position in the LRU stack
+    gzFile file = cptOpen(Checkpoint::dir() + "/" + filename, true);
+    for (unsigned i = 0; i < numSets; ++i) {
+        for (unsigned j = 0; j < assoc; ++j)
+            serializeBlk(file, sets[i].blks[j], blkSize);
+    }
+    cptClose(file);
+}
+
+void
+LRU::unserialize(Checkpoint *cp, const string &section)
+{
+    string filename;
+    unsigned num_sets;
+    unsigned blk_size;
+    unsigned ways;
+
+    UNSERIALIZE_SCALAR(filename);
+    UNSERIALIZE_SCALAR(num_sets);
+    UNSERIALIZE_SCALAR(blk_size);
+    UNSERIALIZE_SCALAR(ways);
+
+    if (num_sets != numSets || blk_size != blkSize || ways != assoc)
+        fatal("%s: cache geometry changed since the checkpoint (%d sets, "
+              "%d byte blocks, %d ways)\n", name(), num_sets, blk_size, ways);
+
+    gzFile file = cptOpen(cp->cptDir + "/" + filename, false);
+    for (unsigned i = 0; i < numSets; ++i) {
+        for (unsigned j = 0; j < assoc; ++j) {
+            BlkType *blk = &blks[i * assoc + j];
+            unserializeBlk(file, blk, blkSize);
+            sets[i].blks[j] = blk;
+
+            if (blk->isValid()) {
+                tagsInUse++;
+                occupancies[blk->srcMasterId]++;
+            }
+        }
+    }
+    cptClose(file);
+}
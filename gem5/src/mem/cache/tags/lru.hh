@@ -45,6 +45,7 @@
 #include "mem/packet.hh"
 
 class BaseCache;
+class Checkpoint;
 class CacheSet;
 
 
@@ -231,10 +232,28 @@ public:
      */
     virtual void clearLocks();
 
+    /**
+     * Apply a visitor to every block in the tag store.
+     * @param visitor The visitor to apply.
+     */
+    virtual void forEachBlk(CacheBlkVisitor &visitor);
+
     /**
      * Called at end of simulation to complete average block reference stats.
      */
     virtual void cleanupRefs();
+
+    /**
+     * Checkpoint the tags, data and LRU order of every set.
+     * @param os The checkpoint stream.
+     */
+    void serialize(std::ostream &os);
+
+    /**
+     * Restore the tag store from a checkpoint. The cache geometry
+     * must be the same as when the checkpoint was taken.
+     */
+    void unserialize(Checkpoint *cp, const std::string &section);
 };
 
 #endif // __MEM_CACHE_TAGS_LRU_HH__
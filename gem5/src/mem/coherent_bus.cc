@@ -56,7 +56,8 @@
 CoherentBus::CoherentBus(const CoherentBusParams *p)
     : BaseBus(p), reqLayer(*this, ".reqLayer", p->clock),
       respLayer(*this, ".respLayer", p->clock),
-      snoopRespLayer(*this, ".snoopRespLayer", p->clock)
+      snoopRespLayer(*this, ".snoopRespLayer", p->clock),
+      useSnoopFilter(p->snoop_filter)
 {
     // create the ports based on the size of the master and slave
     // vector ports, and the presence of the default port, the ports
@@ -104,6 +105,28 @@ CoherentBus::init()
 
     if (snoopPorts.empty())
         warn("CoherentBus %s has no snooping ports attached!\n", name());
+
+    if (useSnoopFilter) {
+        if (slavePorts.size() > SnoopFilter::MaxPorts)
+            fatal("CoherentBus %s has %d slave ports, the snoop filter "
+                  "supports at most %d\n", name(), slavePorts.size(),
+                  SnoopFilter::MaxPorts);
+        snoopFilter.setBlockSize(findBlockSize());
+    }
+}
+
+void
+CoherentBus::loadState(Checkpoint *cp)
+{
+    BaseBus::loadState(cp);
+
+    if (useSnoopFilter) {
+        uint64_t snoopers = 0;
+        for (SlavePortConstIter p = snoopPorts.begin();
+             p != snoopPorts.end(); ++p)
+            snoopers |= SnoopFilter::portBit((*p)->getId());
+        snoopFilter.assumeHolders(snoopers);
+    }
 }
 
 bool
@@ -138,6 +161,7 @@ CoherentBus::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
         // the packet is a memory-mapped request and should be
         // broadcasted to our snoopers but the source
         forwardTiming(pkt, slave_port_id);
+        updateSnoopFilter(pkt, slave_port_id);
     }
 
     // remember if we add an outstanding req so we can undo it if
@@ -180,6 +204,15 @@ CoherentBus::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
             // update the bus state and schedule an idle event
             reqLayer.failedTiming(src_port, headerFinishTime);
         } else {
+            // the requester is about to get a copy, so it has to
+            // see any snoops for the block until the response has
+            // made it back through the bus
+            if (useSnoopFilter && add_outstanding &&
+                !pkt->req->isUncacheable())
+                snoopFilter.addPending(pkt->req,
+                                       snoopFilter.blockAlign(pkt->getAddr()),
+                                       slave_port_id);
+
             // update the bus state and schedule an idle event
             reqLayer.succeededTiming(packetFinishTime);
         }
@@ -214,6 +247,8 @@ CoherentBus::recvTimingResp(PacketPtr pkt, PortID master_port_id)
 
     // remove it as outstanding
     outstandingReq.erase(pkt->req);
+    if (useSnoopFilter)
+        snoopFilter.removePending(pkt->req);
 
     // send the packet to the destination through one of our slave
     // ports, as determined by the destination field
@@ -243,6 +278,7 @@ CoherentBus::recvTimingSnoopReq(PacketPtr pkt, PortID master_port_id)
 
     // forward to all snoopers
     forwardTiming(pkt, InvalidPortID);
+    updateSnoopFilter(pkt, InvalidPortID);
 
     // a snoop request came from a connected slave device (one of
     // our master ports), and if it is not coming from the slave
@@ -294,6 +330,8 @@ CoherentBus::recvTimingSnoopResp(PacketPtr pkt, PortID slave_port_id)
         // since we created the snoop request as part of
         // recvTiming, this should now be a normal response again
         outstandingReq.erase(pkt->req);
+        if (useSnoopFilter)
+            snoopFilter.removePending(pkt->req);
 
         // this is a snoop response from a coherent master, with a
         // destination field set on its way through the bus as
@@ -320,14 +358,17 @@ CoherentBus::recvTimingSnoopResp(PacketPtr pkt, PortID slave_port_id)
 void
 CoherentBus::forwardTiming(PacketPtr pkt, PortID exclude_slave_port_id)
 {
+    uint64_t holders = snoopHolders(pkt);
+
     for (SlavePortIter s = snoopPorts.begin(); s != snoopPorts.end(); ++s) {
         SlavePort *p = *s;
         // we could have gotten this request from a snooping master
         // (corresponding to our own slave port that is also in
         // snoopPorts) and should not send it back to where it came
         // from
-        if (exclude_slave_port_id == InvalidPortID ||
-            p->getId() != exclude_slave_port_id) {
+        if ((exclude_slave_port_id == InvalidPortID ||
+             p->getId() != exclude_slave_port_id) &&
+            snoopTarget(holders, p->getId())) {
             // cache is not allowed to refuse snoop
             p->sendTimingSnoopReq(pkt);
         }
@@ -360,6 +401,7 @@ CoherentBus::recvAtomic(PacketPtr pkt, PortID slave_port_id)
             forwardAtomic(pkt, slave_port_id);
         snoop_response_cmd = snoop_result.first;
         snoop_response_latency = snoop_result.second;
+        updateSnoopFilter(pkt, slave_port_id);
     }
 
     // even if we had a snoop response, we must continue and also
@@ -393,6 +435,7 @@ CoherentBus::recvAtomicSnoop(PacketPtr pkt, PortID master_port_id)
         forwardAtomic(pkt, InvalidPortID);
     MemCmd snoop_response_cmd = snoop_result.first;
     Tick snoop_response_latency = snoop_result.second;
+    updateSnoopFilter(pkt, InvalidPortID);
 
     if (snoop_response_cmd != MemCmd::InvalidCmd)
         pkt->cmd = snoop_response_cmd;
@@ -410,6 +453,7 @@ CoherentBus::forwardAtomic(PacketPtr pkt, PortID exclude_slave_port_id)
     MemCmd orig_cmd = pkt->cmd;
     MemCmd snoop_response_cmd = MemCmd::InvalidCmd;
     Tick snoop_response_latency = 0;
+    uint64_t holders = snoopHolders(pkt);
 
     for (SlavePortIter s = snoopPorts.begin(); s != snoopPorts.end(); ++s) {
         SlavePort *p = *s;
@@ -417,8 +461,9 @@ CoherentBus::forwardAtomic(PacketPtr pkt, PortID exclude_slave_port_id)
         // (corresponding to our own slave port that is also in
         // snoopPorts) and should not send it back to where it came
         // from
-        if (exclude_slave_port_id == InvalidPortID ||
-            p->getId() != exclude_slave_port_id) {
+        if ((exclude_slave_port_id == InvalidPortID ||
+             p->getId() != exclude_slave_port_id) &&
+            snoopTarget(holders, p->getId())) {
             Tick latency = p->sendAtomicSnoop(pkt);
             // in contrast to a functional access, we have to keep on
             // going as all snoopers must be updated even if we get a
@@ -443,6 +488,29 @@ CoherentBus::forwardAtomic(PacketPtr pkt, PortID exclude_slave_port_id)
     return std::make_pair(snoop_response_cmd, snoop_response_latency);
 }
 
+void
+CoherentBus::updateSnoopFilter(PacketPtr pkt, PortID slave_port_id)
+{
+    if (!useSnoopFilter)
+        return;
+
+    Addr blk_addr = snoopFilter.blockAlign(pkt->getAddr());
+    uint64_t requester = slave_port_id == InvalidPortID ? 0 :
+        SnoopFilter::portBit(slave_port_id);
+
+    if (pkt->isInvalidate()) {
+        // all the holders but the requester have now seen the
+        // invalidation and dropped their copies
+        DPRINTF(CoherentBus, "snoop filter: invalidate 0x%x\n", blk_addr);
+        snoopFilter.invalidate(blk_addr, requester);
+    } else if (requester && !pkt->isExpressSnoop()) {
+        // the requester may end up with a copy of the block, in
+        // timing mode it also stays pending until the response is
+        // back to survive any invalidations in the meantime
+        snoopFilter.addHolder(blk_addr, slave_port_id);
+    }
+}
+
 void
 CoherentBus::recvFunctional(PacketPtr pkt, PortID slave_port_id)
 {
@@ -52,6 +52,7 @@
 #define __MEM_COHERENT_BUS_HH__
 
 #include "mem/bus.hh"
+#include "mem/snoop_filter.hh"
 #include "params/CoherentBus.hh"
 
 /**
@@ -224,6 +225,48 @@ class CoherentBus : public BaseBus
      */
     std::set<RequestPtr> outstandingReq;
 
+    /** Only forward snoops to the ports the filter says may hold a
+        copy of the block. */
+    const bool useSnoopFilter;
+
+    /** Track the potential holders of each block above the bus. */
+    SnoopFilter snoopFilter;
+
+    /**
+     * Determine if a snooping slave port has to see a snoop.
+     *
+     * @param holders Potential holders according to the snoop filter
+     * @param slave_port_id Id of the snooping slave port
+     */
+    bool
+    snoopTarget(uint64_t holders, PortID slave_port_id) const
+    {
+        return !useSnoopFilter ||
+            (holders & SnoopFilter::portBit(slave_port_id));
+    }
+
+    /**
+     * Get the potential holders of the block a packet refers to, or
+     * zero if the bus does not filter its snoops.
+     */
+    uint64_t
+    snoopHolders(PacketPtr pkt) const
+    {
+        return useSnoopFilter ?
+            snoopFilter.lookup(snoopFilter.blockAlign(pkt->getAddr())) : 0;
+    }
+
+    /**
+     * Update the snoop filter once a request from one of our slave
+     * ports, or a snoop from one of our master ports, has been
+     * snooped by the holders of the block.
+     *
+     * @param pkt Packet that was snooped
+     * @param slave_port_id Id of the requesting slave port, or
+     *                      InvalidPortID for snoops from below
+     */
+    void updateSnoopFilter(PacketPtr pkt, PortID slave_port_id);
+
     /** Function called by the port when the bus is recieving a Timing
       request packet.*/
     virtual bool recvTimingReq(PacketPtr pkt, PortID slave_port_id);
@@ -297,6 +340,13 @@ class CoherentBus : public BaseBus
 
     virtual void init();
 
+    /**
+     * The caches above may have restored their tags from the
+     * checkpoint, so the snoop filter has to assume that all the
+     * snooping ports hold any block it has not seen.
+     */
+    virtual void loadState(Checkpoint *cp);
+
     CoherentBus(const CoherentBusParams *p);
 
     unsigned int drain(Event *de);
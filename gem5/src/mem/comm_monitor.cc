@@ -38,14 +38,21 @@
  *          Andreas Hansson
  */
 
+#include "base/callback.hh"
+#include "base/intmath.hh"
+#include "base/output.hh"
 #include "debug/CommMonitor.hh"
 #include "mem/comm_monitor.hh"
+#include "sim/core.hh"
 #include "sim/stats.hh"
 
 CommMonitor::CommMonitor(Params* params)
     : MemObject(params),
       masterPort(name() + "-master", *this),
       slavePort(name() + "-slave", *this),
+      blockTrace(NULL),
+      blockTraceMask(~Addr(params->block_trace_size - 1)),
+      reuseDist(NULL),
       samplePeriodicEvent(this),
       samplePeriodTicks(params->sample_period),
       readAddrMask(params->read_addr_mask),
@@ -58,6 +65,26 @@ CommMonitor::CommMonitor(Params* params)
     DPRINTF(CommMonitor,
             "Created monitor %s with sample period %d ticks (%f s)\n",
             name(), samplePeriodTicks, samplePeriod);
+
+    if (params->block_trace != "") {
+        if (!isPowerOf2(params->block_trace_size))
+            fatal("Block trace size of %s must be a power of 2\n", name());
+        blockTrace = simout.create(params->block_trace, true);
+        blockTraceBuf.reserve(blockTraceBatch);
+        registerExitCallback(
+            new MakeCallback<CommMonitor,
+                             &CommMonitor::closeBlockTrace>(this));
+    }
+
+    if (!params->disable_reuse_dists)
+        reuseDist = new ReuseDistance(params->reuse_block_size,
+                                      params->reuse_sample_rate);
+}
+
+CommMonitor::~CommMonitor()
+{
+    closeBlockTrace();
+    delete reuseDist;
 }
 
 CommMonitor*
@@ -94,6 +121,42 @@ CommMonitor::getSlavePort(const std::string& if_name, int idx)
     }
 }
 
+void
+CommMonitor::flushBlockTrace()
+{
+    if (!blockTraceBuf.empty()) {
+        blockTrace->write((const char*)&blockTraceBuf[0],
+                          blockTraceBuf.size() * sizeof(uint64_t));
+        blockTraceBuf.clear();
+    }
+}
+
+void
+CommMonitor::closeBlockTrace()
+{
+    if (blockTrace) {
+        flushBlockTrace();
+        simout.close(blockTrace);
+        blockTrace = NULL;
+    }
+}
+
+void
+CommMonitor::profileReuse(Addr addr)
+{
+    double distance;
+    switch (reuseDist->access(addr, distance)) {
+      case ReuseDistance::Reuse:
+        stats.reuseDistHist.sample(distance);
+        break;
+      case ReuseDistance::Cold:
+        ++stats.coldRequests;
+        break;
+      case ReuseDistance::NotSampled:
+        break;
+    }
+}
+
 void
 CommMonitor::recvFunctional(PacketPtr pkt)
 {
@@ -109,6 +172,13 @@ CommMonitor::recvFunctionalSnoop(PacketPtr pkt)
 Tick
 CommMonitor::recvAtomic(PacketPtr pkt)
 {
+    if ((pkt->isRead() || pkt->isWrite()) && !pkt->req->isUncacheable()) {
+        if (blockTrace)
+            traceBlock(pkt->getAddr());
+        if (reuseDist)
+            profileReuse(pkt->getAddr());
+    }
+
     return masterPort.sendAtomic(pkt);
 }
 
@@ -132,6 +202,8 @@ CommMonitor::recvTimingReq(PacketPtr pkt)
     Addr addr = pkt->getAddr();
     bool needsResponse = pkt->needsResponse();
     bool memInhibitAsserted = pkt->memInhibitAsserted();
+    bool cacheableAccess = (isRead || isWrite) &&
+        !pkt->req->isUncacheable() && !pkt->isExpressSnoop();
     Packet::SenderState* senderState = pkt->senderState;
 
     // If a cache miss is served by a cache, a monitor near the memory
@@ -153,6 +225,13 @@ CommMonitor::recvTimingReq(PacketPtr pkt)
         pkt->senderState = senderState;
     }
 
+    if (successful && cacheableAccess) {
+        if (blockTrace)
+            traceBlock(addr);
+        if (reuseDist)
+            profileReuse(addr);
+    }
+
     if (successful && isRead) {
         DPRINTF(CommMonitor, "Forwarded read request\n");
 
@@ -493,6 +572,29 @@ CommMonitor::regStats()
         .name(name() + ".writeAddrDist")
         .desc("Write address distribution")
         .flags(stats.disableAddrDists ? nozero : pdf);
+
+    stats.reuseDistHist
+        .init(params()->reuse_dist_bins)
+        .name(name() + ".reuseDistHist")
+        .desc("Histogram of LRU stack distances of reused blocks (blocks)")
+        .flags(stats.disableReuseDists ? nozero : pdf);
+
+    stats.coldRequests
+        .name(name() + ".coldRequests")
+        .desc("Requests to blocks not accessed before")
+        .flags(nozero);
+
+    stats.reuseScale
+        .scalar(stats.reuseSampleScale)
+        .name(name() + ".reuseScale")
+        .desc("Requests represented by each sampled reuse request")
+        .flags(nozero);
+
+    stats.workingSetHist
+        .init(params()->working_set_bins)
+        .name(name() + ".workingSetHist")
+        .desc("Histogram of distinct blocks accessed per sample period")
+        .flags(stats.disableReuseDists ? nozero : pdf);
 }
 
 void
@@ -521,8 +623,14 @@ CommMonitor::samplePeriodic()
             stats.outstandingReadsHist.sample(stats.outstandingReadReqs);
             stats.outstandingWritesHist.sample(stats.outstandingWriteReqs);
         }
+
+        if (reuseDist)
+            stats.workingSetHist.sample(reuseDist->workingSet());
     }
 
+    if (reuseDist)
+        reuseDist->newPeriod();
+
     // reset the sampled values
     stats.readTrans = 0;
     stats.writeTrans = 0;
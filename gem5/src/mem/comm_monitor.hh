@@ -41,9 +41,12 @@
 #ifndef __MEM_COMM_MONITOR_HH__
 #define __MEM_COMM_MONITOR_HH__
 
+#include <vector>
+
 #include "base/statistics.hh"
 #include "base/time.hh"
 #include "mem/mem_object.hh"
+#include "mem/reuse_distance.hh"
 #include "params/CommMonitor.hh"
 
 /**
@@ -54,7 +57,8 @@
  * transactions, read/write burst lengths, read/write bandwidth,
  * outstanding read/write requests, read latency and inter transaction time
  * (read-read, write-write, read/write-read/write). Furthermore it allows
- * to capture the number of accesses to an address over time ("heat map").
+ * to capture the number of accesses to an address over time ("heat map"),
+ * and the LRU stack distances and working set of the blocks accessed.
  * All stats can be disabled from Python.
  */
 class CommMonitor : public MemObject
@@ -75,7 +79,7 @@ class CommMonitor : public MemObject
     CommMonitor(Params* params);
 
     /** Destructor */
-    ~CommMonitor() { }
+    ~CommMonitor();
 
     virtual MasterPort& getMasterPort(const std::string& if_name,
                                       int idx = -1);
@@ -281,6 +285,48 @@ class CommMonitor : public MemObject
 
     void periodicTraceDump();
 
+    /**
+     * Record the block address of a request in the block trace, if
+     * there is one.
+     *
+     * @param addr Address of the request
+     */
+    void
+    traceBlock(Addr addr)
+    {
+        blockTraceBuf.push_back(addr & blockTraceMask);
+        if (blockTraceBuf.size() == blockTraceBatch)
+            flushBlockTrace();
+    }
+
+    /** Write the buffered block addresses to the trace file */
+    void flushBlockTrace();
+
+    /** Flush and close the block trace at the end of simulation */
+    void closeBlockTrace();
+
+    /** Output stream of the block trace, or NULL if disabled */
+    std::ostream* blockTrace;
+
+    /** Mask to align the recorded addresses to a block */
+    const Addr blockTraceMask;
+
+    /** Addresses recorded but not yet written to the file */
+    std::vector<uint64_t> blockTraceBuf;
+
+    /** Number of addresses to buffer before writing them out */
+    static const size_t blockTraceBatch = 64 * 1024;
+
+    /**
+     * Record the reuse distance of a request in the histograms.
+     *
+     * @param addr Address of the request
+     */
+    void profileReuse(Addr addr);
+
+    /** Reuse distance tracker, or NULL if disabled */
+    ReuseDistance* reuseDist;
+
     /** Stats declarations, all in a struct for convenience. */
     struct MonitorStats
     {
@@ -385,6 +431,29 @@ class CommMonitor : public MemObject
          */
         Stats::SparseHistogram writeAddrDist;
 
+        /** Disable flag for reuse distance and working set histograms */
+        bool disableReuseDists;
+
+        /**
+         * Histogram of the LRU stack distances of requests to blocks
+         * that were accessed before, in blocks.
+         */
+        Stats::Histogram reuseDistHist;
+
+        /** Requests to blocks that were not accessed before. */
+        Stats::Scalar coldRequests;
+
+        /**
+         * Both the reuse distance histogram and the cold requests
+         * count only the sampled requests, so they add up to each
+         * other; multiply them by this to estimate all requests.
+         */
+        double reuseSampleScale;
+        Stats::Value reuseScale;
+
+        /** Histogram of the distinct blocks accessed per sample period */
+        Stats::Histogram workingSetHist;
+
         /**
          * Create the monitor stats and initialise all the members
          * that are not statistics themselves, but used to control the
@@ -401,7 +470,9 @@ class CommMonitor : public MemObject
             outstandingReadReqs(0), outstandingWriteReqs(0),
             disableTransactionHists(params->disable_transaction_hists),
             readTrans(0), writeTrans(0),
-            disableAddrDists(params->disable_addr_dists)
+            disableAddrDists(params->disable_addr_dists),
+            disableReuseDists(params->disable_reuse_dists),
+            reuseSampleScale(1.0 / params->reuse_sample_rate)
         { }
 
     };
@@ -169,6 +169,10 @@ MemCmd::commandInfo[] =
     /* Invalidation Request */
     { SET3(NeedsExclusive, IsInvalidate, IsRequest),
       InvalidCmd, "InvalidationReq" },
+    /* Memory writeback: functional write of the dirty data of a cache,
+     * which the caches below pass on to memory */
+    { SET4(IsWrite, IsRequest, NeedsResponse, HasData),
+      WriteResp, "MemWritebackReq" },
 };
 
 bool
@@ -128,6 +128,7 @@ class MemCmd
         PrintReq,       // Print state matching address
         FlushReq,      //request for a cache flush
         InvalidationReq,   // request for address to be invalidated from lsq
+        MemWritebackReq,   // functional write of dirty cache data to memory
         NUM_MEM_CMDS
     };
 
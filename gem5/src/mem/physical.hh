@@ -93,6 +93,17 @@ class PhysicalMemory
      */
     bool isMemAddr(Addr addr) const;
 
+    /**
+     * Like isMemAddr(), but without using or updating the range
+     * cache, so that several host threads can look up addresses at
+     * the same time.
+     *
+     * @param addr A physical address
+     * @return Whether the address corresponds to a memory
+     */
+    bool isMemAddrUncached(Addr addr) const
+    { return addrMap.find(addr) != addrMap.end(); }
+
     /**
      * Get the memory ranges for all memories that are to be reported
      * to the configuration table.
@@ -0,0 +1,139 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <utility>
+
+#include "base/intmath.hh"
+#include "base/misc.hh"
+#include "mem/reuse_distance.hh"
+
+using namespace std;
+
+// std::max() takes its arguments by reference
+const uint64_t ReuseDistance::MinCapacity;
+
+ReuseDistance::ReuseDistance(unsigned block_size, double sample_rate)
+    : sampleRate(sample_rate),
+      tree(MinCapacity + 1, 0), now(0), live(0), period(1),
+      periodBlocks(0)
+{
+    if (!isPowerOf2(block_size))
+        fatal("Reuse distance block size must be a power of 2\n");
+    if (sample_rate <= 0 || sample_rate > 1)
+        fatal("Reuse distance sample rate must be in (0, 1]\n");
+
+    blockShift = floorLog2(block_size);
+    sampleThreshold = (uint64_t)(sample_rate * (ULL(1) << SampleBits));
+}
+
+void
+ReuseDistance::add(uint64_t t, int delta)
+{
+    for (; t < tree.size(); t += t & -t)
+        tree[t] += delta;
+}
+
+uint64_t
+ReuseDistance::prefix(uint64_t t) const
+{
+    uint64_t sum = 0;
+    for (; t > 0; t -= t & -t)
+        sum += tree[t];
+    return sum;
+}
+
+ReuseDistance::Result
+ReuseDistance::access(Addr addr, double &distance)
+{
+    Addr block = addr >> blockShift;
+
+    // Sample by a hash of the block, so that a block is either always
+    // or never tracked
+    if (sampleRate < 1) {
+        uint64_t hash = block * ULL(0x9E3779B97F4A7C15);
+        if ((hash >> (64 - SampleBits)) >= sampleThreshold)
+            return NotSampled;
+    }
+
+    if (now + 1 >= tree.size())
+        compact();
+    uint64_t t = ++now;
+
+    pair<m5::hash_map<Addr, Entry>::iterator, bool> ins =
+        blocks.insert(make_pair(block, Entry()));
+    Entry &entry = ins.first->second;
+
+    Result result;
+    if (ins.second) {
+        live++;
+        periodBlocks++;
+        entry.period = period;
+        result = Cold;
+    } else {
+        // All marks are before t, so the ones after the previous
+        // access are the total less those up to it
+        distance = (live - prefix(entry.time)) * scale();
+        add(entry.time, -1);
+
+        if (entry.period != period) {
+            periodBlocks++;
+            entry.period = period;
+        }
+        result = Reuse;
+    }
+
+    entry.time = t;
+    add(t, 1);
+    return result;
+}
+
+void
+ReuseDistance::compact()
+{
+    vector<pair<uint64_t, Entry *> > order;
+    order.reserve(blocks.size());
+    m5::hash_map<Addr, Entry>::iterator i = blocks.begin();
+    for (; i != blocks.end(); ++i)
+        order.push_back(make_pair(i->second.time, &i->second));
+    sort(order.begin(), order.end());
+
+    for (uint64_t j = 0; j < order.size(); j++)
+        order[j].second->time = j + 1;
+    now = live;
+
+    // Leave as many free times as there are blocks, so that the next
+    // compaction is at least that many accesses away
+    uint64_t capacity = max(MinCapacity, 2 * live);
+    tree.assign(capacity + 1, 0);
+
+    // Times 1 to live are all marked; a node covers the times
+    // (t - lowbit(t), t]
+    for (uint64_t t = 1; t <= capacity; t++) {
+        uint64_t low = t - (t & -t);
+        if (low < live)
+            tree[t] = min(t, live) - low;
+    }
+}
@@ -0,0 +1,133 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_REUSE_DISTANCE_HH__
+#define __MEM_REUSE_DISTANCE_HH__
+
+#include <vector>
+
+#include "base/hashmap.hh"
+#include "base/types.hh"
+
+/**
+ * Computes the LRU stack (reuse) distance of a stream of block
+ * accesses: the number of distinct other blocks accessed since the
+ * previous access to the same block. A block hits in a fully
+ * associative LRU cache of n blocks exactly when its distance is
+ * below n.
+ *
+ * Each access is stamped with an increasing time, and a Fenwick tree
+ * over the times marks the most recent access of every block, so the
+ * distance is the number of marks after the block's previous access.
+ * Lookup and update are O(log n). When the times run out of the tree,
+ * the live ones are renumbered in order, which is amortised over at
+ * least as many accesses as there are blocks.
+ *
+ * With a sample rate below 1, only the blocks whose hashed address
+ * falls under the rate are tracked, and their distances are scaled up
+ * by the inverse of the rate (SHARDS, Waldspurger et al., FAST'15).
+ * The memory needed and the time spent shrink by the same factor.
+ *
+ * The number of distinct blocks accessed since newPeriod() is kept as
+ * well, as the working set of the period.
+ */
+class ReuseDistance
+{
+  public:
+    enum Result {
+        /** The block is not in the sampled set. */
+        NotSampled,
+        /** First access to the block. */
+        Cold,
+        /** The block was accessed before; the distance is set. */
+        Reuse
+    };
+
+    /**
+     * @param block_size Size of the blocks to track, a power of 2.
+     * @param sample_rate Fraction of the blocks to track, in (0, 1].
+     */
+    ReuseDistance(unsigned block_size, double sample_rate);
+
+    /**
+     * Record an access.
+     * @param addr Any address in the block.
+     * @param distance Set to the scaled distance of a reuse.
+     */
+    Result access(Addr addr, double &distance);
+
+    /** Accesses and blocks that are tracked stand for this many. */
+    double scale() const { return 1.0 / sampleRate; }
+
+    /** Scaled number of distinct blocks accessed in this period. */
+    double workingSet() const { return periodBlocks * scale(); }
+
+    /** Start a new working set period. */
+    void newPeriod() { period++; periodBlocks = 0; }
+
+  private:
+    struct Entry
+    {
+        /** Time of the last access. */
+        uint64_t time;
+        /** Period of the last access. */
+        uint64_t period;
+    };
+
+    /** Smallest number of times the tree can hold. */
+    static const uint64_t MinCapacity = 1 << 16;
+
+    /** Sampling threshold is compared with this many hash bits. */
+    static const unsigned SampleBits = 24;
+
+    /** Add to the mark count at time t. */
+    void add(uint64_t t, int delta);
+
+    /** Number of marks at times up to t. */
+    uint64_t prefix(uint64_t t) const;
+
+    /** Renumber the live times from 1 and resize the tree. */
+    void compact();
+
+    unsigned blockShift;
+    double sampleRate;
+    uint64_t sampleThreshold;
+
+    /** Fenwick tree, indexed from 1. */
+    std::vector<uint32_t> tree;
+
+    /** Last time handed out. */
+    uint64_t now;
+
+    /** Number of marks, one per tracked block. */
+    uint64_t live;
+
+    m5::hash_map<Addr, Entry> blocks;
+
+    uint64_t period;
+    uint64_t periodBlocks;
+};
+
+#endif //__MEM_REUSE_DISTANCE_HH__
@@ -229,7 +229,7 @@ MessageBuffer::enqueue(MsgPtr message, Time delta)
     // Schedule the wakeup
     if (m_consumer_ptr != NULL) {
         m_consumer_ptr->scheduleEventAbsolute(arrival_time);
-        m_consumer_ptr->storeEventInfo(m_vnet_id);
+        m_consumer_ptr->storeEventInfo(m_input_link_id, m_vnet_id);
     } else {
         panic("No consumer: %s name: %s\n", *this, m_name);
     }
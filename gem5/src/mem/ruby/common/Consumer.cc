@@ -39,6 +39,11 @@ Consumer::scheduleEvent(Time timeDelta)
 void
 Consumer::scheduleEventAbsolute(Time timeAbs)
 {
+    if (m_wakeup_owner != NULL) {
+        m_wakeup_owner->scheduleEventAbsolute(timeAbs);
+        return;
+    }
+
     Tick evt_time = g_system_ptr->clockPeriod() * timeAbs;
     if (!alreadyScheduled(evt_time)) {
         // This wakeup is not redundant
@@ -45,7 +45,8 @@ class Consumer
 {
   public:
     Consumer(EventManager *_em)
-        : m_last_scheduled_wakeup(0), m_last_wakeup(0), em(_em)
+        : m_last_scheduled_wakeup(0), m_last_wakeup(0), em(_em),
+          m_wakeup_owner(NULL)
     {
     }
 
@@ -55,7 +56,7 @@ class Consumer
 
     virtual void wakeup() = 0;
     virtual void print(std::ostream& out) const = 0;
-    virtual void storeEventInfo(int info) {}
+    virtual void storeEventInfo(int link, int vnet) {}
 
     const Tick&
     getLastScheduledWakeup() const
@@ -89,13 +90,18 @@ class Consumer
     }
 
     void scheduleEvent(Time timeDelta);
-    void scheduleEventAbsolute(Time timeAbs);
+    virtual void scheduleEventAbsolute(Time timeAbs);
+
+    // A consumer whose wakeup() is called by an owner, rather than
+    // from its own events, passes its wakeup requests on to the owner
+    void setWakeupOwner(Consumer *owner) { m_wakeup_owner = owner; }
 
   private:
     Tick m_last_scheduled_wakeup;
     std::set<Tick> m_scheduled_wakeups;
     Tick m_last_wakeup;
     EventManager *em;
+    Consumer *m_wakeup_owner;
 
     class ConsumerEvent : public Event
     {
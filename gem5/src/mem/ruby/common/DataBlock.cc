@@ -29,31 +29,80 @@
 #include "mem/ruby/common/DataBlock.hh"
 #include "mem/ruby/system/System.hh"
 
+__thread DataBlock::Payload *DataBlock::freePayloads = NULL;
+
+DataBlock::Payload *
+DataBlock::allocPayload()
+{
+    Payload *payload = freePayloads;
+    if (payload) {
+        freePayloads = payload->nextFree;
+    } else {
+        payload = (Payload *)new uint8_t[sizeof(Payload) +
+                                         RubySystem::getBlockSizeBytes()];
+    }
+    payload->refCount = 1;
+    return payload;
+}
+
+void
+DataBlock::freePayload(Payload *payload)
+{
+    payload->nextFree = freePayloads;
+    freePayloads = payload;
+}
+
 DataBlock::DataBlock(const DataBlock &cp)
 {
-    m_data = new uint8_t[RubySystem::getBlockSizeBytes()];
-    memcpy(m_data, cp.m_data, RubySystem::getBlockSizeBytes());
-    m_alloc = true;
+    if (cp.m_payload) {
+        // share the payload until one of the blocks is written
+        m_payload = cp.m_payload;
+        m_payload->refCount++;
+        m_data = cp.m_data;
+    } else {
+        m_payload = allocPayload();
+        m_data = m_payload->data();
+        memcpy(m_data, cp.m_data, RubySystem::getBlockSizeBytes());
+    }
 }
 
 void
 DataBlock::alloc()
 {
-    m_data = new uint8_t[RubySystem::getBlockSizeBytes()];
-    m_alloc = true;
+    m_payload = allocPayload();
+    m_data = m_payload->data();
     clear();
 }
 
+void
+DataBlock::release()
+{
+    if (m_payload && --m_payload->refCount == 0)
+        freePayload(m_payload);
+}
+
+void
+DataBlock::unshare()
+{
+    Payload *payload = allocPayload();
+    memcpy(payload->data(), m_data, RubySystem::getBlockSizeBytes());
+    m_payload->refCount--;
+    m_payload = payload;
+    m_data = payload->data();
+}
+
 void
 DataBlock::clear()
 {
+    makeWritable();
     memset(m_data, 0, RubySystem::getBlockSizeBytes());
 }
 
 bool
 DataBlock::equal(const DataBlock& obj) const
 {
-    return !memcmp(m_data, obj.m_data, RubySystem::getBlockSizeBytes());
+    return m_data == obj.m_data ||
+        !memcmp(m_data, obj.m_data, RubySystem::getBlockSizeBytes());
 }
 
 void
@@ -81,12 +130,23 @@ void
 DataBlock::setData(uint8_t *data, int offset, int len)
 {
     assert(offset + len <= RubySystem::getBlockSizeBytes());
+    makeWritable();
     memcpy(&m_data[offset], data, len);
 }
 
 DataBlock &
 DataBlock::operator=(const DataBlock & obj)
 {
-    memcpy(m_data, obj.m_data, RubySystem::getBlockSizeBytes());
+    if (m_payload && obj.m_payload) {
+        // both blocks own their data, so just share the payload
+        obj.m_payload->refCount++;
+        release();
+        m_payload = obj.m_payload;
+        m_data = obj.m_data;
+    } else {
+        // assigned storage has to be written in place
+        makeWritable();
+        memcpy(m_data, obj.m_data, RubySystem::getBlockSizeBytes());
+    }
     return *this;
 }
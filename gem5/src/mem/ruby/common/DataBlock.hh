@@ -35,6 +35,19 @@
 #include <iomanip>
 #include <iostream>
 
+/**
+ * A block of data, either owning its storage or, after assign(),
+ * aliasing storage that belongs to someone else (e.g. the backing
+ * store of a directory).
+ *
+ * Owned storage comes from a free list of block-sized payloads and is
+ * reference counted: copying a block, e.g. when a message is cloned
+ * for a multicast, only shares the payload, and the first write to a
+ * shared payload gives the writer a private copy. Each host thread
+ * has a free list of its own, but the reference counts are not
+ * atomic, so blocks must not be copied or written by the Garnet
+ * router threads.
+ */
 class DataBlock
 {
   public:
@@ -47,8 +60,7 @@ class DataBlock
 
     ~DataBlock()
     {
-        if (m_alloc)
-            delete [] m_data;
+        release();
     }
 
     DataBlock& operator=(const DataBlock& obj);
@@ -65,20 +77,55 @@ class DataBlock
     void print(std::ostream& out) const;
 
   private:
+    /** Header of an owned payload, the data follows it */
+    struct Payload
+    {
+        /** Number of blocks sharing the payload */
+        unsigned refCount;
+
+        /** Next payload on the free list */
+        Payload *nextFree;
+
+        uint8_t *data() { return (uint8_t *)(this + 1); }
+    };
+
     void alloc();
+
+    /** Drop the reference to an owned payload, if any */
+    void release();
+
+    /** Make sure the data can be written without affecting copies */
+    void makeWritable()
+    {
+        if (m_payload && m_payload->refCount > 1)
+            unshare();
+    }
+
+    /** Give this block a private copy of a shared payload */
+    void unshare();
+
+    static Payload *allocPayload();
+    static void freePayload(Payload *payload);
+
+    /**
+     * Payloads that are not in use by the calling thread, all of the
+     * current block size
+     */
+    static __thread Payload *freePayloads;
+
     uint8_t *m_data;
-    bool m_alloc;
+
+    /** The owned payload, NULL if m_data is assigned storage */
+    Payload *m_payload;
 };
 
 inline void
 DataBlock::assign(uint8_t *data)
 {
     assert(data != NULL);
-    if (m_alloc) {
-        delete [] m_data;
-    }
+    release();
     m_data = data;
-    m_alloc = false;
+    m_payload = NULL;
 }
 
 inline uint8_t
@@ -90,6 +137,7 @@ DataBlock::getByte(int whichByte) const
 inline void
 DataBlock::setByte(int whichByte, uint8_t data)
 {
+    makeWritable();
     m_data[whichByte] = data;
 }
 
@@ -0,0 +1,91 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_RUBY_COMMON_FREELIST_HH__
+#define __MEM_RUBY_COMMON_FREELIST_HH__
+
+#include <cstddef>
+#include <new>
+
+/**
+ * A free list of objects of a single type. Classes that are allocated
+ * and freed at a high rate, such as the messages generated by SLICC,
+ * route their operator new and delete through it so that the storage
+ * of dead objects is recycled instead of going back to the heap.
+ * Memory on the free list is never returned to the heap.
+ *
+ * Objects of a derived class, which have a different size, bypass
+ * the free list.
+ *
+ * Each host thread has a free list of its own, so the Garnet router
+ * threads (see GarnetNetwork_d) never race with the event queue
+ * thread on it. An object freed by a thread other than the one that
+ * allocated it simply joins the list of the thread that frees it.
+ */
+template <class T>
+class FreeList
+{
+  public:
+    static void *
+    allocate(size_t size)
+    {
+        if (size != sizeof(T) || !freeHead)
+            return ::operator new(size);
+
+        Node *node = freeHead;
+        freeHead = node->next;
+        return node;
+    }
+
+    static void
+    release(void *p, size_t size)
+    {
+        if (!p)
+            return;
+
+        if (size != sizeof(T)) {
+            ::operator delete(p);
+            return;
+        }
+
+        Node *node = static_cast<Node *>(p);
+        node->next = freeHead;
+        freeHead = node;
+    }
+
+  private:
+    struct Node
+    {
+        Node *next;
+    };
+
+    /** Head of the calling thread's free list */
+    static __thread Node *freeHead;
+};
+
+template <class T>
+__thread typename FreeList<T>::Node *FreeList<T>::freeHead = NULL;
+
+#endif // __MEM_RUBY_COMMON_FREELIST_HH__
@@ -45,8 +45,7 @@ NetDest::add(MachineID newElement)
 void
 NetDest::addNetDest(const NetDest& netDest)
 {
-    assert(m_bits.size() == netDest.getSize());
-    for (int i = 0; i < m_bits.size(); i++) {
+    for (int i = 0; i < MachineType_NUM; i++) {
         m_bits[i].addSet(netDest.m_bits[i]);
     }
 }
@@ -54,7 +53,7 @@ NetDest::addNetDest(const NetDest& netDest)
 void
 NetDest::addRandom()
 {
-    int i = random()%m_bits.size();
+    int i = random()%MachineType_NUM;
     m_bits[i].addRandom();
 }
 
@@ -76,8 +75,7 @@ NetDest::remove(MachineID oldElement)
 void
 NetDest::removeNetDest(const NetDest& netDest)
 {
-    assert(m_bits.size() == netDest.getSize());
-    for (int i = 0; i < m_bits.size(); i++) {
+    for (int i = 0; i < MachineType_NUM; i++) {
         m_bits[i].removeSet(netDest.m_bits[i]);
     }
 }
@@ -85,7 +83,7 @@ NetDest::removeNetDest(const NetDest& netDest)
 void
 NetDest::clear()
 {
-    for (int i = 0; i < m_bits.size(); i++) {
+    for (int i = 0; i < MachineType_NUM; i++) {
         m_bits[i].clear();
     }
 }
@@ -114,22 +112,35 @@ NetDest::getAllDest()
 {
     std::vector<NodeID> dest;
     dest.clear();
-    for (int i = 0; i < m_bits.size(); i++) {
-        for (int j = 0; j < m_bits[i].getSize(); j++) {
-            if (m_bits[i].isElement(j)) {
-                int id = MachineType_base_number((MachineType)i) + j;
-                dest.push_back((NodeID)id);
-            }
+    for (int i = 0; i < MachineType_NUM; i++) {
+        const Set& set = m_bits[i];
+        for (NodeID j = set.nextElement(0); j < set.getSize();
+             j = set.nextElement(j + 1)) {
+            int id = MachineType_base_number((MachineType)i) + j;
+            dest.push_back((NodeID)id);
         }
     }
     return dest;
 }
 
+void
+NetDest::getAllDest(std::vector<MachineID>& dest) const
+{
+    for (int i = 0; i < MachineType_NUM; i++) {
+        const Set& set = m_bits[i];
+        for (NodeID j = set.nextElement(0); j < set.getSize();
+             j = set.nextElement(j + 1)) {
+            MachineID mach = {MachineType_from_base_level(i), j};
+            dest.push_back(mach);
+        }
+    }
+}
+
 int
 NetDest::count() const
 {
     int counter = 0;
-    for (int i = 0; i < m_bits.size(); i++) {
+    for (int i = 0; i < MachineType_NUM; i++) {
         counter += m_bits[i].count();
     }
     return counter;
@@ -144,13 +155,11 @@ NetDest::elementAt(MachineID index)
 MachineID
 NetDest::smallestElement() const
 {
-    assert(count() > 0);
-    for (int i = 0; i < m_bits.size(); i++) {
-        for (int j = 0; j < m_bits[i].getSize(); j++) {
-            if (m_bits[i].isElement(j)) {
-                MachineID mach = {MachineType_from_base_level(i), j};
-                return mach;
-            }
+    for (int i = 0; i < MachineType_NUM; i++) {
+        if (!m_bits[i].isEmpty()) {
+            MachineID mach = {MachineType_from_base_level(i),
+                              m_bits[i].smallestElement()};
+            return mach;
         }
     }
     panic("No smallest element of an empty set.");
@@ -159,12 +168,11 @@ NetDest::smallestElement() const
 MachineID
 NetDest::smallestElement(MachineType machine) const
 {
-    int size = m_bits[MachineType_base_level(machine)].getSize();
-    for (int j = 0; j < size; j++) {
-        if (m_bits[MachineType_base_level(machine)].isElement(j)) {
-            MachineID mach = {machine, j};
-            return mach;
-        }
+    const Set& set = m_bits[MachineType_base_level(machine)];
+    NodeID j = set.nextElement(0);
+    if (j < set.getSize()) {
+        MachineID mach = {machine, j};
+        return mach;
     }
 
     panic("No smallest element of given MachineType.");
@@ -174,7 +182,7 @@ NetDest::smallestElement(MachineType machine) const
 bool
 NetDest::isBroadcast() const
 {
-    for (int i = 0; i < m_bits.size(); i++) {
+    for (int i = 0; i < MachineType_NUM; i++) {
         if (!m_bits[i].isBroadcast()) {
             return false;
         }
@@ -186,7 +194,7 @@ NetDest::isBroadcast() const
 bool
 NetDest::isEmpty() const
 {
-    for (int i = 0; i < m_bits.size(); i++) {
+    for (int i = 0; i < MachineType_NUM; i++) {
         if (!m_bits[i].isEmpty()) {
             return false;
         }
@@ -198,9 +206,8 @@ NetDest::isEmpty() const
 NetDest
 NetDest::OR(const NetDest& orNetDest) const
 {
-    assert(m_bits.size() == orNetDest.getSize());
     NetDest result;
-    for (int i = 0; i < m_bits.size(); i++) {
+    for (int i = 0; i < MachineType_NUM; i++) {
         result.m_bits[i] = m_bits[i].OR(orNetDest.m_bits[i]);
     }
     return result;
@@ -210,9 +217,8 @@ NetDest::OR(const NetDest& orNetDest) const
 NetDest
 NetDest::AND(const NetDest& andNetDest) const
 {
-    assert(m_bits.size() == andNetDest.getSize());
     NetDest result;
-    for (int i = 0; i < m_bits.size(); i++) {
+    for (int i = 0; i < MachineType_NUM; i++) {
         result.m_bits[i] = m_bits[i].AND(andNetDest.m_bits[i]);
     }
     return result;
@@ -222,8 +228,7 @@ NetDest::AND(const NetDest& andNetDest) const
 bool
 NetDest::intersectionIsNotEmpty(const NetDest& other_netDest) const
 {
-    assert(m_bits.size() == other_netDest.getSize());
-    for (int i = 0; i < m_bits.size(); i++) {
+    for (int i = 0; i < MachineType_NUM; i++) {
         if (!m_bits[i].intersectionIsEmpty(other_netDest.m_bits[i])) {
             return true;
         }
@@ -234,9 +239,8 @@ NetDest::intersectionIsNotEmpty(const NetDest& other_netDest) const
 bool
 NetDest::isSuperset(const NetDest& test) const
 {
-    assert(m_bits.size() == test.getSize());
 
-    for (int i = 0; i < m_bits.size(); i++) {
+    for (int i = 0; i < MachineType_NUM; i++) {
         if (!m_bits[i].isSuperset(test.m_bits[i])) {
             return false;
         }
@@ -253,10 +257,9 @@ NetDest::isElement(MachineID element) const
 void
 NetDest::resize()
 {
-    m_bits.resize(MachineType_base_level(MachineType_NUM));
-    assert(m_bits.size() == MachineType_NUM);
+    assert(MachineType_base_level(MachineType_NUM) == MachineType_NUM);
 
-    for (int i = 0; i < m_bits.size(); i++) {
+    for (int i = 0; i < MachineType_NUM; i++) {
         m_bits[i].setSize(MachineType_base_count((MachineType)i));
     }
 }
@@ -264,9 +267,9 @@ NetDest::resize()
 void
 NetDest::print(std::ostream& out) const
 {
-    out << "[NetDest (" << m_bits.size() << ") ";
+    out << "[NetDest (" << MachineType_NUM << ") ";
 
-    for (int i = 0; i < m_bits.size(); i++) {
+    for (int i = 0; i < MachineType_NUM; i++) {
         for (int j = 0; j < m_bits[i].getSize(); j++) {
             out << (bool) m_bits[i].isElement(j) << " ";
         }
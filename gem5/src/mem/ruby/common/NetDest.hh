@@ -89,11 +89,14 @@ class NetDest
     // For Princeton Network
     std::vector<NodeID> getAllDest();
 
+    // Appends every member to dest in ascending order
+    void getAllDest(std::vector<MachineID>& dest) const;
+
     MachineID smallestElement() const;
     MachineID smallestElement(MachineType machine) const;
 
     void resize();
-    int getSize() const { return m_bits.size(); }
+    int getSize() const { return MachineType_NUM; }
 
     // get element for a index
     NodeID elementAt(MachineID index);
@@ -107,7 +110,7 @@ class NetDest
     vecIndex(MachineID m) const
     {
         int vec_index = MachineType_base_level(m.type);
-        assert(vec_index < m_bits.size());
+        assert(vec_index < MachineType_NUM);
         return vec_index;
     }
 
@@ -117,7 +120,9 @@ class NetDest
         return index;
     }
 
-    std::vector<Set> m_bits;  // a vector of bit vectors - i.e. Sets
+    // one bit vector - i.e. Set - per machine type, held inline so
+    // that building and copying destinations never allocates
+    Set m_bits[MachineType_NUM];
 };
 
 inline std::ostream&
@@ -37,15 +37,14 @@
 
 Set::Set()
 {
-    m_p_nArray = NULL;
     m_nArrayLen = 0;
     m_nSize = 0;
 }
 
 Set::Set(const Set& obj)
 {
-    m_p_nArray = NULL;
-    setSize(obj.m_nSize);
+    m_nSize = obj.m_nSize;
+    m_nArrayLen = obj.m_nArrayLen;
 
     // copy from the host to this array
     for (int i = 0; i < m_nArrayLen; i++)
@@ -54,52 +53,20 @@ Set::Set(const Set& obj)
 
 Set::Set(int size)
 {
-    m_p_nArray = NULL;
     m_nArrayLen = 0;
     m_nSize = 0;
     if (size > 0)
         setSize(size);
 }
 
-Set::~Set()
-{
-    if (m_p_nArray && m_p_nArray != &m_p_nArray_Static[0])
-        delete [] m_p_nArray;
-    m_p_nArray = NULL;
-}
-
 void
 Set::clearExcess()
 {
-    // now just ensure that no bits over the maximum size were set
-#ifdef _LP64
-    long mask = 0x7FFFFFFFFFFFFFFF;
-#else
-    long mask = 0x7FFFFFFF;
-#endif
-
-    // the number of populated spaces in the higest-order array slot
-    // is: m_nSize % LONG_BITS, so the uppermost LONG_BITS -
-    // m_nSize%64 bits should be cleared
-    if ((m_nSize % LONG_BITS) != 0) {
-        for (int j = 0; j < 64 - (m_nSize & INDEX_MASK); j++) {
-            m_p_nArray[m_nArrayLen - 1] &= mask;
-            mask = mask >> 1;
-        }
-    }
-}
-
-
-/*
- * This function should set all the bits in the current set that are
- * already set in the parameter set
- */
-void
-Set::addSet(const Set& set)
-{
-    assert(getSize()==set.getSize());
-    for (int i = 0; i < m_nArrayLen; i++)
-        m_p_nArray[i] |= set.m_p_nArray[i];
+    // now just ensure that no bits over the maximum size were set,
+    // the number of populated bits in the highest-order word is
+    // m_nSize % WORD_BITS
+    if ((m_nSize & INDEX_MASK) != 0)
+        m_p_nArray[m_nArrayLen - 1] &= (ULL(1) << (m_nSize & INDEX_MASK)) - 1;
 }
 
 /*
@@ -111,24 +78,14 @@ Set::addRandom()
 {
 
     for (int i = 0; i < m_nArrayLen; i++) {
-        // this ensures that all 32 bits are subject to random effects,
+        // this ensures that all bits are subject to random effects,
         // as RAND_MAX typically = 0x7FFFFFFF
-        m_p_nArray[i] |= random() ^ (random() << 4);
+        m_p_nArray[i] |= (uint64_t)random() ^
+            ((uint64_t)random() << 31) ^ ((uint64_t)random() << 62);
     }
     clearExcess();
 }
 
-/*
- * This function clears bits that are =1 in the parameter set
- */
-void
-Set::removeSet(const Set& set)
-{
-    assert(m_nSize == set.m_nSize);
-    for (int i = 0; i < m_nArrayLen; i++)
-        m_p_nArray[i] &= ~set.m_p_nArray[i];
-}
-
 /*
  * this function sets all bits in the set
  */
@@ -136,77 +93,43 @@ void
 Set::broadcast()
 {
     for (int i = 0; i < m_nArrayLen; i++)
-        m_p_nArray[i] = -1; // note that -1 corresponds to all 1's in 2's comp.
+        m_p_nArray[i] = ~ULL(0);
 
     clearExcess();
 }
 
-/*
- * This function returns the population count of 1's in the set
- */
-int
-Set::count() const
-{
-    int counter = 0;
-    long mask;
-
-    for (int i = 0; i < m_nArrayLen; i++) {
-        mask = (long)0x01;
-
-        for (int j = 0; j < LONG_BITS; j++) {
-            // FIXME - significant performance loss when array
-            // population << LONG_BITS
-            if ((m_p_nArray[i] & mask) != 0) {
-                counter++;
-            }
-            mask = mask << 1;
-        }
-    }
-
-    return counter;
-}
-
-/*
- * This function checks for set equality
- */
-bool
-Set::isEqual(const Set& set) const
-{
-    assert(m_nSize == set.m_nSize);
-
-    for (int i = 0; i < m_nArrayLen; i++)
-        if (m_p_nArray[i] != set.m_p_nArray[i])
-            return false;
-
-    return true;
-}
-
 /*
  * This function returns the NodeID (int) of the least set bit
  */
 NodeID
 Set::smallestElement() const
 {
-    assert(count() > 0);
-    long x;
     for (int i = 0; i < m_nArrayLen; i++) {
         if (m_p_nArray[i] != 0) {
             // the least-set bit must be in here
-            x = m_p_nArray[i];
+            return WORD_BITS * i + __builtin_ctzll(m_p_nArray[i]);
+        }
+    }
 
-            for (int j = 0; j < LONG_BITS; j++) {
-                if (x & (unsigned long)1) {
-                    return LONG_BITS * i + j;
-                }
+    panic("No smallest element of an empty set.");
+}
 
-                x = x >> 1;
-            }
+NodeID
+Set::nextElement(NodeID start) const
+{
+    if (start >= m_nSize)
+        return m_nSize;
 
-            panic("No smallest element of an empty set.");
-        }
+    int i = start >> INDEX_SHIFT;
+    uint64_t x = m_p_nArray[i] >> (start & INDEX_MASK) << (start & INDEX_MASK);
+    while (x == 0) {
+        if (++i >= m_nArrayLen)
+            return m_nSize;
+        x = m_p_nArray[i];
     }
 
-    panic("No smallest element of an empty set.");
+    NodeID element = WORD_BITS * i + __builtin_ctzll(x);
+    return element < m_nSize ? element : m_nSize;
 }
 
 /*
@@ -215,54 +138,31 @@ Set::smallestElement() const
 bool
 Set::isBroadcast() const
 {
-    // check the fully-loaded words by equal to 0xffffffff
-    // only the last word may not be fully loaded, it is not
-    // fully loaded iff m_nSize % 32 or 64 !=0 => fully loaded iff
-    // m_nSize % 32 or 64 == 0
-
-    int max = (m_nSize % LONG_BITS) == 0 ? m_nArrayLen : m_nArrayLen - 1;
-    for (int i = 0; i < max; i++) {
-        if (m_p_nArray[i] != -1) {
+    // only the last word may not be fully loaded, it is not fully
+    // loaded iff m_nSize % 64 != 0
+    int full = m_nSize >> INDEX_SHIFT;
+    for (int i = 0; i < full; i++) {
+        if (m_p_nArray[i] != ~ULL(0)) {
             return false;
         }
     }
 
     // now check the last word, which may not be fully loaded
-    long mask = 1;
-    for (int j = 0; j < (m_nSize % LONG_BITS); j++) {
-        if ((mask & m_p_nArray[m_nArrayLen-1]) == 0) {
+    if ((m_nSize & INDEX_MASK) != 0) {
+        uint64_t mask = (ULL(1) << (m_nSize & INDEX_MASK)) - 1;
+        if (m_p_nArray[full] != mask)
             return false;
-        }
-        mask = mask << 1;
     }
 
     return true;
 }
 
-/*
- * this function returns true iff no bits are set
- */
-bool
-Set::isEmpty() const
-{
-    // here we can simply check if all = 0, since we ensure
-    // that "extra slots" are all zero
-    for (int i = 0; i < m_nArrayLen ; i++)
-        if (m_p_nArray[i])
-            return false;
-
-    return true;
-}
-
 // returns the logical OR of "this" set and orSet
 Set
 Set::OR(const Set& orSet) const
 {
-    Set result(m_nSize);
-    assert(m_nSize == orSet.m_nSize);
-    for (int i = 0; i < m_nArrayLen; i++)
-        result.m_p_nArray[i] = m_p_nArray[i] | orSet.m_p_nArray[i];
-
+    Set result(*this);
+    result.addSet(orSet);
     return result;
 }
 
@@ -270,60 +170,26 @@ Set::OR(const Set& orSet) const
 Set
 Set::AND(const Set& andSet) const
 {
-    Set result(m_nSize);
+    Set result(*this);
     assert(m_nSize == andSet.m_nSize);
 
     for (int i = 0; i < m_nArrayLen; i++) {
-        result.m_p_nArray[i] = m_p_nArray[i] & andSet.m_p_nArray[i];
+        result.m_p_nArray[i] &= andSet.m_p_nArray[i];
     }
 
     return result;
 }
 
-/*
- * Returns false if a bit is set in the parameter set that is NOT set
- * in this set
- */
-bool
-Set::isSuperset(const Set& test) const
-{
-    assert(m_nSize == test.m_nSize);
-
-    for (int i = 0; i < m_nArrayLen; i++)
-        if (((test.m_p_nArray[i] & m_p_nArray[i]) | ~test.m_p_nArray[i]) != -1)
-            return false;
-
-    return true;
-}
-
 void
 Set::setSize(int size)
 {
+    if (size > NUMBER_WORDS_PER_SET * WORD_BITS)
+        fatal("Set of %d members exceeds the maximum of %d, increase "
+              "NUMBER_WORDS_PER_SET\n", size,
+              NUMBER_WORDS_PER_SET * WORD_BITS);
+
     m_nSize = size;
-    m_nArrayLen = (m_nSize + LONG_BITS - 1) / LONG_BITS;
-
-    // decide whether to use dynamic or static alloction
-    if (m_nArrayLen <= NUMBER_WORDS_PER_SET) {
-        // constant defined in RubySystem.hh
-        // its OK to use the static allocation, and it will
-        // probably be faster (as m_nArrayLen is already in the
-        // cache and they will probably share the same cache line)
-
-        // if switching from dyanamic to static allocation (which
-        // is probably rare, but why not be complete?), must delete
-        // the dynamically allocated space
-        if (m_p_nArray && m_p_nArray != &m_p_nArray_Static[0])
-            delete [] m_p_nArray;
-
-        m_p_nArray = &m_p_nArray_Static[0];
-    } else {
-        // can't use static allocation...simply not enough room
-        // so dynamically allocate some space
-        if (m_p_nArray && m_p_nArray != &m_p_nArray_Static[0])
-            delete [] m_p_nArray;
-
-        m_p_nArray = new long[m_nArrayLen];
-    }
+    m_nArrayLen = (m_nSize + WORD_BITS - 1) / WORD_BITS;
 
     clear();
 }
@@ -332,8 +198,8 @@ Set&
 Set::operator=(const Set& obj)
 {
     if (this != &obj) {
-        // resize this item
-        setSize(obj.getSize());
+        m_nSize = obj.m_nSize;
+        m_nArrayLen = obj.m_nArrayLen;
 
         // copy the elements from obj to this
         for (int i = 0; i < m_nArrayLen; i++)
@@ -346,7 +212,7 @@ Set::operator=(const Set& obj)
 void
 Set::print(std::ostream& out) const
 {
-    if (!m_p_nArray) {
+    if (!m_nArrayLen) {
         out << "[Set {Empty}]";
         return;
     }
@@ -26,48 +26,42 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
-// modified by Dan Gibson on 05/20/05 to accomidate FASTER
-// >32 set lengths, using an array of ints w/ 32 bits/int
+// The members are stored in a fixed array of NUMBER_WORDS_PER_SET
+// 64-bit words, so with the default of 4 words a set holds at most 256
+// members, and sizing a set any larger is fatal
 
 #ifndef __MEM_RUBY_COMMON_SET_HH__
 #define __MEM_RUBY_COMMON_SET_HH__
 
+#include <cassert>
 #include <iostream>
-#include <limits>
 
+#include "base/types.hh"
 #include "mem/ruby/common/TypeDefines.hh"
 
 /*
- * This defines the number of longs (32-bits on 32 bit machines,
- * 64-bit on 64-bit AMD machines) to use to hold the set...
- * the default is 4, allowing 128 or 256 different members
- * of the set.
- *
- * This should never need to be changed for correctness reasons,
- * though increasing it will increase performance for larger
- * set sizes at the cost of a (much) larger memory footprint
+ * This defines the number of 64-bit words held inline in every set,
+ * the default of 4 allows 256 different members of the set. Sets
+ * never allocate, so this bounds the largest set that can be built;
+ * raise it to 8 for systems with up to 512 nodes of one type.
  *
+ * Operations only touch the words covered by the size of the set, so
+ * a larger value costs memory but not time for small sets.
  */
-const int NUMBER_WORDS_PER_SET = 1;
+const int NUMBER_WORDS_PER_SET = 4;
 
 class Set
 {
   private:
     int m_nSize;              // the number of bits in this set
-    int m_nArrayLen;          // the number of 32-bit words that are
+    int m_nArrayLen;          // the number of 64-bit words that are
                               // held in the array
 
-    // Changed 5/24/05 for static allocation of array
-    // note that "long" corresponds to 32 bits on a 32-bit machine,
-    // 64 bits if the -m64 parameter is passed to g++, which it is
-    // for an AMD opteron under our configuration
-
-    long *m_p_nArray;      // an word array to hold the bits in the set
-    long m_p_nArray_Static[NUMBER_WORDS_PER_SET];
+    uint64_t m_p_nArray[NUMBER_WORDS_PER_SET]; // the bits in the set
 
-    static const int LONG_BITS = std::numeric_limits<long>::digits + 1;
-    static const int INDEX_SHIFT = LONG_BITS == 64 ? 6 : 5;
-    static const int INDEX_MASK = (1 << INDEX_SHIFT) - 1;
+    static const int WORD_BITS = 64;
+    static const int INDEX_SHIFT = 6;
+    static const int INDEX_MASK = WORD_BITS - 1;
 
     void clearExcess();
 
@@ -75,28 +69,38 @@ class Set
     Set();
     Set(int size);
     Set(const Set& obj);
-    ~Set();
 
     Set& operator=(const Set& obj);
 
     void
     add(NodeID index)
     {
-        m_p_nArray[index >> INDEX_SHIFT] |=
-            (((unsigned long) 1) << (index & INDEX_MASK));
+        m_p_nArray[index >> INDEX_SHIFT] |= ULL(1) << (index & INDEX_MASK);
+    }
+
+    void
+    addSet(const Set& set)
+    {
+        assert(m_nSize == set.m_nSize);
+        for (int i = 0; i < m_nArrayLen; i++)
+            m_p_nArray[i] |= set.m_p_nArray[i];
     }
 
-    void addSet(const Set& set);
     void addRandom();
 
     void
     remove(NodeID index)
     {
-        m_p_nArray[index >> INDEX_SHIFT] &=
-            ~(((unsigned long)1) << (index & INDEX_MASK));
+        m_p_nArray[index >> INDEX_SHIFT] &= ~(ULL(1) << (index & INDEX_MASK));
     }
 
-    void removeSet(const Set& set);
+    void
+    removeSet(const Set& set)
+    {
+        assert(m_nSize == set.m_nSize);
+        for (int i = 0; i < m_nArrayLen; i++)
+            m_p_nArray[i] &= ~set.m_p_nArray[i];
+    }
 
     void
     clear()
@@ -106,8 +110,25 @@ class Set
     }
 
     void broadcast();
-    int count() const;
-    bool isEqual(const Set& set) const;
+
+    int
+    count() const
+    {
+        int counter = 0;
+        for (int i = 0; i < m_nArrayLen; i++)
+            counter += __builtin_popcountll(m_p_nArray[i]);
+        return counter;
+    }
+
+    bool
+    isEqual(const Set& set) const
+    {
+        assert(m_nSize == set.m_nSize);
+        for (int i = 0; i < m_nArrayLen; i++)
+            if (m_p_nArray[i] != set.m_p_nArray[i])
+                return false;
+        return true;
+    }
 
     // return the logical OR of this set and orSet
     Set OR(const Set& orSet) const;
@@ -125,21 +146,44 @@ class Set
         return true;
     }
 
-    bool isSuperset(const Set& test) const;
+    bool
+    isSuperset(const Set& test) const
+    {
+        assert(m_nSize == test.m_nSize);
+        for (int i = 0; i < m_nArrayLen; i++)
+            if (test.m_p_nArray[i] & ~m_p_nArray[i])
+                return false;
+        return true;
+    }
+
     bool isSubset(const Set& test) const { return test.isSuperset(*this); }
 
     bool
     isElement(NodeID element) const
     {
-        return (m_p_nArray[element>>INDEX_SHIFT] &
-            (((unsigned long)1) << (element & INDEX_MASK))) != 0;
+        return (m_p_nArray[element >> INDEX_SHIFT] &
+                (ULL(1) << (element & INDEX_MASK))) != 0;
     }
 
     bool isBroadcast() const;
-    bool isEmpty() const;
+
+    bool
+    isEmpty() const
+    {
+        // here we can simply check if all = 0, since we ensure
+        // that "extra slots" are all zero
+        for (int i = 0; i < m_nArrayLen; i++)
+            if (m_p_nArray[i])
+                return false;
+        return true;
+    }
 
     NodeID smallestElement() const;
 
+    // Returns the smallest element >= start, or getSize() if there is
+    // none. Skips whole empty words, so walking a sparse set is cheap.
+    NodeID nextElement(NodeID start) const;
+
     void setSize(int size);
 
     NodeID
@@ -48,10 +48,15 @@ using namespace std;
 using m5::stl_helpers::deletePointers;
 
 GarnetNetwork_d::GarnetNetwork_d(const Params *p)
-    : BaseGarnetNetwork(p)
+    : BaseGarnetNetwork(p), Consumer(this)
 {
     m_buffers_per_data_vc = p->buffers_per_data_vc;
     m_buffers_per_ctrl_vc = p->buffers_per_ctrl_vc;
+    m_router_threads = p->router_threads;
+    m_evaluating_routers = false;
+    m_stop_router_threads = false;
+    m_cycle_start = NULL;
+    m_cycle_end = NULL;
 
     m_vnet_type.resize(m_virtual_networks);
     for (int i = 0; i < m_vnet_type.size(); i++) {
@@ -99,6 +104,25 @@ GarnetNetwork_d::init()
         net_link->init_net_ptr(this);
     }
 
+    if (m_router_threads > 0) {
+        for (int i = 0; i < m_router_ptr_vector.size(); i++)
+            m_router_ptr_vector[i]->enableParallelEval();
+
+        // This thread is the first of the router threads
+        int num_threads = m_router_threads;
+        m_cycle_start = new Barrier(num_threads);
+        m_cycle_end = new Barrier(num_threads);
+        m_threads.resize(num_threads - 1);
+        m_thread_args.resize(num_threads - 1);
+        for (int t = 0; t < num_threads - 1; t++) {
+            m_thread_args[t].network = this;
+            m_thread_args[t].tid = t + 1;
+            if (pthread_create(&m_threads[t], NULL, routerThreadMain,
+                               &m_thread_args[t]) != 0)
+                fatal("Could not create Garnet router thread\n");
+        }
+    }
+
     // FaultModel: declare each router to the fault model
     if(isFaultModelEnabled()){
         for (vector<Router_d*>::const_iterator i= m_router_ptr_vector.begin();
@@ -120,6 +144,15 @@ GarnetNetwork_d::init()
 
 GarnetNetwork_d::~GarnetNetwork_d()
 {
+    if (m_cycle_start != NULL) {
+        m_stop_router_threads = true;
+        m_cycle_start->wait();
+        for (int t = 0; t < m_threads.size(); t++)
+            pthread_join(m_threads[t], NULL);
+        delete m_cycle_start;
+        delete m_cycle_end;
+    }
+
     for (int i = 0; i < m_nodes; i++) {
         deletePointers(m_toNetQueues[i]);
         deletePointers(m_fromNetQueues[i]);
@@ -142,6 +175,66 @@ GarnetNetwork_d::reset()
     }
 }
 
+void *
+GarnetNetwork_d::routerThreadMain(void *arg)
+{
+    RouterThread *thread = (RouterThread *)arg;
+    GarnetNetwork_d *network = thread->network;
+
+    while (true) {
+        network->m_cycle_start->wait();
+        if (network->m_stop_router_threads)
+            return NULL;
+        network->evaluateRouters(thread->tid);
+        network->m_cycle_end->wait();
+    }
+}
+
+void
+GarnetNetwork_d::evaluateRouters(int tid)
+{
+    for (int i = tid; i < m_active_routers.size(); i += m_router_threads)
+        m_active_routers[i]->wakeup();
+}
+
+/*
+ * Routers only talk to each other through links, which take at least
+ * a cycle, so all routers with work in this cycle are evaluated
+ * concurrently. The links they fed are woken up once every router is
+ * done, and the routers' next wakeups are scheduled from here.
+ */
+void
+GarnetNetwork_d::wakeup()
+{
+    Time now = g_system_ptr->getTime();
+
+    m_active_routers.clear();
+    for (int i = 0; i < m_router_ptr_vector.size(); i++) {
+        if (m_router_ptr_vector[i]->popWakeup(now))
+            m_active_routers.push_back(m_router_ptr_vector[i]);
+    }
+
+    m_evaluating_routers = true;
+    if (m_active_routers.size() > 1 && !m_threads.empty()) {
+        m_cycle_start->wait();
+        evaluateRouters(0);
+        m_cycle_end->wait();
+    } else {
+        for (int i = 0; i < m_active_routers.size(); i++)
+            m_active_routers[i]->wakeup();
+    }
+    m_evaluating_routers = false;
+
+    for (int i = 0; i < m_active_routers.size(); i++) {
+        Router_d *router = m_active_routers[i];
+        router->flushLinkReqs();
+
+        Time next;
+        if (router->nextWakeup(next))
+            scheduleEventAbsolute(next);
+    }
+}
+
 /*
  * This function creates a link from the Network Interface (NI)
  * into the Network.
@@ -31,9 +31,13 @@
 #ifndef __MEM_RUBY_NETWORK_GARNET_FIXED_PIPELINE_GARNETNETWORK_D_HH__
 #define __MEM_RUBY_NETWORK_GARNET_FIXED_PIPELINE_GARNETNETWORK_D_HH__
 
+#include <pthread.h>
+
 #include <iostream>
 #include <vector>
 
+#include "base/barrier.hh"
+#include "mem/ruby/common/Consumer.hh"
 #include "mem/ruby/network/garnet/BaseGarnetNetwork.hh"
 #include "mem/ruby/network/garnet/NetworkHeader.hh"
 #include "mem/ruby/network/Network.hh"
@@ -48,7 +52,7 @@ class NetDest;
 class NetworkLink_d;
 class CreditLink_d;
 
-class GarnetNetwork_d : public BaseGarnetNetwork
+class GarnetNetwork_d : public BaseGarnetNetwork, public Consumer
 {
   public:
     typedef GarnetNetwork_dParams Params;
@@ -76,6 +80,14 @@ class GarnetNetwork_d : public BaseGarnetNetwork
 
     void reset();
 
+    // With router_threads set, the network evaluates the routers with
+    // work once per cycle, spread over that many host threads. The
+    // message and data block free lists are per thread, but data block
+    // reference counts are not atomic, so routers must only move flits
+    // and never copy messages or data blocks
+    void wakeup();
+    bool isEvaluatingRouters() { return m_evaluating_routers; }
+
     // Methods used by Topology to setup the network
     void makeOutLink(SwitchID src, NodeID dest, BasicLink* link, 
                      LinkDirection direction,
@@ -97,6 +109,15 @@ class GarnetNetwork_d : public BaseGarnetNetwork
     GarnetNetwork_d(const GarnetNetwork_d& obj);
     GarnetNetwork_d& operator=(const GarnetNetwork_d& obj);
 
+    struct RouterThread
+    {
+        GarnetNetwork_d *network;
+        int tid;
+    };
+
+    static void *routerThreadMain(void *arg);
+    void evaluateRouters(int tid);
+
     std::vector<VNET_type > m_vnet_type;
 
     std::vector<Router_d *> m_router_ptr_vector;   // All Routers in Network
@@ -106,6 +127,15 @@ class GarnetNetwork_d : public BaseGarnetNetwork
 
     int m_buffers_per_data_vc;
     int m_buffers_per_ctrl_vc;
+
+    int m_router_threads;
+    bool m_evaluating_routers;
+    bool m_stop_router_threads;
+    std::vector<Router_d *> m_active_routers;
+    std::vector<pthread_t> m_threads;
+    std::vector<RouterThread> m_thread_args;
+    Barrier *m_cycle_start;
+    Barrier *m_cycle_end;
 };
 
 inline std::ostream&
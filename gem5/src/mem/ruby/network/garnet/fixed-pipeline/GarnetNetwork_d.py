@@ -35,3 +35,5 @@ class GarnetNetwork_d(BaseGarnetNetwork):
     type = 'GarnetNetwork_d'
     buffers_per_data_vc = Param.Int(4, "buffers per data virtual channel");
     buffers_per_ctrl_vc = Param.Int(1, "buffers per ctrl virtual channel");
+    router_threads = Param.Unsigned(0, "host threads evaluating routers " \
+        "in parallel each cycle (0: one event per router stage)");
@@ -94,3 +94,11 @@ InputUnit_d::wakeup()
         m_num_buffer_reads[vnet]++;
     }
 }
+
+void
+InputUnit_d::increment_credit(int in_vc, bool free_signal)
+{
+    flit_d *t_flit = new flit_d(in_vc, free_signal);
+    creditQueue->insert(t_flit);
+    m_router->link_req(m_credit_link);
+}
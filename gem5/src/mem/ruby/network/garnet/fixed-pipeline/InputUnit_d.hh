@@ -85,13 +85,7 @@ class InputUnit_d : public Consumer
         return m_vcs[vc]->has_credits();
     }
 
-    inline void
-    increment_credit(int in_vc, bool free_signal)
-    {
-        flit_d *t_flit = new flit_d(in_vc, free_signal);
-        creditQueue->insert(t_flit);
-        m_credit_link->scheduleEvent(1);
-    }
+    void increment_credit(int in_vc, bool free_signal);
 
     inline int
     get_outvc(int invc)
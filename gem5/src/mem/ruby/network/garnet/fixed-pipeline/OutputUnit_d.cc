@@ -81,6 +81,13 @@ OutputUnit_d::wakeup()
     }
 }
 
+void
+OutputUnit_d::insert_flit(flit_d *t_flit)
+{
+    m_out_buffer->insert(t_flit);
+    m_router->link_req(m_out_link);
+}
+
 flitBuffer_d*
 OutputUnit_d::getOutQueue()
 {
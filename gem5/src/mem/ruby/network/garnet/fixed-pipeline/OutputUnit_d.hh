@@ -81,12 +81,7 @@ class OutputUnit_d : public Consumer
                                              g_system_ptr->getTime()));
     }
 
-    inline void
-    insert_flit(flit_d *t_flit)
-    {
-        m_out_buffer->insert(t_flit);
-        m_out_link->scheduleEvent(1);
-    }
+    void insert_flit(flit_d *t_flit);
 
   private:
     int m_id;
@@ -44,7 +44,7 @@ using namespace std;
 using m5::stl_helpers::deletePointers;
 
 Router_d::Router_d(const Params *p)
-    : BasicRouter(p)
+    : BasicRouter(p), Consumer(this)
 {
     m_virtual_networks = p->virt_nets;
     m_vc_per_vnet = p->vcs_per_vnet;
@@ -54,6 +54,7 @@ Router_d::Router_d(const Params *p)
     m_vc_alloc = new VCallocator_d(this);
     m_sw_alloc = new SWallocator_d(this);
     m_switch = new Switch_d(this);
+    m_parallel_eval = false;
 
     m_input_unit.clear();
     m_output_unit.clear();
@@ -144,6 +145,88 @@ Router_d::swarb_req()
     m_sw_alloc->scheduleEvent(1);
 }
 
+void
+Router_d::link_req(NetworkLink_d *link)
+{
+    // Links are shared with the neighbouring router, so while routers
+    // are being evaluated in parallel they are only woken up afterwards
+    if (m_parallel_eval)
+        m_link_reqs.push_back(link);
+    else
+        link->scheduleEvent(1);
+}
+
+void
+Router_d::enableParallelEval()
+{
+    m_parallel_eval = true;
+
+    for (int i = 0; i < m_input_unit.size(); i++)
+        m_input_unit[i]->setWakeupOwner(this);
+    for (int i = 0; i < m_output_unit.size(); i++)
+        m_output_unit[i]->setWakeupOwner(this);
+    m_vc_alloc->setWakeupOwner(this);
+    m_sw_alloc->setWakeupOwner(this);
+    m_switch->setWakeupOwner(this);
+}
+
+void
+Router_d::wakeup()
+{
+    assert(m_parallel_eval);
+
+    // Every stage only acts on flits and credits whose time has come,
+    // so running all of them on any cycle with work is safe
+    for (int i = 0; i < m_input_unit.size(); i++)
+        m_input_unit[i]->wakeup();
+    for (int i = 0; i < m_output_unit.size(); i++)
+        m_output_unit[i]->wakeup();
+    m_vc_alloc->wakeup();
+    m_sw_alloc->wakeup();
+    m_switch->wakeup();
+}
+
+void
+Router_d::scheduleEventAbsolute(Time timeAbs)
+{
+    assert(m_parallel_eval);
+
+    // Requests made from a router thread are picked up by the network
+    // after the cycle; others (e.g. a link delivering a flit) go
+    // straight to the network's event
+    m_wakeups.insert(timeAbs);
+    if (!m_network_ptr->isEvaluatingRouters())
+        m_network_ptr->scheduleEventAbsolute(timeAbs);
+}
+
+bool
+Router_d::popWakeup(Time time)
+{
+    if (m_wakeups.empty() || *m_wakeups.begin() > time)
+        return false;
+
+    m_wakeups.erase(m_wakeups.begin(), m_wakeups.upper_bound(time));
+    return true;
+}
+
+bool
+Router_d::nextWakeup(Time &time)
+{
+    if (m_wakeups.empty())
+        return false;
+
+    time = *m_wakeups.begin();
+    return true;
+}
+
+void
+Router_d::flushLinkReqs()
+{
+    for (int i = 0; i < m_link_reqs.size(); i++)
+        m_link_reqs[i]->scheduleEvent(1);
+    m_link_reqs.clear();
+}
+
 void
 Router_d::update_incredit(int in_port, int in_vc, int credit)
 {
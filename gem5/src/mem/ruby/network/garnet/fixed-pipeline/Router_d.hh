@@ -32,8 +32,10 @@
 #define __MEM_RUBY_NETWORK_GARNET_FIXED_PIPELINE_ROUTER_D_HH__
 
 #include <iostream>
+#include <set>
 #include <vector>
 
+#include "mem/ruby/common/Consumer.hh"
 #include "mem/ruby/common/NetDest.hh"
 #include "mem/ruby/network/BasicRouter.hh"
 #include "mem/ruby/network/garnet/fixed-pipeline/flit_d.hh"
@@ -52,7 +54,7 @@ class SWallocator_d;
 class Switch_d;
 class FaultModel;
 
-class Router_d : public BasicRouter
+class Router_d : public BasicRouter, public Consumer
 {
   public:
     typedef GarnetRouter_dParams Params;
@@ -86,6 +88,20 @@ class Router_d : public BasicRouter
     void route_req(flit_d *t_flit, InputUnit_d* in_unit, int invc);
     void vcarb_req();
     void swarb_req();
+    void link_req(NetworkLink_d *link);
+
+    // Parallel evaluation: the network calls wakeup() for every
+    // router with work in a cycle, each router on one host thread,
+    // and its units and allocators schedule wakeups with the router
+    void enableParallelEval();
+    bool isParallelEval() { return m_parallel_eval; }
+    void wakeup();
+    void scheduleEventAbsolute(Time timeAbs);
+    bool popWakeup(Time time);
+    bool nextWakeup(Time &time);
+    void flushLinkReqs();
+    void print(std::ostream& out) const { BasicRouter::print(out); }
+
     void printFaultVector(std::ostream& out);
     void printAggregateFaultProbability(std::ostream& out);
 
@@ -126,6 +142,11 @@ class Router_d : public BasicRouter
     double m_power_dyn;
     double m_power_sta;
     double m_clk_power;
+
+    bool m_parallel_eval;
+    std::set<Time> m_wakeups;
+    // Links to wake up once all routers have been evaluated
+    std::vector<NetworkLink_d *> m_link_reqs;
 };
 
 #endif // __MEM_RUBY_NETWORK_GARNET_FIXED_PIPELINE_ROUTER_D_HH__
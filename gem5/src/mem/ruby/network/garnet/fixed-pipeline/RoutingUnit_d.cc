@@ -65,9 +65,11 @@ RoutingUnit_d::RC_stage(flit_d *t_flit, InputUnit_d *in_unit, int invc)
 int
 RoutingUnit_d::routeCompute(flit_d *t_flit)
 {
-    MsgPtr msg_ptr = t_flit->get_msg_ptr();
+    // Other flits of this packet may be in other routers, so don't
+    // touch the message's reference count
+    const MsgPtr& msg_ptr = t_flit->get_msg_ptr();
     NetworkMessage* net_msg_ptr = safe_cast<NetworkMessage *>(msg_ptr.get());
-    NetDest msg_destination = net_msg_ptr->getInternalDestination();
+    const NetDest& msg_destination = net_msg_ptr->getInternalDestination();
 
     int output_link = -1;
     int min_weight = INFINITE_;
@@ -54,17 +54,14 @@ PerfectSwitch::PerfectSwitch(SwitchID sid, Switch *sw, uint32_t virt_nets)
     m_round_robin_start = 0;
     m_wakeups_wo_switch = 0;
     m_virtual_networks = virt_nets;
+    m_ready_ports.resize(virt_nets);
+    m_dest_map_valid = false;
 }
 
 void
 PerfectSwitch::init(SimpleNetwork *network_ptr)
 {
     m_network_ptr = network_ptr;
-
-    for(int i = 0;i < m_virtual_networks;++i)
-    {
-        m_pending_message_count.push_back(0);
-    }
 }
 
 void
@@ -74,6 +71,9 @@ PerfectSwitch::addInPort(const vector<MessageBuffer*>& in)
     NodeID port = m_in.size();
     m_in.push_back(in);
 
+    for (int j = 0; j < m_virtual_networks; j++)
+        m_ready_ports[j].resize(port / 64 + 1, 0);
+
     for (int j = 0; j < m_virtual_networks; j++) {
         m_in[port][j]->setConsumer(this);
         string desc = csprintf("[Queue from port %s %s %s to PerfectSwitch]",
@@ -99,12 +99,14 @@ PerfectSwitch::addOutPort(const vector<MessageBuffer*>& out,
     // Add to routing table
     m_out.push_back(out);
     m_routing_table.push_back(routing_table_entry);
+    m_dest_map_valid = false;
 }
 
 void
 PerfectSwitch::clearRoutingTables()
 {
     m_routing_table.clear();
+    m_dest_map_valid = false;
 }
 
 void
@@ -116,6 +118,10 @@ PerfectSwitch::clearBuffers()
         }
     }
 
+    for (int vnet = 0; vnet < m_virtual_networks; vnet++) {
+        fill(m_ready_ports[vnet].begin(), m_ready_ports[vnet].end(), 0);
+    }
+
     for (int i = 0; i < m_out.size(); i++){
         for(int vnet = 0; vnet < m_virtual_networks; vnet++) {
             m_out[i][vnet]->clear();
@@ -127,6 +133,7 @@ void
 PerfectSwitch::reconfigureOutPort(const NetDest& routing_table_entry)
 {
     m_routing_table.push_back(routing_table_entry);
+    m_dest_map_valid = false;
 }
 
 PerfectSwitch::~PerfectSwitch()
@@ -134,16 +141,52 @@ PerfectSwitch::~PerfectSwitch()
 }
 
 void
-PerfectSwitch::wakeup()
+PerfectSwitch::buildDestinationMap()
 {
-    MsgPtr msg_ptr;
+    assert(m_routing_table.size() == m_out.size());
+
+    m_dest_link.assign(MachineType_base_number(MachineType_NUM), -1);
+    for (MachineType type = MachineType_FIRST; type < MachineType_NUM;
+         ++type) {
+        int base = MachineType_base_number(type);
+        for (int num = 0; num < MachineType_base_count(type); num++) {
+            MachineID mach = {type, num};
+            for (int link = 0; link < m_routing_table.size(); link++) {
+                if (m_routing_table[link].isElement(mach)) {
+                    m_dest_link[base + num] = link;
+                    break;
+                }
+            }
+        }
+    }
 
+    m_link_slot.assign(m_out.size(), -1);
+    m_dest_map_valid = true;
+}
+
+int
+PerfectSwitch::findReadyPort(int vnet, int from, int to) const
+{
+    const vector<uint64_t>& ready = m_ready_ports[vnet];
+    while (from < to) {
+        uint64_t word = ready[from / 64] >> (from % 64);
+        if (word != 0) {
+            int port = from + __builtin_ctzll(word);
+            return port < to ? port : -1;
+        }
+        from = (from / 64 + 1) * 64;
+    }
+    return -1;
+}
+
+void
+PerfectSwitch::wakeup()
+{
     // Give the highest numbered link priority most of the time
     m_wakeups_wo_switch++;
     int highest_prio_vnet = m_virtual_networks-1;
     int lowest_prio_vnet = 0;
     int decrementer = 1;
-    NetworkMessage* net_msg_ptr = NULL;
 
     // invert priorities to avoid starvation seen in the component network
     if (m_wakeups_wo_switch > PRIORITY_SWITCH_LIMIT) {
@@ -153,6 +196,11 @@ PerfectSwitch::wakeup()
         decrementer = -1;
     }
 
+    if (!m_dest_map_valid)
+        buildDestinationMap();
+
+    int num_in = m_in.size();
+
     // For all components incoming queues
     for (int vnet = highest_prio_vnet;
          (vnet * decrementer) >= (decrementer * lowest_prio_vnet);
@@ -161,170 +209,214 @@ PerfectSwitch::wakeup()
         // This is for round-robin scheduling
         int incoming = m_round_robin_start;
         m_round_robin_start++;
-        if (m_round_robin_start >= m_in.size()) {
+        if (m_round_robin_start >= num_in) {
             m_round_robin_start = 0;
         }
 
-        if(m_pending_message_count[vnet] > 0) {
-            // for all input ports, use round robin scheduling
-            for (int counter = 0; counter < m_in.size(); counter++) {
-                // Round robin scheduling
-                incoming++;
-                if (incoming >= m_in.size()) {
-                    incoming = 0;
+        // Visit the input ports with pending messages in round robin
+        // order, starting just after 'incoming' and wrapping around
+        int first = incoming + 1 < num_in ? incoming + 1 : 0;
+        for (int port = findReadyPort(vnet, first, num_in); port >= 0;
+             port = findReadyPort(vnet, port + 1, num_in)) {
+            routePort(port, vnet);
+        }
+        for (int port = findReadyPort(vnet, 0, first); port >= 0;
+             port = findReadyPort(vnet, port + 1, first)) {
+            routePort(port, vnet);
+        }
+    }
+}
+
+void
+PerfectSwitch::routePort(int incoming, int vnet)
+{
+    MsgPtr msg_ptr;
+    NetworkMessage* net_msg_ptr = NULL;
+
+    // temporary vectors to store the routing results
+    vector<LinkID> output_links;
+    vector<NetDest> output_link_destinations;
+
+    // The link order only changes under adaptive routing on an
+    // unordered vnet; otherwise destinations map straight to links
+    bool fixed_order = !m_network_ptr->getAdaptiveRouting() ||
+        m_network_ptr->isVNetOrdered(vnet);
+
+    // Is there a message waiting?
+    while (m_in[incoming][vnet]->isReady()) {
+        DPRINTF(RubyNetwork, "incoming: %d\n", incoming);
+
+        // Peek at message
+        msg_ptr = m_in[incoming][vnet]->peekMsgPtr();
+        net_msg_ptr = safe_cast<NetworkMessage*>(msg_ptr.get());
+        DPRINTF(RubyNetwork, "Message: %s\n", (*net_msg_ptr));
+
+        output_links.clear();
+        output_link_destinations.clear();
+        const NetDest& msg_dsts = net_msg_ptr->getInternalDestination();
+
+        // Unfortunately, the token-protocol sends some
+        // zero-destination messages, so this assert isn't valid
+        // assert(msg_dsts.count() > 0);
+
+        assert(m_link_order.size() == m_routing_table.size());
+        assert(m_link_order.size() == m_out.size());
+
+        if (fixed_order) {
+            // Each destination goes to the first link whose routing
+            // table entry holds it, which is what the intersection
+            // loop below computes for the identity link order. The
+            // links are used in ascending order, as that loop does,
+            // which decides the order the copies are enqueued in.
+            m_dest_scratch.clear();
+            msg_dsts.getAllDest(m_dest_scratch);
+            for (int i = 0; i < m_dest_scratch.size(); i++) {
+                const MachineID& mach = m_dest_scratch[i];
+                int link = m_dest_link[MachineType_base_number(mach.type) +
+                                       mach.num];
+                assert(link >= 0);
+
+                if (m_link_slot[link] < 0) {
+                    m_link_slot[link] = 0;
+                    output_links.push_back(link);
                 }
+            }
+
+            sort(output_links.begin(), output_links.end());
+            for (int i = 0; i < output_links.size(); i++) {
+                m_link_slot[output_links[i]] = i;
+                output_link_destinations.push_back(NetDest());
+            }
 
-                // temporary vectors to store the routing results
-                vector<LinkID> output_links;
-                vector<NetDest> output_link_destinations;
-
-                // Is there a message waiting?
-                while (m_in[incoming][vnet]->isReady()) {
-                    DPRINTF(RubyNetwork, "incoming: %d\n", incoming);
-
-                    // Peek at message
-                    msg_ptr = m_in[incoming][vnet]->peekMsgPtr();
-                    net_msg_ptr = safe_cast<NetworkMessage*>(msg_ptr.get());
-                    DPRINTF(RubyNetwork, "Message: %s\n", (*net_msg_ptr));
-
-                    output_links.clear();
-                    output_link_destinations.clear();
-                    NetDest msg_dsts =
-                        net_msg_ptr->getInternalDestination();
-
-                    // Unfortunately, the token-protocol sends some
-                    // zero-destination messages, so this assert isn't valid
-                    // assert(msg_dsts.count() > 0);
-
-                    assert(m_link_order.size() == m_routing_table.size());
-                    assert(m_link_order.size() == m_out.size());
-
-                    if (m_network_ptr->getAdaptiveRouting()) {
-                        if (m_network_ptr->isVNetOrdered(vnet)) {
-                            // Don't adaptively route
-                            for (int out = 0; out < m_out.size(); out++) {
-                                m_link_order[out].m_link = out;
-                                m_link_order[out].m_value = 0;
-                            }
-                        } else {
-                            // Find how clogged each link is
-                            for (int out = 0; out < m_out.size(); out++) {
-                                int out_queue_length = 0;
-                                for (int v = 0; v < m_virtual_networks; v++) {
-                                    out_queue_length += m_out[out][v]->getSize();
-                                }
-                                int value =
-                                    (out_queue_length << 8) | (random() & 0xff);
-                                m_link_order[out].m_link = out;
-                                m_link_order[out].m_value = value;
-                            }
-
-                            // Look at the most empty link first
-                            sort(m_link_order.begin(), m_link_order.end());
-                        }
-                    }
-
-                    for (int i = 0; i < m_routing_table.size(); i++) {
-                        // pick the next link to look at
-                        int link = m_link_order[i].m_link;
-                        NetDest dst = m_routing_table[link];
-                        DPRINTF(RubyNetwork, "dst: %s\n", dst);
-
-                        if (!msg_dsts.intersectionIsNotEmpty(dst))
-                            continue;
-
-                        // Remember what link we're using
-                        output_links.push_back(link);
-
-                        // Need to remember which destinations need this
-                        // message in another vector.  This Set is the
-                        // intersection of the routing_table entry and the
-                        // current destination set.  The intersection must
-                        // not be empty, since we are inside "if"
-                        output_link_destinations.push_back(msg_dsts.AND(dst));
-
-                        // Next, we update the msg_destination not to
-                        // include those nodes that were already handled
-                        // by this link
-                        msg_dsts.removeNetDest(dst);
-                    }
-
-                    assert(msg_dsts.count() == 0);
-                    //assert(output_links.size() > 0);
-
-                    // Check for resources - for all outgoing queues
-                    bool enough = true;
-                    for (int i = 0; i < output_links.size(); i++) {
-                        int outgoing = output_links[i];
-                        if (!m_out[outgoing][vnet]->areNSlotsAvailable(1))
-                            enough = false;
-                        DPRINTF(RubyNetwork, "Checking if node is blocked ..."
-                                "outgoing: %d, vnet: %d, enough: %d\n",
-                                outgoing, vnet, enough);
-                    }
-
-                    // There were not enough resources
-                    if (!enough) {
-                        scheduleEvent(1);
-                        DPRINTF(RubyNetwork, "Can't deliver message since a node "
-                                "is blocked\n");
-                        DPRINTF(RubyNetwork, "Message: %s\n", (*net_msg_ptr));
-                        break; // go to next incoming port
-                    }
-
-                    MsgPtr unmodified_msg_ptr;
-
-                    if (output_links.size() > 1) {
-                        // If we are sending this message down more than
-                        // one link (size>1), we need to make a copy of
-                        // the message so each branch can have a different
-                        // internal destination we need to create an
-                        // unmodified MsgPtr because the MessageBuffer
-                        // enqueue func will modify the message
-
-                        // This magic line creates a private copy of the
-                        // message
-                        unmodified_msg_ptr = msg_ptr->clone();
-                    }
-
-                    // Enqueue it - for all outgoing queues
-                    for (int i=0; i<output_links.size(); i++) {
-                        int outgoing = output_links[i];
-
-                        if (i > 0) {
-                            // create a private copy of the unmodified
-                            // message
-                            msg_ptr = unmodified_msg_ptr->clone();
-                        }
-
-                        // Change the internal destination set of the
-                        // message so it knows which destinations this
-                        // link is responsible for.
-                        net_msg_ptr = safe_cast<NetworkMessage*>(msg_ptr.get());
-                        net_msg_ptr->getInternalDestination() =
-                            output_link_destinations[i];
-
-                        // Enqeue msg
-                        DPRINTF(RubyNetwork, "Enqueuing net msg from "
-                                "inport[%d][%d] to outport [%d][%d].\n",
-                                incoming, vnet, outgoing, vnet);
-
-                        m_out[outgoing][vnet]->enqueue(msg_ptr);
-                    }
-
-                    // Dequeue msg
-                    m_in[incoming][vnet]->pop();
-                    m_pending_message_count[vnet]--;
+            for (int i = 0; i < m_dest_scratch.size(); i++) {
+                const MachineID& mach = m_dest_scratch[i];
+                int link = m_dest_link[MachineType_base_number(mach.type) +
+                                       mach.num];
+                output_link_destinations[m_link_slot[link]].add(mach);
+            }
+
+            for (int i = 0; i < output_links.size(); i++)
+                m_link_slot[output_links[i]] = -1;
+        } else {
+            // Find how clogged each link is
+            for (int out = 0; out < m_out.size(); out++) {
+                int out_queue_length = 0;
+                for (int v = 0; v < m_virtual_networks; v++) {
+                    out_queue_length += m_out[out][v]->getSize();
                 }
+                int value =
+                    (out_queue_length << 8) | (random() & 0xff);
+                m_link_order[out].m_link = out;
+                m_link_order[out].m_value = value;
+            }
+
+            // Look at the most empty link first
+            sort(m_link_order.begin(), m_link_order.end());
+
+            NetDest remaining = msg_dsts;
+            for (int i = 0; i < m_routing_table.size(); i++) {
+                // pick the next link to look at
+                int link = m_link_order[i].m_link;
+                const NetDest& dst = m_routing_table[link];
+                DPRINTF(RubyNetwork, "dst: %s\n", dst);
+
+                if (!remaining.intersectionIsNotEmpty(dst))
+                    continue;
+
+                // Remember what link we're using
+                output_links.push_back(link);
+
+                // Need to remember which destinations need this
+                // message in another vector.  This Set is the
+                // intersection of the routing_table entry and the
+                // current destination set.  The intersection must
+                // not be empty, since we are inside "if"
+                output_link_destinations.push_back(remaining.AND(dst));
+
+                // Next, we update the msg_destination not to
+                // include those nodes that were already handled
+                // by this link
+                remaining.removeNetDest(dst);
             }
+
+            assert(remaining.count() == 0);
+        }
+        //assert(output_links.size() > 0);
+
+        // Check for resources - for all outgoing queues
+        bool enough = true;
+        for (int i = 0; i < output_links.size(); i++) {
+            int outgoing = output_links[i];
+            if (!m_out[outgoing][vnet]->areNSlotsAvailable(1))
+                enough = false;
+            DPRINTF(RubyNetwork, "Checking if node is blocked ..."
+                    "outgoing: %d, vnet: %d, enough: %d\n",
+                    outgoing, vnet, enough);
         }
+
+        // There were not enough resources
+        if (!enough) {
+            scheduleEvent(1);
+            DPRINTF(RubyNetwork, "Can't deliver message since a node "
+                    "is blocked\n");
+            DPRINTF(RubyNetwork, "Message: %s\n", (*net_msg_ptr));
+            return; // go to next incoming port
+        }
+
+        MsgPtr unmodified_msg_ptr;
+
+        if (output_links.size() > 1) {
+            // If we are sending this message down more than
+            // one link (size>1), we need to make a copy of
+            // the message so each branch can have a different
+            // internal destination we need to create an
+            // unmodified MsgPtr because the MessageBuffer
+            // enqueue func will modify the message
+
+            // This magic line creates a private copy of the
+            // message
+            unmodified_msg_ptr = msg_ptr->clone();
+        }
+
+        // Enqueue it - for all outgoing queues
+        for (int i=0; i<output_links.size(); i++) {
+            int outgoing = output_links[i];
+
+            if (i > 0) {
+                // create a private copy of the unmodified
+                // message
+                msg_ptr = unmodified_msg_ptr->clone();
+            }
+
+            // Change the internal destination set of the
+            // message so it knows which destinations this
+            // link is responsible for.
+            net_msg_ptr = safe_cast<NetworkMessage*>(msg_ptr.get());
+            net_msg_ptr->getInternalDestination() =
+                output_link_destinations[i];
+
+            // Enqeue msg
+            DPRINTF(RubyNetwork, "Enqueuing net msg from "
+                    "inport[%d][%d] to outport [%d][%d].\n",
+                    incoming, vnet, outgoing, vnet);
+
+            m_out[outgoing][vnet]->enqueue(msg_ptr);
+        }
+
+        // Dequeue msg
+        m_in[incoming][vnet]->pop();
     }
+
+    // Messages that have not arrived yet keep the port marked; the
+    // buffer has already scheduled a wakeup for their arrival
+    if (m_in[incoming][vnet]->isEmpty())
+        m_ready_ports[vnet][incoming / 64] &= ~(1ULL << (incoming % 64));
 }
 
 void
-PerfectSwitch::storeEventInfo(int info)
+PerfectSwitch::storeEventInfo(int link, int vnet)
 {
-    m_pending_message_count[info]++;
+    m_ready_ports[vnet][link / 64] |= 1ULL << (link % 64);
 }
 
 void
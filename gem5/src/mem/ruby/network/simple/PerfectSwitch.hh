@@ -40,7 +40,9 @@
 #include <string>
 #include <vector>
 
+#include "base/types.hh"
 #include "mem/ruby/common/Consumer.hh"
+#include "mem/ruby/system/MachineID.hh"
 
 class MessageBuffer;
 class NetDest;
@@ -73,7 +75,7 @@ class PerfectSwitch : public Consumer
     int getOutLinks() const { return m_out.size(); }
 
     void wakeup();
-    void storeEventInfo(int info);
+    void storeEventInfo(int link, int vnet);
 
     void printStats(std::ostream& out) const;
     void clearStats();
@@ -84,6 +86,16 @@ class PerfectSwitch : public Consumer
     PerfectSwitch(const PerfectSwitch& obj);
     PerfectSwitch& operator=(const PerfectSwitch& obj);
 
+    // Route as many messages as possible from one input buffer
+    void routePort(int incoming, int vnet);
+
+    // Returns the lowest input port in [from, to) whose buffer on
+    // this vnet holds messages, or -1 if there is none
+    int findReadyPort(int vnet, int from, int to) const;
+
+    // Rebuilds m_dest_link from m_routing_table
+    void buildDestinationMap();
+
     SwitchID m_switch_id;
 
     // vector of queues from the components
@@ -97,7 +109,22 @@ class PerfectSwitch : public Consumer
     int m_wakeups_wo_switch;
 
     SimpleNetwork* m_network_ptr;
-    std::vector<int> m_pending_message_count;
+
+    // One bit per input port for each vnet, set while that input
+    // buffer holds messages, so wakeup() only visits ports with work
+    std::vector<std::vector<uint64_t> > m_ready_ports;
+
+    // Output link for each destination node (indexed by
+    // MachineType_base_number + num), i.e. the first link whose
+    // routing table entry contains it. Used whenever the link order
+    // is fixed, so a message is routed by walking its destinations
+    // rather than intersecting it with every routing table entry.
+    std::vector<int> m_dest_link;
+    bool m_dest_map_valid;
+
+    // Scratch state for routePort(), kept to avoid reallocating
+    std::vector<int> m_link_slot;
+    std::vector<MachineID> m_dest_scratch;
 };
 
 inline std::ostream&
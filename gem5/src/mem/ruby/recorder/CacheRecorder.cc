@@ -29,6 +29,7 @@
 
 #include "debug/RubyCacheTrace.hh"
 #include "mem/ruby/recorder/CacheRecorder.hh"
+#include "mem/ruby/recorder/ChunkedTrace.hh"
 #include "mem/ruby/system/Sequencer.hh"
 #include "mem/ruby/system/System.hh"
 
@@ -44,7 +45,8 @@ TraceRecord::print(ostream& out) const
 
 CacheRecorder::CacheRecorder()
     : m_uncompressed_trace(NULL),
-      m_uncompressed_trace_size(0)
+      m_uncompressed_trace_size(0),
+      m_trace_reader(NULL)
 {
 }
 
@@ -53,17 +55,31 @@ CacheRecorder::CacheRecorder(uint8_t* uncompressed_trace,
                              std::vector<Sequencer*>& seq_map)
     : m_uncompressed_trace(uncompressed_trace),
       m_uncompressed_trace_size(uncompressed_trace_size),
+      m_trace_reader(NULL),
       m_seq_map(seq_map),  m_bytes_read(0), m_records_read(0),
       m_records_flushed(0)
 {
 }
 
+CacheRecorder::CacheRecorder(ChunkedTraceReader* reader,
+                             std::vector<Sequencer*>& seq_map)
+    : m_uncompressed_trace(NULL),
+      m_uncompressed_trace_size(0),
+      m_trace_reader(reader),
+      m_seq_map(seq_map),  m_bytes_read(0), m_records_read(0),
+      m_records_flushed(0)
+{
+    assert(reader->recordSize() ==
+           sizeof(TraceRecord) + RubySystem::getBlockSizeBytes());
+}
+
 CacheRecorder::~CacheRecorder()
 {
     if (m_uncompressed_trace != NULL) {
         delete m_uncompressed_trace;
         m_uncompressed_trace = NULL;
     }
+    delete m_trace_reader;
     m_seq_map.clear();
 }
 
@@ -87,12 +103,27 @@ CacheRecorder::enqueueNextFlushRequest()
     }
 }
 
+TraceRecord*
+CacheRecorder::nextFetchRecord()
+{
+    if (m_trace_reader != NULL)
+        return (TraceRecord*)m_trace_reader->next();
+
+    if (m_bytes_read >= m_uncompressed_trace_size)
+        return NULL;
+
+    TraceRecord* traceRecord = (TraceRecord*) (m_uncompressed_trace +
+                                               m_bytes_read);
+    m_bytes_read += (sizeof(TraceRecord) +
+            RubySystem::getBlockSizeBytes());
+    return traceRecord;
+}
+
 void
 CacheRecorder::enqueueNextFetchRequest()
 {
-    if (m_bytes_read < m_uncompressed_trace_size) {
-        TraceRecord* traceRecord = (TraceRecord*) (m_uncompressed_trace +
-                                                                m_bytes_read);
+    TraceRecord* traceRecord = nextFetchRecord();
+    if (traceRecord != NULL) {
 
         DPRINTF(RubyCacheTrace, "Issuing %s\n", *traceRecord);
         Request* req = new Request();
@@ -120,8 +151,6 @@ CacheRecorder::enqueueNextFetchRequest()
         assert(m_sequencer_ptr != NULL);
         m_sequencer_ptr->makeRequest(pkt);
 
-        m_bytes_read += (sizeof(TraceRecord) +
-                RubySystem::getBlockSizeBytes());
         m_records_read++;
     }
 }
@@ -179,3 +208,21 @@ CacheRecorder::aggregateRecords(uint8_t** buf, uint64 total_size)
     m_records.clear();
     return current_size;
 }
+
+uint64
+CacheRecorder::writeChunkedTrace(const std::string& filename)
+{
+    std::sort(m_records.begin(), m_records.end(), compareTraceRecords);
+
+    int record_size = sizeof(TraceRecord) + RubySystem::getBlockSizeBytes();
+    ChunkedTraceWriter writer(filename, record_size);
+
+    for (int i = 0; i < m_records.size(); ++i) {
+        writer.addRecord(m_records[i]);
+        free(m_records[i]);
+        m_records[i] = NULL;
+    }
+
+    m_records.clear();
+    return writer.close();
+}
@@ -35,6 +35,7 @@
 #ifndef __MEM_RUBY_RECORDER_CACHERECORDER_HH__
 #define __MEM_RUBY_RECORDER_CACHERECORDER_HH__
 
+#include <string>
 #include <vector>
 
 #include "base/hashmap.hh"
@@ -43,6 +44,7 @@
 #include "mem/ruby/common/DataBlock.hh"
 #include "mem/ruby/common/TypeDefines.hh"
 
+class ChunkedTraceReader;
 class Sequencer;
 
 /*!
@@ -72,11 +74,17 @@ class CacheRecorder
     CacheRecorder(uint8_t* uncompressed_trace,
                   uint64_t uncompressed_trace_size,
                   std::vector<Sequencer*>& SequencerMap);
+    // Replays the records from a chunked trace; takes ownership of it
+    CacheRecorder(ChunkedTraceReader* reader,
+                  std::vector<Sequencer*>& SequencerMap);
     void addRecord(int cntrl, const physical_address_t data_addr,
                    const physical_address_t pc_addr,  RubyRequestType type,
                    Time time, DataBlock& data);
 
     uint64 aggregateRecords(uint8_t** data, uint64 size);
+    // Like aggregateRecords, but streams the records to a chunked
+    // trace file; returns the uncompressed size of the records
+    uint64 writeChunkedTrace(const std::string& filename);
 
     /*!
      * Function for flushing the memory contents of the caches to the
@@ -102,9 +110,12 @@ class CacheRecorder
     CacheRecorder(const CacheRecorder& obj);
     CacheRecorder& operator=(const CacheRecorder& obj);
 
+    TraceRecord* nextFetchRecord();
+
     std::vector<TraceRecord*> m_records;
     uint8_t* m_uncompressed_trace;
     uint64_t m_uncompressed_trace_size;
+    ChunkedTraceReader* m_trace_reader;
     std::vector<Sequencer*> m_seq_map;
     uint64_t m_bytes_read;
     uint64_t m_records_read;
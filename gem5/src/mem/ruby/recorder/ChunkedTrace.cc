@@ -0,0 +1,299 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "base/misc.hh"
+#include "mem/ruby/recorder/ChunkedTrace.hh"
+
+using namespace std;
+
+static const char chunkedTraceMagic[8] = {
+    'g', 'e', 'm', '5', 'r', 't', 'r', 'c'
+};
+static const uint32_t chunkedTraceVersion = 1;
+
+// Uncompressed bytes of records per chunk
+static const uint32_t chunkedTraceChunkBytes = 1 << 20;
+
+static bool
+preadAll(int fd, void *buf, size_t len, uint64_t offset)
+{
+    uint8_t *p = (uint8_t *)buf;
+    while (len > 0) {
+        ssize_t ret = pread(fd, p, len, offset);
+        if (ret < 0 && errno == EINTR)
+            continue;
+        if (ret <= 0)
+            return false;
+        p += ret;
+        offset += ret;
+        len -= ret;
+    }
+    return true;
+}
+
+ChunkedTraceWriter::ChunkedTraceWriter(const string &filename,
+                                       uint32_t record_size)
+    : filename(filename), recordSize(record_size), numRecords(0),
+      fileOffset(sizeof(ChunkedTraceHeader)), chunkRecords(0)
+{
+    fd = creat(filename.c_str(), 0664);
+    if (fd < 0) {
+        perror("creat");
+        fatal("Can't open cache trace file '%s'\n", filename);
+    }
+
+    recordsPerChunk = max(chunkedTraceChunkBytes / recordSize, 1U);
+    chunk.resize(recordsPerChunk * recordSize);
+    compBuf.resize(compressBound(chunk.size()));
+}
+
+ChunkedTraceWriter::~ChunkedTraceWriter()
+{
+    if (fd >= 0)
+        ::close(fd);
+}
+
+void
+ChunkedTraceWriter::writeAll(const void *buf, size_t len, uint64_t offset)
+{
+    const uint8_t *p = (const uint8_t *)buf;
+    while (len > 0) {
+        ssize_t ret = pwrite(fd, p, len, offset);
+        if (ret < 0 && errno == EINTR)
+            continue;
+        if (ret <= 0)
+            fatal("Write failed on cache trace file '%s'\n", filename);
+        p += ret;
+        offset += ret;
+        len -= ret;
+    }
+}
+
+void
+ChunkedTraceWriter::addRecord(const void *record)
+{
+    memcpy(&chunk[chunkRecords * recordSize], record, recordSize);
+    numRecords++;
+    if (++chunkRecords == recordsPerChunk)
+        writeChunk();
+}
+
+void
+ChunkedTraceWriter::writeChunk()
+{
+    if (chunkRecords == 0)
+        return;
+
+    uLongf comp_size = compBuf.size();
+    if (compress2(&compBuf[0], &comp_size, &chunk[0],
+                  chunkRecords * recordSize, Z_BEST_SPEED) != Z_OK)
+        fatal("Compression failed on cache trace file '%s'\n", filename);
+
+    ChunkedTraceIndex entry;
+    entry.offset = fileOffset;
+    entry.compSize = comp_size;
+    entry.numRecords = chunkRecords;
+    index.push_back(entry);
+
+    writeAll(&compBuf[0], comp_size, fileOffset);
+    fileOffset += comp_size;
+    chunkRecords = 0;
+}
+
+uint64_t
+ChunkedTraceWriter::close()
+{
+    writeChunk();
+
+    ChunkedTraceHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, chunkedTraceMagic, sizeof(header.magic));
+    header.version = chunkedTraceVersion;
+    header.recordSize = recordSize;
+    header.numRecords = numRecords;
+    header.numChunks = index.size();
+    header.indexOffset = fileOffset;
+
+    if (!index.empty()) {
+        writeAll(&index[0], index.size() * sizeof(ChunkedTraceIndex),
+                 fileOffset);
+    }
+    writeAll(&header, sizeof(header), 0);
+
+    if (::close(fd) != 0)
+        fatal("Close failed on cache trace file '%s'\n", filename);
+    fd = -1;
+
+    return numRecords * recordSize;
+}
+
+ChunkedTraceReader::ChunkedTraceReader(const string &filename,
+                                       int num_threads)
+    : filename(filename), nextChunk(0), releasedChunks(0), stopping(false),
+      curChunk(0), curRecord(0), curSlot(NULL)
+{
+    fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        perror("open");
+        fatal("Unable to open trace file %s", filename);
+    }
+
+    if (!preadAll(fd, &header, sizeof(header), 0) ||
+        memcmp(header.magic, chunkedTraceMagic, sizeof(header.magic)) != 0)
+        fatal("%s is not a chunked cache trace\n", filename);
+    if (header.version != chunkedTraceVersion)
+        fatal("Cache trace %s has unsupported version %d\n", filename,
+              header.version);
+
+    index.resize(header.numChunks);
+    if (header.numChunks > 0 &&
+        !preadAll(fd, &index[0], index.size() * sizeof(ChunkedTraceIndex),
+                  header.indexOffset))
+        fatal("Unable to read the index of cache trace %s\n", filename);
+
+    pthread_mutex_init(&mutex, NULL);
+    pthread_cond_init(&slotFree, NULL);
+    pthread_cond_init(&slotReady, NULL);
+
+    // Two slots per thread let every thread work on the next chunk
+    // while the replay is still using the previous ones
+    int num_workers = min<uint64_t>(max(num_threads, 1), header.numChunks);
+    slots.resize(max(num_workers * 2, 1));
+    for (int i = 0; i < slots.size(); i++)
+        slots[i].chunk = -1;
+
+    workers.resize(num_workers);
+    for (int i = 0; i < num_workers; i++) {
+        workers[i].reader = this;
+        if (pthread_create(&workers[i].thread, NULL, workerMain,
+                           &workers[i]) != 0)
+            fatal("Could not create cache trace thread\n");
+    }
+}
+
+ChunkedTraceReader::~ChunkedTraceReader()
+{
+    pthread_mutex_lock(&mutex);
+    stopping = true;
+    pthread_cond_broadcast(&slotFree);
+    pthread_mutex_unlock(&mutex);
+
+    for (int i = 0; i < workers.size(); i++)
+        pthread_join(workers[i].thread, NULL);
+
+    pthread_cond_destroy(&slotReady);
+    pthread_cond_destroy(&slotFree);
+    pthread_mutex_destroy(&mutex);
+    ::close(fd);
+}
+
+void *
+ChunkedTraceReader::workerMain(void *arg)
+{
+    Worker *worker = (Worker *)arg;
+    worker->reader->decodeChunks();
+    return NULL;
+}
+
+void
+ChunkedTraceReader::decodeChunks()
+{
+    vector<uint8_t> comp;
+
+    while (true) {
+        pthread_mutex_lock(&mutex);
+        while (!stopping && nextChunk < header.numChunks &&
+               nextChunk >= releasedChunks + slots.size())
+            pthread_cond_wait(&slotFree, &mutex);
+        if (stopping || nextChunk >= header.numChunks) {
+            pthread_mutex_unlock(&mutex);
+            return;
+        }
+        uint64_t c = nextChunk++;
+        pthread_mutex_unlock(&mutex);
+
+        // The slot's previous chunk has been released, and the replay
+        // won't look at it again until it is marked as holding c
+        const ChunkedTraceIndex &entry = index[c];
+        Slot &slot = slots[c % slots.size()];
+
+        comp.resize(entry.compSize);
+        if (!preadAll(fd, &comp[0], entry.compSize, entry.offset))
+            fatal("Unable to read chunk %d of cache trace %s\n", c,
+                  filename);
+
+        uLongf size = (uLongf)entry.numRecords * header.recordSize;
+        slot.data.resize(size);
+        if (uncompress(&slot.data[0], &size, &comp[0], entry.compSize) !=
+            Z_OK || size != slot.data.size())
+            fatal("Unable to decompress chunk %d of cache trace %s\n", c,
+                  filename);
+
+        pthread_mutex_lock(&mutex);
+        slot.chunk = c;
+        pthread_cond_broadcast(&slotReady);
+        pthread_mutex_unlock(&mutex);
+    }
+}
+
+uint8_t *
+ChunkedTraceReader::next()
+{
+    if (curSlot != NULL && curRecord == index[curChunk].numRecords) {
+        // The replay has moved past this chunk, so its slot can be
+        // handed to the next chunk to be decompressed
+        pthread_mutex_lock(&mutex);
+        releasedChunks = curChunk + 1;
+        pthread_cond_broadcast(&slotFree);
+        pthread_mutex_unlock(&mutex);
+
+        curChunk++;
+        curSlot = NULL;
+    }
+
+    if (curChunk >= header.numChunks)
+        return NULL;
+
+    if (curSlot == NULL) {
+        Slot &slot = slots[curChunk % slots.size()];
+        pthread_mutex_lock(&mutex);
+        while (slot.chunk != (int64_t)curChunk)
+            pthread_cond_wait(&slotReady, &mutex);
+        pthread_mutex_unlock(&mutex);
+
+        curSlot = &slot;
+        curRecord = 0;
+    }
+
+    return &curSlot->data[(uint64_t)curRecord++ * header.recordSize];
+}
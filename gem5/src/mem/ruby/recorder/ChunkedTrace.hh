@@ -0,0 +1,146 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * A chunked, block-compressed format for Ruby cache warm-up traces.
+ * Records are grouped into chunks that are compressed independently,
+ * with an index at the end of the file, so a trace can be replayed
+ * while it is being decompressed, several chunks at a time, without
+ * ever holding the whole trace in memory.
+ */
+
+#ifndef __MEM_RUBY_RECORDER_CHUNKEDTRACE_HH__
+#define __MEM_RUBY_RECORDER_CHUNKEDTRACE_HH__
+
+#include <pthread.h>
+
+#include <string>
+#include <vector>
+
+#include "base/types.hh"
+
+struct ChunkedTraceHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t numRecords;
+    uint64_t numChunks;
+    uint64_t indexOffset;
+};
+
+struct ChunkedTraceIndex
+{
+    uint64_t offset;
+    uint32_t compSize;
+    uint32_t numRecords;
+};
+
+class ChunkedTraceWriter
+{
+  public:
+    ChunkedTraceWriter(const std::string &filename, uint32_t record_size);
+    ~ChunkedTraceWriter();
+
+    void addRecord(const void *record);
+
+    // Writes the last chunk and the index; returns the number of
+    // bytes of (uncompressed) records written
+    uint64_t close();
+
+  private:
+    void writeChunk();
+    void writeAll(const void *buf, size_t len, uint64_t offset);
+
+    std::string filename;
+    int fd;
+    uint32_t recordSize;
+    uint32_t recordsPerChunk;
+    uint64_t numRecords;
+    uint64_t fileOffset;
+    std::vector<uint8_t> chunk;
+    uint32_t chunkRecords;
+    std::vector<uint8_t> compBuf;
+    std::vector<ChunkedTraceIndex> index;
+};
+
+class ChunkedTraceReader
+{
+  public:
+    // Decompresses ahead of the replay on up to num_threads threads
+    ChunkedTraceReader(const std::string &filename, int num_threads);
+    ~ChunkedTraceReader();
+
+    /**
+     * Returns the next record, or NULL at the end of the trace. A
+     * record stays valid until the records of the following chunk
+     * are being returned.
+     */
+    uint8_t *next();
+
+    uint32_t recordSize() const { return header.recordSize; }
+    uint64_t numRecords() const { return header.numRecords; }
+
+  private:
+    struct Slot
+    {
+        std::vector<uint8_t> data;
+        // Chunk held by this slot, -1 while it is being filled
+        int64_t chunk;
+    };
+
+    struct Worker
+    {
+        ChunkedTraceReader *reader;
+        pthread_t thread;
+    };
+
+    static void *workerMain(void *arg);
+    void decodeChunks();
+
+    std::string filename;
+    int fd;
+    ChunkedTraceHeader header;
+    std::vector<ChunkedTraceIndex> index;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t slotFree;
+    pthread_cond_t slotReady;
+    std::vector<Slot> slots;
+    std::vector<Worker> workers;
+    // Next chunk for a worker to decompress
+    uint64_t nextChunk;
+    // Chunks before this one have been replayed and their slots can
+    // be reused
+    uint64_t releasedChunks;
+    bool stopping;
+
+    // Replay position
+    uint64_t curChunk;
+    uint32_t curRecord;
+    Slot *curSlot;
+};
+
+#endif // __MEM_RUBY_RECORDER_CHUNKEDTRACE_HH__
@@ -32,6 +32,7 @@
 #include <iostream>
 
 #include "base/refcnt.hh"
+#include "mem/ruby/common/FreeList.hh"
 #include "mem/ruby/common/Global.hh"
 #include "mem/ruby/common/TypeDefines.hh"
 #include "mem/ruby/system/System.hh"
@@ -29,61 +29,115 @@
 #ifndef __MEM_RUBY_SYSTEM_ABSTRACTREPLACEMENTPOLICY_HH__
 #define __MEM_RUBY_SYSTEM_ABSTRACTREPLACEMENTPOLICY_HH__
 
+#include <cstring>
+
+#include "base/types.hh"
+#include "mem/ruby/common/Address.hh"
 #include "mem/ruby/common/TypeDefines.hh"
 
+/**
+ * The replacement state of all the sets lives in a single contiguous
+ * allocation. Each set owns one block, aligned to a host cache line,
+ * that holds the last reference time of every way followed by
+ * state_bytes of policy specific state. Touching a set thus only
+ * touches that set's block, without any pointer chasing.
+ */
+
 class AbstractReplacementPolicy
 {
   public:
-    AbstractReplacementPolicy(Index num_sets, Index assoc);
+    AbstractReplacementPolicy(Index num_sets, Index assoc,
+                              unsigned state_bytes = 0);
     virtual ~AbstractReplacementPolicy();
 
     /* touch a block. a.k.a. update timestamp */
     virtual void touch(Index set, Index way, Time time) = 0;
 
+    /* reference a block on behalf of an access to a line address.
+     * fill is true if the block has just been allocated. Policies that
+     * care about insertions or addresses override this, by default it
+     * is the same as touch() */
+    virtual void reference(Index set, Index way, Time time,
+                           const Address& address, bool fill);
+
     /* returns the way to replace */
     virtual Index getVictim(Index set) const = 0;
 
     /* get the time of the last access */
     Time getLastAccess(Index set, Index way);
 
+    /* set the time of the last access, which is all the state of
+     * policies that do not need reference() */
+    void setLastAccess(Index set, Index way, Time time)
+    {
+        lastRef(set)[way] = time;
+    }
+
+    /* does the policy need reference() to be called on every access,
+     * or is it enough to update the last access time inline */
+    bool needsReference() const { return m_needs_reference; }
+
   protected:
+    /* last reference time of each way of a set */
+    Time* lastRef(Index set) const
+    {
+        return (Time*)(m_state + set * m_set_stride);
+    }
+
+    /* policy specific state of a set */
+    uint8_t* setState(Index set) const
+    {
+        return m_state + set * m_set_stride + m_assoc * sizeof(Time);
+    }
+
     unsigned m_num_sets;       /** total number of sets */
     unsigned m_assoc;          /** set associativity */
-    Time **m_last_ref_ptr;         /** timestamp of last reference */
+    bool m_needs_reference;    /** call reference() on each access */
+
+  private:
+    size_t m_set_stride;       /** bytes of state per set */
+    uint8_t* m_state_alloc;    /** unaligned allocation */
+    uint8_t* m_state;          /** aligned state of all sets */
 };
 
 inline
 AbstractReplacementPolicy::AbstractReplacementPolicy(Index num_sets,
-                                                     Index assoc)
+                                                     Index assoc,
+                                                     unsigned state_bytes)
 {
+    const size_t line_size = 64;
+
     m_num_sets = num_sets;
     m_assoc = assoc;
-    m_last_ref_ptr = new Time*[m_num_sets];
-    for(unsigned i = 0; i < m_num_sets; i++){
-        m_last_ref_ptr[i] = new Time[m_assoc];
-        for(unsigned j = 0; j < m_assoc; j++){
-            m_last_ref_ptr[i][j] = 0;
-        }
-    }
+    m_needs_reference = true;
+
+    m_set_stride = m_assoc * sizeof(Time) + state_bytes;
+    m_set_stride = (m_set_stride + line_size - 1) & ~(line_size - 1);
+
+    size_t size = m_set_stride * m_num_sets;
+    m_state_alloc = new uint8_t[size + line_size - 1];
+    m_state = (uint8_t*)(((uintptr_t)m_state_alloc + line_size - 1) &
+                         ~(uintptr_t)(line_size - 1));
+    memset(m_state, 0, size);
 }
 
 inline
 AbstractReplacementPolicy::~AbstractReplacementPolicy()
 {
-    if (m_last_ref_ptr != NULL){
-        for (unsigned i = 0; i < m_num_sets; i++){
-            if (m_last_ref_ptr[i] != NULL){
-                delete[] m_last_ref_ptr[i];
-            }
-        }
-        delete[] m_last_ref_ptr;
-    }
+    delete[] m_state_alloc;
+}
+
+inline void
+AbstractReplacementPolicy::reference(Index set, Index way, Time time,
+                                     const Address& address, bool fill)
+{
+    touch(set, way, time);
 }
 
 inline Time
 AbstractReplacementPolicy::getLastAccess(Index set, Index way)
 {
-    return m_last_ref_ptr[set][way];
+    return lastRef(set)[way];
 }
 
 #endif // __MEM_RUBY_SYSTEM_ABSTRACTREPLACEMENTPOLICY_HH__
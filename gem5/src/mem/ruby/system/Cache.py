@@ -37,7 +37,13 @@ class RubyCache(SimObject):
     size = Param.MemorySize("capacity in bytes");
     latency = Param.Int("");
     assoc = Param.Int("");
-    replacement_policy = Param.String("PSEUDO_LRU", "");
+    replacement_policy = Param.String("PSEUDO_LRU",
+        "PSEUDO_LRU, LRU, SRRIP, BRRIP, DRRIP or OPT");
+    rrpv_bits = Param.Int(2, "bits of re-reference prediction for RRIP")
+    opt_trace = Param.String("",
+        "access trace recorded by access_trace, used as the OPT oracle")
+    access_trace = Param.String("",
+        "record the line addresses referenced in this cache to this file")
     start_index_bit = Param.Int(6, "index start, default 6 for 64-byte line");
     is_icache = Param.Bool(False, "is instruction only cache");
 
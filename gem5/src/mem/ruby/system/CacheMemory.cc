@@ -26,7 +26,9 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include "base/callback.hh"
 #include "base/intmath.hh"
+#include "base/output.hh"
 #include "debug/RubyCache.hh"
 #include "debug/RubyCacheTrace.hh"
 #include "debug/RubyResourceStalls.hh"
@@ -34,9 +36,13 @@
 #include "mem/protocol/AccessPermission.hh"
 #include "mem/ruby/system/CacheMemory.hh"
 #include "mem/ruby/system/System.hh"
+#include "sim/sim_exit.hh"
 
 using namespace std;
 
+// Tag of an empty way, which no line address can match
+static const physical_address_t invalidTag = (physical_address_t)-1;
+
 ostream&
 operator<<(ostream& out, const CacheMemory& obj)
 {
@@ -64,6 +70,16 @@ CacheMemory::CacheMemory(const Params *p)
     m_start_index_bit = p->start_index_bit;
     m_is_instruction_only_cache = p->is_icache;
     m_resource_stalls = p->resourceStalls;
+    m_rrpv_bits = p->rrpv_bits;
+    m_opt_trace = p->opt_trace;
+
+    m_access_trace = NULL;
+    if (p->access_trace != "") {
+        m_access_trace = simout.create(p->access_trace, true);
+        registerExitCallback(
+            new MakeCallback<CacheMemory,
+                             &CacheMemory::closeAccessTrace>(this));
+    }
 }
 
 void
@@ -81,8 +97,25 @@ CacheMemory::init()
     else if (m_policy == "LRU")
         m_replacementPolicy_ptr =
             new LRUPolicy(m_cache_num_sets, m_cache_assoc);
+    else if (m_policy == "SRRIP")
+        m_replacementPolicy_ptr =
+            new RRIPPolicy(m_cache_num_sets, m_cache_assoc,
+                           RRIPPolicy::SRRIP, m_rrpv_bits);
+    else if (m_policy == "BRRIP")
+        m_replacementPolicy_ptr =
+            new RRIPPolicy(m_cache_num_sets, m_cache_assoc,
+                           RRIPPolicy::BRRIP, m_rrpv_bits);
+    else if (m_policy == "DRRIP")
+        m_replacementPolicy_ptr =
+            new RRIPPolicy(m_cache_num_sets, m_cache_assoc,
+                           RRIPPolicy::DRRIP, m_rrpv_bits);
+    else if (m_policy == "OPT")
+        m_replacementPolicy_ptr =
+            new OPTPolicy(m_cache_num_sets, m_cache_assoc, m_opt_trace);
     else
-        assert(false);
+        fatal("%s: unknown replacement policy %s\n", name(), m_policy);
+
+    m_tags.assign(m_cache_num_sets * m_cache_assoc, invalidTag);
 
     m_cache.resize(m_cache_num_sets);
     for (int i = 0; i < m_cache_num_sets; i++) {
@@ -95,6 +128,7 @@ CacheMemory::init()
 
 CacheMemory::~CacheMemory()
 {
+    closeAccessTrace();
     if (m_replacementPolicy_ptr != NULL)
         delete m_replacementPolicy_ptr;
     delete m_profiler_ptr;
@@ -119,13 +153,10 @@ CacheMemory::addressToCacheSet(const Address& address) const
 int
 CacheMemory::findTagInSet(Index cacheSet, const Address& tag) const
 {
-    assert(tag == line_address(tag));
-    // search the set for the tags
-    m5::hash_map<Address, int>::const_iterator it = m_tag_index.find(tag);
-    if (it != m_tag_index.end())
-        if (m_cache[cacheSet][it->second]->m_Permission !=
-            AccessPermission_NotPresent)
-            return it->second;
+    int loc = findTagInSetIgnorePermissions(cacheSet, tag);
+    if (loc != -1 &&
+        m_cache[cacheSet][loc]->m_Permission != AccessPermission_NotPresent)
+        return loc;
     return -1; // Not found
 }
 
@@ -136,10 +167,13 @@ CacheMemory::findTagInSetIgnorePermissions(Index cacheSet,
                                            const Address& tag) const
 {
     assert(tag == line_address(tag));
-    // search the set for the tags
-    m5::hash_map<Address, int>::const_iterator it = m_tag_index.find(tag);
-    if (it != m_tag_index.end())
-        return it->second;
+    // search the tags of the set, which are contiguous in memory
+    const physical_address_t addr = tag.getAddress();
+    const physical_address_t* tags = &m_tags[cacheSet * m_cache_assoc];
+    for (int i = 0; i < m_cache_assoc; i++) {
+        if (tags[i] == addr)
+            return i;
+    }
     return -1; // Not found
 }
 
@@ -154,7 +188,7 @@ CacheMemory::tryCacheAccess(const Address& address, RubyRequestType type,
     if (loc != -1) {
         // Do we even have a tag match?
         AbstractCacheEntry* entry = m_cache[cacheSet][loc];
-        m_replacementPolicy_ptr->touch(cacheSet, loc, curTick());
+        referenceBlock(cacheSet, loc, address, false);
         data_ptr = &(entry->getDataBlk());
 
         if (entry->m_Permission == AccessPermission_Read_Write) {
@@ -182,7 +216,7 @@ CacheMemory::testCacheAccess(const Address& address, RubyRequestType type,
     if (loc != -1) {
         // Do we even have a tag match?
         AbstractCacheEntry* entry = m_cache[cacheSet][loc];
-        m_replacementPolicy_ptr->touch(cacheSet, loc, curTick());
+        referenceBlock(cacheSet, loc, address, false);
         data_ptr = &(entry->getDataBlk());
 
         return m_cache[cacheSet][loc]->m_Permission !=
@@ -254,9 +288,9 @@ CacheMemory::allocate(const Address& address, AbstractCacheEntry* entry)
             DPRINTF(RubyCache, "Allocate clearing lock for addr: %x\n",
                     address);
             set[i]->m_locked = -1;
-            m_tag_index[address] = i;
+            m_tags[cacheSet * m_cache_assoc + i] = address.getAddress();
 
-            m_replacementPolicy_ptr->touch(cacheSet, i, curTick());
+            referenceBlock(cacheSet, i, address, true);
 
             return entry;
         }
@@ -275,7 +309,7 @@ CacheMemory::deallocate(const Address& address)
     if (loc != -1) {
         delete m_cache[cacheSet][loc];
         m_cache[cacheSet][loc] = NULL;
-        m_tag_index.erase(address);
+        m_tags[cacheSet * m_cache_assoc + loc] = invalidTag;
     }
 }
 
@@ -321,7 +355,32 @@ CacheMemory::setMRU(const Address& address)
     int loc = findTagInSet(cacheSet, address);
 
     if(loc != -1)
-        m_replacementPolicy_ptr->touch(cacheSet, loc, curTick());
+        referenceBlock(cacheSet, loc, address, false);
+}
+
+void
+CacheMemory::referenceBlock(Index cacheSet, int loc, const Address& address,
+                            bool fill)
+{
+    if (m_replacementPolicy_ptr->needsReference())
+        m_replacementPolicy_ptr->reference(cacheSet, loc, curTick(), address,
+                                           fill);
+    else
+        m_replacementPolicy_ptr->setLastAccess(cacheSet, loc, curTick());
+
+    if (m_access_trace) {
+        uint64 addr = address.getAddress();
+        m_access_trace->write((const char*)&addr, sizeof(addr));
+    }
+}
+
+void
+CacheMemory::closeAccessTrace()
+{
+    if (m_access_trace) {
+        simout.close(m_access_trace);
+        m_access_trace = NULL;
+    }
 }
 
 void
@@ -32,7 +32,6 @@
 #include <string>
 #include <vector>
 
-#include "base/hashmap.hh"
 #include "base/statistics.hh"
 #include "mem/protocol/CacheResourceType.hh"
 #include "mem/protocol/CacheRequestType.hh"
@@ -45,7 +44,9 @@
 #include "mem/ruby/slicc_interface/RubySlicc_ComponentMapping.hh"
 #include "mem/ruby/system/BankedArray.hh"
 #include "mem/ruby/system/LRUPolicy.hh"
+#include "mem/ruby/system/OPTPolicy.hh"
 #include "mem/ruby/system/PseudoLRUPolicy.hh"
+#include "mem/ruby/system/RRIPPolicy.hh"
 #include "params/RubyCache.hh"
 #include "sim/sim_object.hh"
 
@@ -138,6 +139,14 @@ class CacheMemory : public SimObject
     int findTagInSetIgnorePermissions(Index cacheSet,
                                       const Address& tag) const;
 
+    // Update the replacement state for an access to a block, and
+    // record it in the access trace if there is one
+    void referenceBlock(Index cacheSet, int loc, const Address& address,
+                        bool fill);
+
+    // Flush the access trace when the simulation ends
+    void closeAccessTrace();
+
     // Private copy constructor and assignment operator
     CacheMemory(const CacheMemory& obj);
     CacheMemory& operator=(const CacheMemory& obj);
@@ -149,9 +158,12 @@ class CacheMemory : public SimObject
     // Data Members (m_prefix)
     bool m_is_instruction_only_cache;
 
+    // The line address held in each way, stored set by set so that a
+    // lookup only scans the few contiguous tags of a single set.
+    std::vector<physical_address_t> m_tags;
+
     // The first index is the # of cache lines.
     // The second index is the the amount associativity.
-    m5::hash_map<Address, int> m_tag_index;
     std::vector<std::vector<AbstractCacheEntry*> > m_cache;
 
     AbstractReplacementPolicy *m_replacementPolicy_ptr;
@@ -168,6 +180,10 @@ class CacheMemory : public SimObject
     int m_cache_assoc;
     int m_start_index_bit;
     bool m_resource_stalls;
+
+    int m_rrpv_bits;
+    std::string m_opt_trace;
+    std::ostream* m_access_trace;
 };
 
 #endif // __MEM_RUBY_SYSTEM_CACHEMEMORY_HH__
@@ -47,6 +47,8 @@ DirectoryMemory::DirectoryMemory(const Params *p)
     m_size_bytes = p->size;
     m_size_bits = floorLog2(m_size_bytes);
     m_num_entries = 0;
+    m_entries = NULL;
+    m_sparseMemory = NULL;
     m_use_map = p->use_map;
     m_map_levels = p->map_levels;
     m_numa_high_bit = p->numa_high_bit;
@@ -61,9 +63,7 @@ DirectoryMemory::init()
         m_sparseMemory = new SparseMemory(m_map_levels);
         g_system_ptr->registerSparseMemory(m_sparseMemory);
     } else {
-        m_entries = new AbstractEntry*[m_num_entries];
-        for (int i = 0; i < m_num_entries; i++)
-            m_entries[i] = NULL;
+        m_entries = new RadixDirectory(ceilLog2(m_num_entries));
         m_ram = g_system_ptr->getMemoryVector();
     }
 
@@ -80,16 +80,8 @@ DirectoryMemory::init()
 DirectoryMemory::~DirectoryMemory()
 {
     // free up all the directory entries
-    if (m_entries != NULL) {
-        for (uint64 i = 0; i < m_num_entries; i++) {
-            if (m_entries[i] != NULL) {
-                delete m_entries[i];
-            }
-        }
-        delete [] m_entries;
-    } else if (m_use_map) {
-        delete m_sparseMemory;
-    }
+    delete m_entries;
+    delete m_sparseMemory;
 }
 
 uint64
@@ -135,7 +127,7 @@ DirectoryMemory::lookup(PhysAddress address)
     } else {
         uint64_t idx = mapAddressToLocalIdx(address);
         assert(idx < m_num_entries);
-        return m_entries[idx];
+        return m_entries->lookup(idx);
     }
 }
 
@@ -154,7 +146,7 @@ DirectoryMemory::allocate(const PhysAddress& address, AbstractEntry* entry)
         assert(idx < m_num_entries);
         entry->getDataBlk().assign(m_ram->getBlockPtr(address));
         entry->changePermission(AccessPermission_Read_Only);
-        m_entries[idx] = entry;
+        m_entries->insert(idx, entry);
     }
 
     return entry;
@@ -196,6 +188,8 @@ DirectoryMemory::printStats(ostream& out) const
 {
     if (m_use_map) {
         m_sparseMemory->printStats(out);
+    } else {
+        m_entries->printStats(out);
     }
 }
 
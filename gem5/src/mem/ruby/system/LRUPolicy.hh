@@ -47,6 +47,9 @@ inline
 LRUPolicy::LRUPolicy(Index num_sets, Index assoc)
     : AbstractReplacementPolicy(num_sets, assoc)
 {
+    // the last access time is all the state LRU needs, and the cache
+    // updates it inline
+    m_needs_reference = false;
 }
 
 inline
@@ -60,7 +63,7 @@ LRUPolicy::touch(Index set, Index index, Time time)
     assert(index >= 0 && index < m_assoc);
     assert(set >= 0 && set < m_num_sets);
 
-    m_last_ref_ptr[set][index] = time;
+    lastRef(set)[index] = time;
 }
 
 inline Index
@@ -69,12 +72,13 @@ LRUPolicy::getVictim(Index set) const
     //  assert(m_assoc != 0);
     Time time, smallest_time;
     Index smallest_index;
+    const Time* last_ref = lastRef(set);
 
     smallest_index = 0;
-    smallest_time = m_last_ref_ptr[set][0];
+    smallest_time = last_ref[0];
 
     for (unsigned i = 0; i < m_assoc; i++) {
-        time = m_last_ref_ptr[set][i];
+        time = last_ref[i];
         // assert(m_cache[cacheSet][i].m_Permission !=
         //     AccessPermission_NotPresent);
 
@@ -0,0 +1,135 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <fstream>
+
+#include "base/misc.hh"
+#include "mem/ruby/system/OPTPolicy.hh"
+
+using namespace std;
+
+/** Sequence number of a reference that never happens */
+static const uint64 neverUsed = (uint64)-1;
+
+OPTPolicy::OPTPolicy(Index num_sets, Index assoc, const string& trace_file)
+    : AbstractReplacementPolicy(num_sets, assoc, assoc * sizeof(uint64)),
+      m_pos(0), m_window(num_sets * assoc)
+{
+    for (unsigned i = 0; i < m_num_sets; i++) {
+        for (unsigned j = 0; j < m_assoc; j++) {
+            nextUse(i)[j] = neverUsed;
+        }
+    }
+
+    if (trace_file == "")
+        fatal("OPT replacement needs an access trace as its oracle\n");
+
+    ifstream trace(trace_file.c_str(), ios::in | ios::binary);
+    if (!trace.is_open())
+        fatal("OPT replacement could not open access trace %s\n",
+              trace_file);
+
+    // the trace is a plain sequence of 64-bit line addresses, read it
+    // in large batches
+    const size_t batch = 64 * 1024;
+    vector<uint64> addrs(batch);
+    uint64 seq = 0;
+    while (trace) {
+        trace.read((char*)&addrs[0], batch * sizeof(uint64));
+        size_t count = trace.gcount() / sizeof(uint64);
+        for (size_t i = 0; i < count; i++) {
+            m_line_uses[Address(addrs[i])].seq.push_back(seq++);
+        }
+    }
+
+    if (seq == 0)
+        warn("OPT replacement access trace %s is empty\n", trace_file);
+}
+
+OPTPolicy::~OPTPolicy()
+{
+}
+
+void
+OPTPolicy::touch(Index set, Index index, Time time)
+{
+    assert(index >= 0 && index < m_assoc);
+    assert(set >= 0 && set < m_num_sets);
+
+    // without an address the next use cannot be updated
+    lastRef(set)[index] = time;
+}
+
+void
+OPTPolicy::reference(Index set, Index index, Time time,
+                     const Address& address, bool fill)
+{
+    assert(index >= 0 && index < m_assoc);
+    assert(set >= 0 && set < m_num_sets);
+
+    uint64 next_use = neverUsed;
+
+    m5::hash_map<Address, LineUses>::iterator it =
+        m_line_uses.find(address);
+    if (it != m_line_uses.end()) {
+        LineUses& uses = it->second;
+
+        // recorded references long before the current position are
+        // ones that this run skipped
+        while (uses.next < uses.seq.size() &&
+               uses.seq[uses.next] + m_window < m_pos)
+            uses.next++;
+
+        // a recorded reference close to the current position is this
+        // one, resynchronise to it
+        if (uses.next < uses.seq.size() &&
+            uses.seq[uses.next] <= m_pos + m_window) {
+            m_pos = uses.seq[uses.next];
+            uses.next++;
+        }
+
+        if (uses.next < uses.seq.size())
+            next_use = uses.seq[uses.next];
+    }
+
+    m_pos++;
+
+    nextUse(set)[index] = next_use;
+    lastRef(set)[index] = time;
+}
+
+Index
+OPTPolicy::getVictim(Index set) const
+{
+    const uint64* next_use = nextUse(set);
+
+    Index victim = 0;
+    for (unsigned i = 1; i < m_assoc; i++) {
+        if (next_use[i] > next_use[victim])
+            victim = i;
+    }
+
+    return victim;
+}
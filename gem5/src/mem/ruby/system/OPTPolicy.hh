@@ -0,0 +1,92 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_RUBY_SYSTEM_OPTPOLICY_HH__
+#define __MEM_RUBY_SYSTEM_OPTPOLICY_HH__
+
+#include <string>
+#include <vector>
+
+#include "base/hashmap.hh"
+#include "mem/ruby/system/AbstractReplacementPolicy.hh"
+
+/**
+ * Belady's optimal (OPT) replacement, driven by an oracle.
+ *
+ * The oracle is the sequence of line addresses referenced in the
+ * cache, as recorded by the access_trace parameter of CacheMemory in
+ * an earlier run of the same workload. Every recorded reference is
+ * numbered in order, and the victim is the block whose next recorded
+ * reference is furthest in the future.
+ *
+ * The run with OPT does not reference the cache exactly as the
+ * recorded one did: replacements in this cache change what the caches
+ * above it miss on, and timing changes the interleaving of the
+ * requests. The references are therefore not matched by position, but
+ * by line: each line has a cursor into its own recorded references,
+ * and a reference to the line consumes the next one. The policy also
+ * keeps track of where in the recording the run is. A recorded
+ * reference more than a cache's worth of references behind that
+ * position is taken as one the run skipped, and a reference whose
+ * next recorded one is more than that ahead is taken as one that was
+ * not recorded. A matched reference moves the position to its own.
+ *
+ * The result is thus only an approximation of OPT, which gets better
+ * the closer the run follows the recorded one.
+ */
+
+class OPTPolicy : public AbstractReplacementPolicy
+{
+  public:
+    OPTPolicy(Index num_sets, Index assoc, const std::string& trace_file);
+    ~OPTPolicy();
+
+    void touch(Index set, Index way, Time time);
+    void reference(Index set, Index way, Time time,
+                   const Address& address, bool fill);
+    Index getVictim(Index set) const;
+
+  private:
+    /** Next reference of each block of a set */
+    uint64* nextUse(Index set) const { return (uint64*)setState(set); }
+
+    /** Future references to a single line */
+    struct LineUses
+    {
+        std::vector<uint64> seq;       /** sequence numbers in order */
+        size_t next;                   /** first entry not yet passed */
+
+        LineUses() : next(0) {}
+    };
+
+    m5::hash_map<Address, LineUses> m_line_uses;
+    /** Where in the recording the run is thought to be; a guess that
+     *  makes the policy an approximation of OPT, not OPT itself */
+    uint64 m_pos;
+    /** How far, in references, the run may be off the recording */
+    uint64 m_window;
+};
+
+#endif // __MEM_RUBY_SYSTEM_OPTPOLICY_HH__
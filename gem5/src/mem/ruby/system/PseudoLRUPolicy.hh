@@ -54,20 +54,20 @@ class PseudoLRUPolicy : public AbstractReplacementPolicy
     Index getVictim(Index set) const;
 
   private:
+    /** bit representation of the tree of a set */
+    uint64& tree(Index set) const { return *(uint64*)setState(set); }
+
     unsigned int m_effective_assoc;    /** nearest (to ceiling) power of 2 */
     unsigned int m_num_levels;         /** number of levels in the tree */
-    uint64* m_trees;                   /** bit representation of the
-                                        * trees, one for each set */
 };
 
 inline
 PseudoLRUPolicy::PseudoLRUPolicy(Index num_sets, Index assoc)
-    : AbstractReplacementPolicy(num_sets, assoc)
+    : AbstractReplacementPolicy(num_sets, assoc, sizeof(uint64))
 {
     // associativity cannot exceed capacity of tree representation
     assert(num_sets > 0 && assoc > 1 && assoc <= (Index) sizeof(uint64)*4);
 
-    m_trees = NULL;
     m_num_levels = 0;
 
     m_effective_assoc = 1;
@@ -82,17 +82,11 @@ PseudoLRUPolicy::PseudoLRUPolicy(Index num_sets, Index assoc)
         m_num_levels++;
     }
     assert(m_num_levels < sizeof(unsigned int)*4);
-    m_trees = new uint64[m_num_sets];
-    for (unsigned i = 0; i < m_num_sets; i++) {
-        m_trees[i] = 0;
-    }
 }
 
 inline
 PseudoLRUPolicy::~PseudoLRUPolicy()
 {
-    if (m_trees != NULL)
-        delete[] m_trees;
 }
 
 inline void
@@ -101,17 +95,18 @@ PseudoLRUPolicy::touch(Index set, Index index, Time time)
     assert(index >= 0 && index < m_assoc);
     assert(set >= 0 && set < m_num_sets);
 
+    uint64& set_tree = tree(set);
     int tree_index = 0;
     int node_val;
     for (int i = m_num_levels - 1; i >= 0; i--) {
         node_val = (index >> i)&1;
         if (node_val)
-            m_trees[set] |= node_val << tree_index;
+            set_tree |= node_val << tree_index;
         else
-            m_trees[set] &= ~(1 << tree_index);
+            set_tree &= ~(1 << tree_index);
         tree_index = node_val ? (tree_index*2)+2 : (tree_index*2)+1;
     }
-    m_last_ref_ptr[set][index] = time;
+    lastRef(set)[index] = time;
 }
 
 inline Index
@@ -119,11 +114,12 @@ PseudoLRUPolicy::getVictim(Index set) const
 {
     // assert(m_assoc != 0);
     Index index = 0;
+    uint64 set_tree = tree(set);
 
     int tree_index = 0;
     int node_val;
     for (unsigned i = 0; i < m_num_levels; i++){
-        node_val = (m_trees[set] >> tree_index) & 1;
+        node_val = (set_tree >> tree_index) & 1;
         index += node_val ? 0 : (m_effective_assoc >> (i + 1));
         tree_index = node_val ? (tree_index * 2) + 1 : (tree_index * 2) + 2;
     }
@@ -0,0 +1,215 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_RUBY_SYSTEM_RRIPPOLICY_HH__
+#define __MEM_RUBY_SYSTEM_RRIPPOLICY_HH__
+
+#include <cstdlib>
+
+#include "mem/ruby/system/AbstractReplacementPolicy.hh"
+
+/**
+ * Re-reference interval prediction (RRIP) replacement, after Jaleel
+ * et al., ISCA 2010.
+ *
+ * Every block holds an M-bit re-reference prediction value (RRPV). A
+ * hit predicts a near re-reference (RRPV 0). The victim is the first
+ * block predicted to be re-referenced in the distant future (RRPV
+ * 2^M - 1), ageing the whole set until one is found. Victim selection
+ * only looks at the set; the ageing is applied when the victim is
+ * refilled.
+ *
+ * SRRIP inserts new blocks with a long prediction (2^M - 2). BRRIP
+ * inserts with a distant prediction, and only one in 32 insertions
+ * gets a long prediction, which protects the cache from thrashing.
+ * DRRIP uses set dueling between a few SRRIP and BRRIP leader sets to
+ * choose the insertion policy of the remaining sets.
+ */
+
+class RRIPPolicy : public AbstractReplacementPolicy
+{
+  public:
+    enum Mode { SRRIP, BRRIP, DRRIP };
+
+    RRIPPolicy(Index num_sets, Index assoc, Mode mode, int rrpv_bits);
+    ~RRIPPolicy();
+
+    void touch(Index set, Index way, Time time);
+    void reference(Index set, Index way, Time time,
+                   const Address& address, bool fill);
+    Index getVictim(Index set) const;
+
+  private:
+    /** Does the given set insert blocks using BRRIP? */
+    bool useBimodal(Index set) const;
+
+    /** Age a set whose block at index is being replaced */
+    void age(Index set, Index index);
+
+    Mode m_mode;
+    /** RRPV of each block of a set, aged on replacement */
+    uint8_t* rrpv(Index set) const { return setState(set); }
+
+    uint8_t m_max_rrpv;                /** distant re-reference value */
+
+    unsigned m_leader_period;          /** distance between leader sets */
+    int m_psel;                        /** DRRIP policy selector */
+    int m_psel_max;
+};
+
+inline
+RRIPPolicy::RRIPPolicy(Index num_sets, Index assoc, Mode mode,
+                       int rrpv_bits)
+    : AbstractReplacementPolicy(num_sets, assoc, assoc), m_mode(mode)
+{
+    assert(rrpv_bits > 0 && rrpv_bits <= 8);
+    m_max_rrpv = (1 << rrpv_bits) - 1;
+
+    for (unsigned i = 0; i < m_num_sets; i++) {
+        memset(rrpv(i), m_max_rrpv, m_assoc);
+    }
+
+    // dedicate 32 leader sets to each policy, or every other set for
+    // caches that are too small to do so
+    m_leader_period = m_num_sets / 32;
+    if (m_leader_period < 2)
+        m_leader_period = 2;
+
+    // 10-bit saturating policy selector, starting in the middle
+    m_psel_max = (1 << 10) - 1;
+    m_psel = m_psel_max / 2;
+}
+
+inline
+RRIPPolicy::~RRIPPolicy()
+{
+}
+
+inline bool
+RRIPPolicy::useBimodal(Index set) const
+{
+    switch (m_mode) {
+      case SRRIP:
+        return false;
+      case BRRIP:
+        return true;
+      default:
+        break;
+    }
+
+    unsigned offset = set % m_leader_period;
+    if (offset == 0)
+        return false;
+    if (offset == m_leader_period - 1)
+        return true;
+
+    // followers use BRRIP when the SRRIP leaders miss more often
+    return m_psel > m_psel_max / 2;
+}
+
+inline void
+RRIPPolicy::touch(Index set, Index index, Time time)
+{
+    assert(index >= 0 && index < m_assoc);
+    assert(set >= 0 && set < m_num_sets);
+
+    // hit priority: predict a near-immediate re-reference
+    rrpv(set)[index] = 0;
+    lastRef(set)[index] = time;
+}
+
+inline void
+RRIPPolicy::reference(Index set, Index index, Time time,
+                      const Address& address, bool fill)
+{
+    if (!fill) {
+        touch(set, index, time);
+        return;
+    }
+
+    assert(index >= 0 && index < m_assoc);
+    assert(set >= 0 && set < m_num_sets);
+
+    // a fill is a miss in this set, train the policy selector on the
+    // leader sets
+    if (m_mode == DRRIP) {
+        unsigned offset = set % m_leader_period;
+        if (offset == 0 && m_psel < m_psel_max)
+            m_psel++;
+        else if (offset == m_leader_period - 1 && m_psel > 0)
+            m_psel--;
+    }
+
+    age(set, index);
+
+    uint8_t insert_rrpv = m_max_rrpv - 1;
+    if (useBimodal(set) && (random() % 32) != 0)
+        insert_rrpv = m_max_rrpv;
+
+    rrpv(set)[index] = insert_rrpv;
+    lastRef(set)[index] = time;
+}
+
+inline void
+RRIPPolicy::age(Index set, Index index)
+{
+    uint8_t* set_rrpv = rrpv(set);
+
+    // a block that getVictim() would have picked is being replaced,
+    // so age the set until its prediction is distant, which is
+    // equivalent to repeatedly incrementing all the RRPVs until a
+    // victim is found; fills of blocks with a nearer prediction, such
+    // as invalid ones, leave the set alone
+    uint8_t max_rrpv = 0;
+    for (unsigned i = 0; i < m_assoc; i++) {
+        if (set_rrpv[i] > max_rrpv)
+            max_rrpv = set_rrpv[i];
+    }
+
+    uint8_t age = m_max_rrpv - set_rrpv[index];
+    if (age && set_rrpv[index] == max_rrpv) {
+        for (unsigned i = 0; i < m_assoc; i++) {
+            set_rrpv[i] += age;
+        }
+    }
+}
+
+inline Index
+RRIPPolicy::getVictim(Index set) const
+{
+    const uint8_t* set_rrpv = rrpv(set);
+
+    // the first block with the most distant prediction, which
+    // reaches the distant value once the set is aged
+    Index victim = 0;
+    for (unsigned i = 1; i < m_assoc; i++) {
+        if (set_rrpv[i] > set_rrpv[victim])
+            victim = i;
+    }
+
+    return victim;
+}
+
+#endif // __MEM_RUBY_SYSTEM_RRIPPOLICY_HH__
@@ -0,0 +1,121 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cassert>
+#include <cstring>
+
+#include "mem/ruby/slicc_interface/AbstractEntry.hh"
+#include "mem/ruby/system/RadixDirectory.hh"
+
+using namespace std;
+
+RadixDirectory::RadixDirectory(int index_bits)
+    : m_index_bits(index_bits), m_last_page(~0ULL), m_last_leaf(NULL),
+      m_num_leaves(0), m_num_nodes(1)
+{
+    int page_bits = index_bits > LEAF_BITS ? index_bits - LEAF_BITS : 0;
+    m_levels = page_bits > 0 ? (page_bits + NODE_BITS - 1) / NODE_BITS : 1;
+
+    m_root = new Node;
+    memset(m_root, 0, sizeof(Node));
+}
+
+RadixDirectory::~RadixDirectory()
+{
+    deleteNode(m_root, 0);
+}
+
+void
+RadixDirectory::deleteNode(Node *node, int level)
+{
+    for (int i = 0; i <= NODE_MASK; i++) {
+        if (node->children[i] == NULL)
+            continue;
+
+        if (level == m_levels - 1) {
+            Leaf *leaf = (Leaf *)node->children[i];
+            for (int j = 0; j <= LEAF_MASK; j++)
+                delete leaf->entries[j];
+            delete leaf;
+        } else {
+            deleteNode((Node *)node->children[i], level + 1);
+        }
+    }
+    delete node;
+}
+
+RadixDirectory::Leaf *
+RadixDirectory::findLeaf(uint64 page, bool create)
+{
+    assert((page >> (m_levels * NODE_BITS)) == 0);
+
+    Node *node = m_root;
+    for (int level = 0; level < m_levels; level++) {
+        int shift = (m_levels - 1 - level) * NODE_BITS;
+        void *&child = node->children[(page >> shift) & NODE_MASK];
+
+        if (child == NULL) {
+            if (!create)
+                return NULL;
+
+            if (level == m_levels - 1) {
+                Leaf *leaf = new Leaf;
+                memset(leaf, 0, sizeof(Leaf));
+                child = leaf;
+                m_num_leaves++;
+            } else {
+                Node *next = new Node;
+                memset(next, 0, sizeof(Node));
+                child = next;
+                m_num_nodes++;
+            }
+        }
+
+        if (level == m_levels - 1)
+            return (Leaf *)child;
+        node = (Node *)child;
+    }
+
+    return NULL;
+}
+
+void
+RadixDirectory::insert(uint64 idx, AbstractEntry *entry)
+{
+    uint64 page = idx >> LEAF_BITS;
+    Leaf *leaf = findLeaf(page, true);
+    assert(leaf->entries[idx & LEAF_MASK] == NULL);
+    leaf->entries[idx & LEAF_MASK] = entry;
+
+    m_last_page = page;
+    m_last_leaf = leaf;
+}
+
+void
+RadixDirectory::printStats(ostream& out) const
+{
+    out << "directory_pages: " << m_num_leaves << " [nodes: "
+        << m_num_nodes << "]" << endl;
+}
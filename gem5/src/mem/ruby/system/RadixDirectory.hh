@@ -0,0 +1,103 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_RUBY_SYSTEM_RADIXDIRECTORY_HH__
+#define __MEM_RUBY_SYSTEM_RADIXDIRECTORY_HH__
+
+#include <iostream>
+
+#include "mem/ruby/common/TypeDefines.hh"
+
+class AbstractEntry;
+
+/**
+ * Directory entry store indexed by block number. Entries live in
+ * page-sized leaves that are only allocated once an entry in them is,
+ * below a radix tree of page-sized nodes, so memory use follows the
+ * touched footprint rather than the size of the address space. The
+ * leaf of the last lookup is cached, which makes the common case a
+ * compare and an array index, like a dense array.
+ */
+class RadixDirectory
+{
+  public:
+    RadixDirectory(int index_bits);
+    ~RadixDirectory();
+
+    AbstractEntry *
+    lookup(uint64 idx)
+    {
+        uint64 page = idx >> LEAF_BITS;
+        if (page != m_last_page) {
+            Leaf *leaf = findLeaf(page, false);
+            if (leaf == NULL)
+                return NULL;
+            m_last_page = page;
+            m_last_leaf = leaf;
+        }
+        return m_last_leaf->entries[idx & LEAF_MASK];
+    }
+
+    void insert(uint64 idx, AbstractEntry *entry);
+
+    void printStats(std::ostream& out) const;
+
+  private:
+    // Private copy constructor and assignment operator
+    RadixDirectory(const RadixDirectory& obj);
+    RadixDirectory& operator=(const RadixDirectory& obj);
+
+    // 4kB of pointers per leaf and per node on 64-bit hosts
+    static const int LEAF_BITS = 9;
+    static const uint64 LEAF_MASK = (1 << LEAF_BITS) - 1;
+    static const int NODE_BITS = 9;
+    static const uint64 NODE_MASK = (1 << NODE_BITS) - 1;
+
+    struct Leaf
+    {
+        AbstractEntry *entries[1 << LEAF_BITS];
+    };
+
+    struct Node
+    {
+        void *children[1 << NODE_BITS];
+    };
+
+    Leaf *findLeaf(uint64 page, bool create);
+    void deleteNode(Node *node, int level);
+
+    int m_index_bits;
+    // Number of node levels above the leaves
+    int m_levels;
+    Node *m_root;
+
+    uint64 m_last_page;
+    Leaf *m_last_leaf;
+
+    uint64 m_num_leaves;
+    uint64 m_num_nodes;
+};
+
+#endif // __MEM_RUBY_SYSTEM_RADIXDIRECTORY_HH__
@@ -42,3 +42,6 @@ class RubySystem(ClockedObject):
     stats_filename = Param.String("ruby.stats",
         "file to which ruby dumps its stats")
     no_mem_vec = Param.Bool(False, "do not allocate Ruby's mem vector");
+    chunked_cache_trace = Param.Bool(False, "checkpoint the cache " \
+        "contents as a chunked trace that is decompressed in parallel " \
+        "while it is replayed, instead of a single gzip file");
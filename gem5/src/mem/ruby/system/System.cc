@@ -27,6 +27,7 @@
  */
 
 #include <fcntl.h>
+#include <unistd.h>
 #include <zlib.h>
 
 #include <cstdio>
@@ -38,6 +39,7 @@
 #include "mem/ruby/common/Address.hh"
 #include "mem/ruby/network/Network.hh"
 #include "mem/ruby/profiler/Profiler.hh"
+#include "mem/ruby/recorder/ChunkedTrace.hh"
 #include "mem/ruby/system/System.hh"
 #include "sim/eventq.hh"
 #include "sim/simulate.hh"
@@ -85,6 +87,7 @@ RubySystem::RubySystem(const Params *p)
 
     m_warmup_enabled = false;
     m_cooldown_enabled = false;
+    m_chunked_cache_trace = p->chunked_cache_trace;
 }
 
 void
@@ -245,15 +248,28 @@ RubySystem::serialize(std::ostream &os)
         }
     }
 
-    // Aggergate the trace entries together into a single array
-    raw_data = new uint8_t[4096];
-    uint64 cache_trace_size = m_cache_recorder->aggregateRecords(&raw_data,
-                                                                 4096);
-    string cache_trace_file = name() + ".cache.gz";
-    writeCompressedTrace(raw_data, cache_trace_file, cache_trace_size);
+    string cache_trace_file;
+    string cache_trace_format;
+    uint64 cache_trace_size;
+
+    if (m_chunked_cache_trace) {
+        cache_trace_file = name() + ".cache.chunks";
+        cache_trace_format = "chunked";
+        cache_trace_size = m_cache_recorder->writeChunkedTrace(
+            Checkpoint::dir() + "/" + cache_trace_file);
+    } else {
+        // Aggergate the trace entries together into a single array
+        raw_data = new uint8_t[4096];
+        cache_trace_size = m_cache_recorder->aggregateRecords(&raw_data,
+                                                              4096);
+        cache_trace_file = name() + ".cache.gz";
+        cache_trace_format = "gzip";
+        writeCompressedTrace(raw_data, cache_trace_file, cache_trace_size);
+    }
 
     SERIALIZE_SCALAR(cache_trace_file);
     SERIALIZE_SCALAR(cache_trace_size);
+    SERIALIZE_SCALAR(cache_trace_format);
 
     m_cooldown_enabled = false;
 }
@@ -318,13 +334,28 @@ RubySystem::unserialize(Checkpoint *cp, const string &section)
 
     string cache_trace_file;
     uint64 cache_trace_size = 0;
+    // Checkpoints from before the chunked format are all gzip
+    string cache_trace_format = "gzip";
 
     UNSERIALIZE_SCALAR(cache_trace_file);
     UNSERIALIZE_SCALAR(cache_trace_size);
+    UNSERIALIZE_OPT_SCALAR(cache_trace_format);
     cache_trace_file = cp->cptDir + "/" + cache_trace_file;
 
-    readCompressedTrace(cache_trace_file, uncompressed_trace,
-                        cache_trace_size);
+    ChunkedTraceReader *trace_reader = NULL;
+    if (cache_trace_format == "chunked") {
+        // The records are decompressed on all host processors ahead
+        // of the replay rather than all at once up front
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        trace_reader = new ChunkedTraceReader(cache_trace_file,
+                                              cpus > 0 ? cpus : 1);
+    } else if (cache_trace_format == "gzip") {
+        readCompressedTrace(cache_trace_file, uncompressed_trace,
+                            cache_trace_size);
+    } else {
+        fatal("Unknown cache trace format '%s' in checkpoint\n",
+              cache_trace_format);
+    }
     m_warmup_enabled = true;
 
     vector<Sequencer*> sequencer_map;
@@ -342,8 +373,12 @@ RubySystem::unserialize(Checkpoint *cp, const string &section)
         }
     }
 
-    m_cache_recorder = new CacheRecorder(uncompressed_trace, cache_trace_size,
-                                         sequencer_map);
+    if (trace_reader != NULL) {
+        m_cache_recorder = new CacheRecorder(trace_reader, sequencer_map);
+    } else {
+        m_cache_recorder = new CacheRecorder(uncompressed_trace,
+                                             cache_trace_size, sequencer_map);
+    }
 }
 
 void
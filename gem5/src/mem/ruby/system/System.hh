@@ -153,6 +153,7 @@ class RubySystem : public ClockedObject
 
     Network* m_network_ptr;
     MemoryControl *m_memory_controller;
+    bool m_chunked_cache_trace;
 
   public:
     Profiler* m_profiler_ptr;
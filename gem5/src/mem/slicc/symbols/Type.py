@@ -251,15 +251,27 @@ $klass ${{self.c_ident}}$parent
         if not self.isGlobal:
             code('${{self.c_ident}}(const ${{self.c_ident}}&other)')
 
-            # Call superclass constructor
+            # Call superclass constructor and copy construct the
+            # members, rather than default constructing and then
+            # assigning them
+            inits = []
             if "interface" in self:
-                code('    : ${{self["interface"]}}(other)')
+                inits.append('%s(other)' % self["interface"])
+            for dm in self.data_members.values():
+                if "abstract" not in dm:
+                    inits.append('m_%s(other.m_%s)' % (dm.ident, dm.ident))
+
+            for i,init in enumerate(inits):
+                sep = ',' if i < len(inits) - 1 else ''
+                lead = ':' if i == 0 else ' '
+                code('    $lead $init$sep')
 
             code('{')
             code.indent()
 
             for dm in self.data_members.values():
-                code('m_${{dm.ident}} = other.m_${{dm.ident}};')
+                if "abstract" in dm:
+                    code('m_${{dm.ident}} = other.m_${{dm.ident}};')
 
             code.dedent()
             code('}')
@@ -299,6 +311,23 @@ clone() const
 {
      return new ${{self.c_ident}}(*this);
 }
+''')
+
+        # messages are created and destroyed at a high rate, recycle
+        # their storage through a free list
+        if self.isMessage:
+            code('''
+static void*
+operator new(size_t size)
+{
+    return FreeList<${{self.c_ident}}>::allocate(size);
+}
+
+static void
+operator delete(void* p, size_t size)
+{
+    FreeList<${{self.c_ident}}>::release(p, size);
+}
 ''')
 
         if not self.isGlobal:
@@ -0,0 +1,98 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definition of an exact snoop filter for the coherent bus.
+ */
+
+#include <cassert>
+
+#include "mem/snoop_filter.hh"
+
+// fatal() takes its arguments by reference
+const unsigned SnoopFilter::MaxPorts;
+
+uint64_t &
+SnoopFilter::entry(Addr blk_addr)
+{
+    return holders.insert(std::make_pair(blk_addr, unknownHolders)).
+        first->second;
+}
+
+uint64_t
+SnoopFilter::lookup(Addr blk_addr) const
+{
+    uint64_t mask = unknownHolders;
+
+    m5::hash_map<Addr, uint64_t>::const_iterator h = holders.find(blk_addr);
+    if (h != holders.end())
+        mask = h->second;
+
+    std::pair<PendingMap::const_iterator, PendingMap::const_iterator> range =
+        pendingBlocks.equal_range(blk_addr);
+    for (PendingMap::const_iterator p = range.first; p != range.second; ++p)
+        mask |= portBit(p->second);
+
+    return mask;
+}
+
+void
+SnoopFilter::invalidate(Addr blk_addr, uint64_t keep)
+{
+    std::pair<PendingMap::iterator, PendingMap::iterator> range =
+        pendingBlocks.equal_range(blk_addr);
+    for (PendingMap::iterator p = range.first; p != range.second; ++p)
+        keep |= portBit(p->second);
+
+    // without an entry the block would go back to being held by the
+    // unknown holders, so only erase it if there are none
+    if (keep || unknownHolders)
+        holders[blk_addr] = keep;
+    else
+        holders.erase(blk_addr);
+}
+
+void
+SnoopFilter::addPending(RequestPtr req, Addr blk_addr, PortID port_id)
+{
+    assert(pendingReqs.find(req) == pendingReqs.end());
+    pendingReqs[req] =
+        pendingBlocks.insert(std::make_pair(blk_addr, port_id));
+}
+
+void
+SnoopFilter::removePending(RequestPtr req)
+{
+    m5::hash_map<RequestPtr, PendingMap::iterator>::iterator p =
+        pendingReqs.find(req);
+    if (p == pendingReqs.end())
+        return;
+
+    // the requester now has its copy, so remember it as a holder
+    entry(p->second->first) |= portBit(p->second->second);
+    pendingBlocks.erase(p->second);
+    pendingReqs.erase(p);
+}
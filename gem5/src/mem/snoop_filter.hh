@@ -0,0 +1,139 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definition of an exact snoop filter for the coherent bus.
+ */
+
+#ifndef __MEM_SNOOP_FILTER_HH__
+#define __MEM_SNOOP_FILTER_HH__
+
+#include <map>
+
+#include "base/hashmap.hh"
+#include "base/types.hh"
+#include "mem/request.hh"
+
+/**
+ * A sparse directory that records, per block, which of the bus slave
+ * ports may have a copy of the block somewhere above them. Caches
+ * evict clean blocks silently, so the set of holders is
+ * conservative: a port is added when it issues a cacheable request
+ * for the block, and the set only shrinks when an invalidating
+ * transaction has been snooped by all the current holders.
+ *
+ * Requests that have passed the bus but not yet seen their response
+ * are tracked separately, as the requesting cache may still end up
+ * with the block after an invalidation has gone by.
+ *
+ * Caches restored from a checkpoint hold blocks the filter has never
+ * seen. After a restore, a block without an entry is therefore
+ * assumed to be held by all the snooping ports, until an invalidation
+ * tells the filter who is left.
+ *
+ * Entries are never dropped on clean evictions, which the filter does
+ * not see, so it grows with the number of distinct blocks requested
+ * through the bus, i.e. with the footprint of the workload, at one
+ * hash map entry per block.
+ */
+class SnoopFilter
+{
+  public:
+
+    /** Maximum number of slave ports that can be tracked. */
+    static const unsigned MaxPorts = 64;
+
+    SnoopFilter() : blockMask(0), unknownHolders(0) { }
+
+    /** Set the block size used to align all addresses. */
+    void setBlockSize(unsigned block_size)
+    { blockMask = ~Addr(block_size - 1); }
+
+    /** Return the block-aligned address for an address. */
+    Addr blockAlign(Addr addr) const { return addr & blockMask; }
+
+    /**
+     * Get the ports that may hold a block, including those with a
+     * request for it in flight.
+     *
+     * @param blk_addr Block-aligned address
+     * @return a mask with one bit per slave port id
+     */
+    uint64_t lookup(Addr blk_addr) const;
+
+    /**
+     * Assume that the given ports hold all the blocks the filter has
+     * no entry for, e.g. after the caches above were restored from a
+     * checkpoint.
+     *
+     * @param ports a mask with one bit per slave port id
+     */
+    void assumeHolders(uint64_t ports) { unknownHolders = ports; }
+
+    /** Note that a port may now hold a block. */
+    void addHolder(Addr blk_addr, PortID port_id)
+    { entry(blk_addr) |= portBit(port_id); }
+
+    /**
+     * Record that all the copies of a block have been invalidated
+     * apart from those in the ports in keep. Ports with a request in
+     * flight for the block are always kept.
+     */
+    void invalidate(Addr blk_addr, uint64_t keep);
+
+    /** Track a request that expects a response through the bus. */
+    void addPending(RequestPtr req, Addr blk_addr, PortID port_id);
+
+    /** Stop tracking a request once its response has been sent. */
+    void removePending(RequestPtr req);
+
+    /** Get the bit corresponding to a port id. */
+    static uint64_t portBit(PortID port_id)
+    { return 1ULL << port_id; }
+
+  private:
+
+    /** Get the holders of a block, creating its entry if needed. */
+    uint64_t &entry(Addr blk_addr);
+
+    /** Block-aligned address to the mask of potential holders. */
+    m5::hash_map<Addr, uint64_t> holders;
+
+    typedef std::multimap<Addr, PortID> PendingMap;
+
+    /** In-flight requests, ordered by block to find them quickly. */
+    PendingMap pendingBlocks;
+
+    /** Request to its entry in pendingBlocks. */
+    m5::hash_map<RequestPtr, PendingMap::iterator> pendingReqs;
+
+    Addr blockMask;
+
+    /** Potential holders of the blocks without an entry. */
+    uint64_t unknownHolders;
+};
+
+#endif //__MEM_SNOOP_FILTER_HH__
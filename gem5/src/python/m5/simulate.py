@@ -188,10 +188,37 @@ def checkpoint(dir):
     if not isinstance(root, objects.Root):
         raise TypeError, "Checkpoint must be called on a root object."
     doDrain(root)
+    # Dirty blocks stay dirty in the cache tags, but memory gets a copy
+    # of their data, so the checkpoint is still usable without caches
+    for obj in root.descendants():
+        if isinstance(obj, objects.BaseCache):
+            obj.memWriteback()
     print "Writing checkpoint"
     internal.core.serializeAll(dir)
     resume(root)
 
+# Put all classic caches below root in (or take them out of)
+# functional warm-up mode.  While warming up, atomic accesses only
+# train the tags and replacement state of the caches and are passed on
+# to memory, which keeps the only up-to-date copy of the data.  When
+# leaving warm-up mode the data of every valid block is reloaded from
+# memory before any cache starts trusting its contents again.
+def warmupCaches(root, enable):
+    caches = [ obj for obj in root.descendants()
+               if isinstance(obj, objects.BaseCache) ]
+    doDrain(root)
+    if enable:
+        print "Entering cache warm-up mode"
+        for cache in caches:
+            cache.beginWarmup()
+    else:
+        print "Leaving cache warm-up mode"
+        for cache in caches:
+            cache.fillWarmupData()
+        for cache in caches:
+            cache.endWarmup()
+    resume(root)
+
 def changeToAtomic(system):
     if not isinstance(system, (objects.Root, objects.System)):
         raise TypeError, "Parameter of type '%s'.  Must be type %s or %s." % \
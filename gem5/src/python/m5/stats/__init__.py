@@ -128,6 +128,18 @@ def reset():
 
     internal.stats.processResetQueue()
 
+def snapshot(exprs, period, filename='stats_snapshot.txt', capacity=64):
+    '''Periodically record the statistics matching exprs without dumping
+    or resetting anything.  The per-period deltas are written to filename
+    whenever capacity snapshots have been buffered and at exit.'''
+
+    if isinstance(exprs, str):
+        exprs = [ exprs ]
+    for expr in exprs:
+        internal.stats.snapshotStats(expr)
+    internal.stats.initSnapshot(filename, capacity)
+    internal.stats.periodicStatSnapshot(period, m5.curTick())
+
 flags = attrdict({
     'none'    : 0x0000,
     'init'    : 0x0001,
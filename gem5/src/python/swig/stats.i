@@ -43,6 +43,7 @@
 #include "base/statistics.hh"
 #include "sim/core.hh"
 #include "sim/stat_control.hh"
+#include "sim/stat_snapshot.hh"
 
 namespace Stats {
 template <class T>
@@ -156,6 +157,12 @@ void periodicStatDump(long long period = 0);
 
 void updateEvents();
 
+void snapshotStats(const std::string &expr);
+void initSnapshot(const std::string &filename, int capacity = 64);
+void takeSnapshot();
+void flushSnapshots();
+void periodicStatSnapshot(Tick period, Tick when = curTick());
+
 void processResetQueue();
 void processDumpQueue();
 void enable();
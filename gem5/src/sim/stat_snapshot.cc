@@ -0,0 +1,306 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cmath>
+#include <iostream>
+#include <list>
+#include <vector>
+
+#include "base/callback.hh"
+#include "base/cprintf.hh"
+#include "base/match.hh"
+#include "base/misc.hh"
+#include "base/output.hh"
+#include "base/statistics.hh"
+#include "sim/eventq.hh"
+#include "sim/stat_snapshot.hh"
+
+using namespace std;
+
+namespace Stats {
+
+/**
+ * The snapshot ring. Slot (head + i) % capacity holds the i-th
+ * buffered snapshot; the one at head is the base the first delta is
+ * computed against.
+ */
+class StatSnapshot
+{
+  private:
+    /** Expressions selecting the statistics to capture. */
+    vector<string> exprs;
+    /** Selected statistics, resolved on the first snapshot. */
+    vector<ScalarInfo *> scalars;
+    vector<VectorInfo *> vectors;
+    /** Output name of every captured counter. */
+    vector<string> names;
+    /** Number of counters per snapshot. */
+    size_type width;
+    bool resolved;
+
+    string filename;
+    ostream *stream;
+
+    int capacity;
+    vector<Counter> ring;
+    vector<Tick> ticks;
+    /** Set if a statistics reset happened before the slot was taken. */
+    vector<bool> resetBefore;
+    int head;
+    int count;
+    /** Number of intervals written out so far. */
+    int intervals;
+    bool pendingReset;
+
+    /** Ticks between periodic snapshots, 0 if there are none. */
+    Tick period;
+    Event *event;
+
+    void resolve();
+    void periodic();
+    void write(int prev, int cur);
+
+  public:
+    StatSnapshot();
+
+    void add(const string &expr);
+    void init(const string &_filename, int _capacity);
+    void take();
+    void flush();
+
+    /** Called through the reset queue. */
+    void reset() { pendingReset = true; }
+
+    /** Called through the exit queue. */
+    void exit();
+
+    void schedule(Tick _period, Tick when);
+
+    const string name() const { return "stat_snapshot"; }
+};
+
+StatSnapshot::StatSnapshot()
+    : width(0), resolved(false), stream(NULL), capacity(0), head(0),
+      count(0), intervals(0), pendingReset(false), period(0),
+      event(new EventWrapper<StatSnapshot, &StatSnapshot::periodic>(
+                    this, false, Event::Stat_Event_Pri))
+{
+}
+
+void
+StatSnapshot::add(const string &expr)
+{
+    if (resolved)
+        fatal("Statistics can't be added to a snapshot after it is taken\n");
+    exprs.push_back(expr);
+}
+
+void
+StatSnapshot::init(const string &_filename, int _capacity)
+{
+    if (stream)
+        fatal("Statistics snapshot already initialized\n");
+    if (_capacity < 2)
+        fatal("Statistics snapshot needs room for at least two entries\n");
+
+    filename = _filename;
+    capacity = _capacity;
+    stream = simout.create(filename);
+
+    registerResetCallback(
+        new MakeCallback<StatSnapshot, &StatSnapshot::reset>(this));
+    registerExitCallback(
+        new MakeCallback<StatSnapshot, &StatSnapshot::exit>(this));
+}
+
+void
+StatSnapshot::resolve()
+{
+    ObjectMatch match;
+    match.setExpression(exprs);
+
+    list<Info *>::iterator i = statsList().begin();
+    list<Info *>::iterator end = statsList().end();
+    for (; i != end; ++i) {
+        Info *info = *i;
+        if (!match.match(info->name))
+            continue;
+
+        // Formulas derive from VectorInfo, but there is nothing to
+        // difference in them.
+        if (dynamic_cast<FormulaInfo *>(info))
+            continue;
+
+        if (VectorInfo *vinfo = dynamic_cast<VectorInfo *>(info)) {
+            vectors.push_back(vinfo);
+            for (size_type j = 0; j < vinfo->size(); ++j) {
+                const string &sub = vinfo->subnames.size() > j ?
+                    vinfo->subnames[j] : "";
+                if (sub.empty())
+                    names.push_back(csprintf("%s::%d", vinfo->name, j));
+                else
+                    names.push_back(vinfo->name + "::" + sub);
+            }
+        } else if (ScalarInfo *sinfo = dynamic_cast<ScalarInfo *>(info)) {
+            scalars.push_back(sinfo);
+        }
+    }
+
+    // Scalars are laid out after the vectors in each slot.
+    for (int j = 0; j < scalars.size(); ++j)
+        names.push_back(scalars[j]->name);
+
+    width = names.size();
+    if (width == 0)
+        warn("Statistics snapshot doesn't match any statistic\n");
+
+    ring.resize(capacity * width);
+    ticks.resize(capacity);
+    resetBefore.resize(capacity);
+    resolved = true;
+}
+
+void
+StatSnapshot::take()
+{
+    if (!stream)
+        fatal("Statistics snapshot taken before it was initialized\n");
+    if (!resolved)
+        resolve();
+
+    if (count == capacity)
+        flush();
+
+    int slot = (head + count) % capacity;
+    Counter *data = &ring[slot * width];
+
+    for (int i = 0; i < vectors.size(); ++i) {
+        const VCounter &vec = vectors[i]->value();
+        for (size_type j = 0; j < vec.size(); ++j)
+            *data++ = vec[j];
+    }
+    for (int i = 0; i < scalars.size(); ++i)
+        *data++ = scalars[i]->value();
+
+    ticks[slot] = curTick();
+    resetBefore[slot] = pendingReset;
+    pendingReset = false;
+    ++count;
+}
+
+void
+StatSnapshot::periodic()
+{
+    take();
+    mainEventQueue.schedule(event, curTick() + period);
+}
+
+void
+StatSnapshot::schedule(Tick _period, Tick when)
+{
+    if (event->scheduled())
+        mainEventQueue.deschedule(event);
+
+    period = _period;
+    if (period)
+        mainEventQueue.schedule(event, when);
+}
+
+void
+StatSnapshot::write(int prev, int cur)
+{
+    const Counter *base = &ring[prev * width];
+    const Counter *data = &ring[cur * width];
+    bool from_zero = resetBefore[cur];
+
+    ccprintf(*stream, "\n---------- Interval %d: ticks %d - %d%s ----------\n",
+             intervals++, ticks[prev], ticks[cur],
+             from_zero ? " (after reset)" : "");
+
+    for (size_type i = 0; i < width; ++i) {
+        Counter delta = from_zero ? data[i] : data[i] - base[i];
+        if (delta == floor(delta))
+            ccprintf(*stream, "%-50s %20.0f\n", names[i], delta);
+        else
+            ccprintf(*stream, "%-50s %20.6f\n", names[i], delta);
+    }
+}
+
+void
+StatSnapshot::flush()
+{
+    if (count < 2)
+        return;
+
+    for (int i = 1; i < count; ++i)
+        write((head + i - 1) % capacity, (head + i) % capacity);
+
+    // Keep the newest entry around as the base of the next interval.
+    head = (head + count - 1) % capacity;
+    count = 1;
+    stream->flush();
+}
+
+void
+StatSnapshot::exit()
+{
+    flush();
+    simout.close(stream);
+    stream = NULL;
+}
+
+StatSnapshot statSnapshot;
+
+void
+snapshotStats(const string &expr)
+{
+    statSnapshot.add(expr);
+}
+
+void
+initSnapshot(const string &filename, int capacity)
+{
+    statSnapshot.init(filename, capacity);
+}
+
+void
+takeSnapshot()
+{
+    statSnapshot.take();
+}
+
+void
+flushSnapshots()
+{
+    statSnapshot.flush();
+}
+
+void
+periodicStatSnapshot(Tick period, Tick when)
+{
+    statSnapshot.schedule(period, when);
+}
+
+} // namespace Stats
@@ -0,0 +1,86 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Cheap per-phase statistics sampling.
+ *
+ * A snapshot records the raw counter values of a selected subset of
+ * the scalar and vector statistics into a preallocated ring buffer.
+ * Taking a snapshot is a plain copy of counters; no formatting is
+ * done and no statistics are reset. The per-interval deltas are only
+ * computed and written out when the ring fills up, or when the
+ * simulator exits.
+ */
+
+#ifndef __SIM_STAT_SNAPSHOT_HH__
+#define __SIM_STAT_SNAPSHOT_HH__
+
+#include <string>
+
+#include "base/types.hh"
+#include "sim/core.hh"
+
+namespace Stats {
+
+/**
+ * Add statistics to the snapshot set. The expression uses the same
+ * dotted wildcard syntax as the trace ignore list, e.g.
+ * "system.*.overall_misses". Only scalar and vector statistics are
+ * captured; formulas and distributions are skipped since their delta
+ * is not meaningful. Must be called before the first snapshot is
+ * taken.
+ * @param expr Name expression of the statistics to capture.
+ */
+void snapshotStats(const std::string &expr);
+
+/**
+ * Set up the snapshot ring.
+ * @param filename File in the output directory the deltas go to.
+ * @param capacity Number of snapshots held before a flush.
+ */
+void initSnapshot(const std::string &filename, int capacity = 64);
+
+/**
+ * Record the current value of all selected statistics.
+ */
+void takeSnapshot();
+
+/**
+ * Compute and write the deltas of all buffered snapshots. The most
+ * recent snapshot is kept as the base of the next interval.
+ */
+void flushSnapshots();
+
+/**
+ * Schedule snapshots on a regular basis.
+ * @param period Ticks between snapshots, 0 to stop taking them.
+ * @param when Tick of the first snapshot.
+ */
+void periodicStatSnapshot(Tick period, Tick when = curTick());
+
+} // namespace Stats
+
+#endif // __SIM_STAT_SNAPSHOT_HH__
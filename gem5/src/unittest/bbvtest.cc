@@ -0,0 +1,187 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <unistd.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "base/output.hh"
+#include "cpu/simple/bbv_profiler.hh"
+#include "unittest/unittest.hh"
+
+using namespace std;
+using UnitTest::setCase;
+
+namespace {
+
+typedef map<uint32_t, uint32_t> Vector;
+
+/**
+ * A straightforward model of the profiler that keeps the blocks in a
+ * map and the vectors it would have written in a list.
+ */
+class RefProfiler
+{
+  public:
+    RefProfiler(Counter _interval)
+        : interval(_interval), blockStart(0), blockInsts(0),
+          intervalInsts(0)
+    {}
+
+    void
+    commit(Addr pc, bool control)
+    {
+        if (!blockInsts)
+            blockStart = pc;
+        blockInsts++;
+        if (control)
+            endBlock();
+    }
+
+    void
+    flush()
+    {
+        if (blockInsts)
+            endBlock();
+        if (intervalInsts)
+            endInterval();
+    }
+
+    vector<Vector> vectors;
+
+  private:
+    void
+    endBlock()
+    {
+        uint32_t &id = ids[blockStart];
+        if (!id)
+            id = ids.size();
+        current[id] += blockInsts;
+        intervalInsts += blockInsts;
+        blockInsts = 0;
+        if (intervalInsts >= interval)
+            endInterval();
+    }
+
+    void
+    endInterval()
+    {
+        vectors.push_back(current);
+        current.clear();
+        intervalInsts = 0;
+    }
+
+    Counter interval;
+    Addr blockStart;
+    uint32_t blockInsts;
+    Counter intervalInsts;
+    map<Addr, uint32_t> ids;
+    Vector current;
+};
+
+/** Parses the "T:<id>:<count> ..." lines the profiler wrote. */
+vector<Vector>
+readVectors(const string &filename)
+{
+    vector<Vector> vectors;
+    ifstream in(filename.c_str());
+    string line;
+    while (getline(in, line)) {
+        EXPECT_EQ(line[0], 'T');
+        Vector v;
+        istringstream is(line.substr(1));
+        char colon;
+        uint32_t id, count;
+        while (is >> colon >> id >> colon >> count) {
+            EXPECT_EQ(v.count(id), 0);
+            v[id] = count;
+        }
+        vectors.push_back(v);
+    }
+    return vectors;
+}
+
+/**
+ * Runs the profiler and the model over a random walk through the
+ * given number of basic blocks and compares what they produce.
+ */
+void
+testRun(Counter interval, int num_blocks, int insts)
+{
+    char name[] = "/tmp/bbvtest.XXXXXX";
+    int fd = mkstemp(name);
+    EXPECT_TRUE(fd >= 0);
+    close(fd);
+
+    BBVProfiler bbv(interval, name);
+    RefProfiler ref(interval);
+
+    Addr pc = 0x10000;
+    for (int i = 0; i < insts; i++) {
+        // a block ends in a control instruction after 1-16 others
+        bool control = random() % 8 == 0;
+        bbv.commit(pc, control);
+        ref.commit(pc, control);
+        if (control)
+            pc = 0x10000 + (random() % num_blocks) * 0x40;
+        else
+            pc += 4;
+    }
+    bbv.flush();
+    ref.flush();
+
+    // blocks may be listed in any order within a vector
+    vector<Vector> vectors = readVectors(name);
+    EXPECT_EQ(vectors.size(), ref.vectors.size());
+    EXPECT_TRUE(vectors == ref.vectors);
+
+    simout.close(simout.find(name));
+    unlink(name);
+}
+
+} // anonymous namespace
+
+int
+main()
+{
+    setCase("Few blocks, short intervals.");
+    testRun(100, 10, 10000);
+
+    setCase("An interval ends at a block boundary.");
+    testRun(1, 50, 5000);
+
+    setCase("The table grows with many blocks.");
+    testRun(10000, 5000, 500000);
+
+    setCase("A partial interval is written at the end.");
+    testRun(1000000, 100, 12345);
+
+    return UnitTest::printResults();
+}
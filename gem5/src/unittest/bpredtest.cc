@@ -0,0 +1,215 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cstdlib>
+#include <vector>
+
+#include "cpu/pred/packed_array.hh"
+#include "cpu/pred/perceptron.hh"
+#include "cpu/pred/tage.hh"
+#include "unittest/unittest.hh"
+
+using namespace std;
+using UnitTest::setCase;
+
+namespace {
+
+/** Check every field of a packed array against a reference copy. */
+void
+checkFields(const PackedArray &a, const vector<uint32_t> &ref)
+{
+    EXPECT_EQ(a.size(), ref.size());
+    for (unsigned i = 0; i < ref.size(); i++)
+        EXPECT_EQ(a.get(i), ref[i]);
+}
+
+void
+testPackedArray(unsigned bits)
+{
+    const unsigned size = 333;
+    const uint32_t mask = bits == 32 ? ~0U : (1U << bits) - 1;
+    const int max = bits == 32 ? 0x7fffffff : (1 << (bits - 1)) - 1;
+    const int min = -max - 1;
+
+    PackedArray a;
+    vector<uint32_t> ref(size, 0);
+    a.init(size, bits);
+    checkFields(a, ref);
+
+    // setting a field leaves its neighbours in the same word alone
+    for (int n = 0; n < 5000; n++) {
+        unsigned i = random() % size;
+        uint32_t val = random() & mask;
+        a.set(i, val);
+        ref[i] = val;
+        EXPECT_EQ(a.get(i), val);
+    }
+    checkFields(a, ref);
+
+    // values that don't fit are truncated
+    a.set(0, ~0U);
+    ref[0] = mask;
+    checkFields(a, ref);
+
+    // signed fields round trip through two's complement
+    a.setSigned(1, min);
+    EXPECT_EQ(a.getSigned(1), min);
+    a.setSigned(1, max);
+    EXPECT_EQ(a.getSigned(1), max);
+    a.setSigned(1, -1);
+    EXPECT_EQ(a.getSigned(1), -1);
+    EXPECT_EQ(a.get(1), mask);
+
+    if (bits > 8)
+        return;
+
+    // counters saturate at both ends
+    a.set(2, 0);
+    a.count(2, false);
+    EXPECT_EQ(a.get(2), 0);
+    for (unsigned n = 0; n <= mask; n++)
+        a.count(2, true);
+    EXPECT_EQ(a.get(2), mask);
+    a.count(2, false);
+    EXPECT_EQ(a.get(2), mask - 1);
+
+    a.setSigned(3, 0);
+    for (int n = 0; n <= max; n++)
+        a.countSigned(3, true);
+    EXPECT_EQ(a.getSigned(3), max);
+    for (int n = min; n <= max + 1; n++)
+        a.countSigned(3, false);
+    EXPECT_EQ(a.getSigned(3), min);
+    a.countSigned(3, true);
+    EXPECT_EQ(a.getSigned(3), min + 1);
+}
+
+/**
+ * Predicts and resolves one branch the way the O3 branch predictor
+ * unit does, returning whether the prediction was right.
+ */
+template <class BP>
+bool
+branch(BP &bp, Addr pc, bool taken)
+{
+    void *history;
+    bool pred = bp.lookup(pc, history);
+    bp.update(pc, taken, history, pred != taken);
+    return pred == taken;
+}
+
+/**
+ * Runs a branch with a repeating pattern and returns the number of
+ * mispredictions in the last of the given iterations of the pattern.
+ */
+template <class BP>
+int
+train(BP &bp, Addr pc, const char *pattern, int iterations)
+{
+    int wrong = 0;
+    for (int n = 0; n < iterations; n++) {
+        wrong = 0;
+        for (const char *p = pattern; *p; p++) {
+            // an unconditional jump back, as at the end of a loop body
+            void *history;
+            bp.uncondBr(history);
+            bp.update(pc + 64, true, history, false);
+
+            if (!branch(bp, pc, *p == 'T'))
+                wrong++;
+        }
+    }
+    return wrong;
+}
+
+/** Squashing a prediction restores the history it was made with. */
+template <class BP>
+void
+testSquash(BP &bp, Addr pc)
+{
+    void *h1;
+    void *h2;
+    void *h3;
+    bool pred = bp.lookup(pc, h1);
+    bp.squash(h1);
+    EXPECT_EQ(bp.lookup(pc, h1), pred);
+    bp.lookup(pc + 4, h2);
+    bp.uncondBr(h3);
+    bp.squash(h3);
+    bp.squash(h2);
+    bp.squash(h1);
+    EXPECT_EQ(bp.lookup(pc, h1), pred);
+    bp.squash(h1);
+}
+
+template <class BP>
+void
+testPatterns(BP &bp)
+{
+    EXPECT_EQ(train(bp, 0x1000, "T", 200), 0);
+    EXPECT_EQ(train(bp, 0x2000, "N", 200), 0);
+    EXPECT_EQ(train(bp, 0x3000, "TN", 200), 0);
+    EXPECT_EQ(train(bp, 0x4000, "TTNTNN", 500), 0);
+    testSquash(bp, 0x3000);
+    testSquash(bp, 0x4000);
+
+    // a branch missing from the BTB is not taken whatever the table says
+    void *history;
+    bp.lookup(0x1000, history);
+    bp.BTBUpdate(0x1000, history);
+    bp.update(0x1000, true, history, false);
+    EXPECT_EQ(train(bp, 0x1000, "T", 20), 0);
+}
+
+} // anonymous namespace
+
+int
+main()
+{
+    setCase("Packed arrays.");
+    testPackedArray(1);
+    testPackedArray(3);
+    testPackedArray(5);
+    testPackedArray(8);
+    testPackedArray(13);
+    testPackedArray(32);
+
+    setCase("TAGE learns simple patterns.");
+    TageBP tage(7, 10, 11, 5, 130, 8192, 64, 1024, 2);
+    testPatterns(tage);
+
+    setCase("TAGE loop predictor learns a constant trip count.");
+    EXPECT_EQ(train(tage, 0x5000, "TTTTTTTTTTTTTTTTTTTTTTTTTTTTTN", 100), 0);
+
+    setCase("TAGE without the loop predictor and corrector.");
+    TageBP plain(4, 8, 9, 4, 32, 1024, 0, 0, 2);
+    testPatterns(plain);
+
+    setCase("Perceptron learns simple patterns.");
+    PerceptronBP perceptron(8, 1024, 8, 128, 2);
+    testPatterns(perceptron);
+
+    return UnitTest::printResults();
+}
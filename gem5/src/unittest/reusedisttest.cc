@@ -0,0 +1,161 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <list>
+
+#include "mem/reuse_distance.hh"
+#include "unittest/unittest.hh"
+
+using namespace std;
+using UnitTest::setCase;
+
+namespace {
+
+const unsigned blockSize = 64;
+
+/**
+ * Compares the distances with those of an explicit LRU stack over a
+ * random stream of accesses long enough to compact the tree a few
+ * times.
+ */
+void
+testRandom(int num_blocks, int accesses)
+{
+    ReuseDistance rd(blockSize, 1.0);
+    list<Addr> stack;
+
+    for (int i = 0; i < accesses; i++) {
+        // a skewed choice so that there are short and long distances
+        Addr block = random() % (1 + random() % num_blocks);
+        Addr addr = block * blockSize + random() % blockSize;
+
+        double distance = -1;
+        ReuseDistance::Result result = rd.access(addr, distance);
+
+        int depth = 0;
+        list<Addr>::iterator j = stack.begin();
+        while (j != stack.end() && *j != block) {
+            ++j;
+            ++depth;
+        }
+
+        if (j == stack.end()) {
+            EXPECT_EQ(result, ReuseDistance::Cold);
+        } else {
+            EXPECT_EQ(result, ReuseDistance::Reuse);
+            EXPECT_EQ(distance, depth);
+            stack.erase(j);
+        }
+        stack.push_front(block);
+    }
+}
+
+/** Scans the blocks in a loop, so every reuse is at the same distance. */
+void
+testScan(int num_blocks, int passes)
+{
+    ReuseDistance rd(blockSize, 1.0);
+    for (int p = 0; p < passes; p++) {
+        for (int b = 0; b < num_blocks; b++) {
+            double distance = -1;
+            ReuseDistance::Result result =
+                rd.access(Addr(b) * blockSize, distance);
+            if (p == 0) {
+                EXPECT_EQ(result, ReuseDistance::Cold);
+            } else {
+                EXPECT_EQ(result, ReuseDistance::Reuse);
+                EXPECT_EQ(distance, num_blocks - 1);
+            }
+        }
+    }
+}
+
+} // anonymous namespace
+
+int
+main()
+{
+    double distance;
+
+    setCase("Addresses in a block are the same block.");
+    ReuseDistance rd(blockSize, 1.0);
+    EXPECT_EQ(rd.scale(), 1.0);
+    EXPECT_EQ(rd.access(0x1000, distance), ReuseDistance::Cold);
+    EXPECT_EQ(rd.access(0x103f, distance), ReuseDistance::Reuse);
+    EXPECT_EQ(distance, 0);
+    EXPECT_EQ(rd.access(0x1040, distance), ReuseDistance::Cold);
+    EXPECT_EQ(rd.access(0x1000, distance), ReuseDistance::Reuse);
+    EXPECT_EQ(distance, 1);
+
+    setCase("Working set of a period.");
+    EXPECT_EQ(rd.workingSet(), 2);
+    rd.newPeriod();
+    EXPECT_EQ(rd.workingSet(), 0);
+    rd.access(0x1040, distance);
+    rd.access(0x1040, distance);
+    EXPECT_EQ(rd.workingSet(), 1);
+    rd.access(0x2000, distance);
+    EXPECT_EQ(rd.workingSet(), 2);
+
+    setCase("Random accesses match an LRU stack across compactions.");
+    testRandom(3000, 300000);
+
+    setCase("Scans that grow the tree.");
+    testScan(10, 20000);
+    testScan(50000, 4);
+
+    setCase("Sampled blocks.");
+    const int num_blocks = 100000;
+    ReuseDistance sampled(blockSize, 0.25);
+    EXPECT_EQ(sampled.scale(), 4.0);
+    int tracked = 0;
+    double sum = 0;
+    for (int p = 0; p < 2; p++) {
+        for (int b = 0; b < num_blocks; b++) {
+            ReuseDistance::Result result =
+                sampled.access(Addr(b) * blockSize, distance);
+            if (result == ReuseDistance::NotSampled)
+                continue;
+
+            // a block is either always or never sampled
+            EXPECT_EQ(result,
+                      p ? ReuseDistance::Reuse : ReuseDistance::Cold);
+            if (p)
+                sum += distance;
+            else
+                tracked++;
+        }
+    }
+
+    // about a quarter of the blocks are tracked, and their distances
+    // and the working set are scaled up to those of all of them
+    EXPECT_TRUE(abs(tracked - num_blocks / 4) < num_blocks / 100);
+    EXPECT_EQ(sampled.workingSet(), 4.0 * tracked);
+    EXPECT_EQ(sum / tracked, 4.0 * (tracked - 1));
+
+    return UnitTest::printResults();
+}
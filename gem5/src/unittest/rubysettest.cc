@@ -0,0 +1,155 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cstdlib>
+#include <set>
+
+#include "mem/ruby/common/Set.hh"
+#include "unittest/unittest.hh"
+
+using namespace std;
+using UnitTest::setCase;
+
+namespace {
+
+/** Check a Set against a reference std::set with the same members. */
+void
+checkSet(const Set &s, const set<NodeID> &ref)
+{
+    EXPECT_EQ(s.count(), (int)ref.size());
+    EXPECT_EQ(s.isEmpty(), ref.empty());
+
+    for (NodeID i = 0; i < s.getSize(); i++)
+        EXPECT_EQ(s.isElement(i), ref.count(i) != 0);
+
+    if (!ref.empty())
+        EXPECT_EQ(s.smallestElement(), *ref.begin());
+
+    // walking the set with nextElement() visits exactly the members
+    set<NodeID>::const_iterator r = ref.begin();
+    for (NodeID i = s.nextElement(0); i < s.getSize();
+         i = s.nextElement(i + 1), ++r) {
+        EXPECT_TRUE(r != ref.end());
+        if (r == ref.end())
+            break;
+        EXPECT_EQ(i, *r);
+    }
+    EXPECT_TRUE(r == ref.end());
+}
+
+/** Fill a Set and its reference with random members. */
+void
+fill(Set &s, set<NodeID> &ref, int members)
+{
+    for (int i = 0; i < members; i++) {
+        NodeID n = random() % s.getSize();
+        s.add(n);
+        ref.insert(n);
+    }
+}
+
+} // anonymous namespace
+
+int
+main()
+{
+    // sizes below, at and across the 64-bit word boundaries
+    const int sizes[] = { 1, 5, 63, 64, 65, 130, 256 };
+
+    const int num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+
+    for (int k = 0; k < num_sizes; k++) {
+        int size = sizes[k];
+
+        setCase("Adding and removing members.");
+        Set a(size);
+        set<NodeID> ref_a;
+        checkSet(a, ref_a);
+        fill(a, ref_a, 40);
+        checkSet(a, ref_a);
+        a.remove(*ref_a.begin());
+        ref_a.erase(ref_a.begin());
+        checkSet(a, ref_a);
+
+        setCase("Combining sets.");
+        Set b(size);
+        set<NodeID> ref_b;
+        fill(b, ref_b, 40);
+
+        set<NodeID> ref_and, ref_or(ref_a), ref_diff(ref_a);
+        for (set<NodeID>::iterator i = ref_b.begin(); i != ref_b.end();
+             ++i) {
+            if (ref_a.count(*i))
+                ref_and.insert(*i);
+            ref_or.insert(*i);
+            ref_diff.erase(*i);
+        }
+
+        checkSet(a.AND(b), ref_and);
+        checkSet(a.OR(b), ref_or);
+        EXPECT_EQ(a.intersectionIsEmpty(b), ref_and.empty());
+        EXPECT_TRUE(a.OR(b).isSuperset(a));
+        EXPECT_TRUE(b.isSubset(a.OR(b)));
+        EXPECT_EQ(a.isSuperset(b), ref_and.size() == ref_b.size());
+
+        Set c(a);
+        c.addSet(b);
+        checkSet(c, ref_or);
+        EXPECT_TRUE(c.isEqual(a.OR(b)));
+        c = a;
+        c.removeSet(b);
+        checkSet(c, ref_diff);
+
+        setCase("Broadcast and clear.");
+        Set d(size);
+        d.broadcast();
+        EXPECT_TRUE(d.isBroadcast());
+        EXPECT_EQ(d.count(), size);
+        d.remove(size - 1);
+        EXPECT_FALSE(d.isBroadcast());
+        EXPECT_EQ(d.nextElement(size - 1), size);
+        d.clear();
+        checkSet(d, set<NodeID>());
+
+        setCase("Random members stay within the set.");
+        Set e(size);
+        e.addRandom();
+        EXPECT_TRUE(e.count() <= size);
+        for (NodeID i = e.nextElement(0); i < size; i = e.nextElement(i + 1))
+            EXPECT_TRUE(i < size);
+    }
+
+    setCase("Resizing empties the set and only broadcasts to the new size.");
+    Set f(130);
+    f.broadcast();
+    f.setSize(70);
+    EXPECT_TRUE(f.isEmpty());
+    f.broadcast();
+    EXPECT_EQ(f.count(), 70);
+    EXPECT_EQ(f.nextElement(69), 69);
+    EXPECT_EQ(f.nextElement(70), 70);
+
+    return UnitTest::printResults();
+}
@@ -0,0 +1,121 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cstdlib>
+#include <set>
+
+#include "cpu/o3/slot_bitmap.hh"
+#include "unittest/unittest.hh"
+
+using namespace std;
+using UnitTest::setCase;
+
+namespace {
+
+const int numRows = 3;
+
+/** Check every row of a bitmap against its reference sets. */
+void
+checkRows(const SlotBitmap &b, const set<int> *ref)
+{
+    for (int r = 0; r < numRows; r++) {
+        EXPECT_EQ(b.none(r), ref[r].empty());
+
+        // walking a row with findNext() visits exactly the members
+        set<int>::const_iterator i = ref[r].begin();
+        for (int s = b.findNext(r, 0); s != -1; s = b.findNext(r, s + 1)) {
+            EXPECT_TRUE(i != ref[r].end());
+            if (i == ref[r].end())
+                break;
+            EXPECT_EQ(s, *i);
+            ++i;
+        }
+        EXPECT_TRUE(i == ref[r].end());
+    }
+}
+
+} // anonymous namespace
+
+int
+main()
+{
+    SlotBitmap b;
+    set<int> ref[numRows];
+
+    setCase("Slots are rounded up to whole words.");
+    b.resize(numRows, 70);
+    EXPECT_EQ(b.slots(), 128);
+    checkRows(b, ref);
+
+    setCase("Setting and resetting slots.");
+    for (int i = 0; i < 20000; i++) {
+        int r = random() % numRows;
+        int s = random() % b.slots();
+        if (random() % 2) {
+            b.set(r, s);
+            ref[r].insert(s);
+        } else {
+            b.reset(r, s);
+            ref[r].erase(s);
+        }
+        EXPECT_EQ(b.test(r, s), ref[r].count(s) != 0);
+
+        // findNext() from any slot, including across words
+        int q = random() % b.slots();
+        set<int>::iterator n = ref[r].lower_bound(q);
+        EXPECT_EQ(b.findNext(r, q), n == ref[r].end() ? -1 : *n);
+    }
+    checkRows(b, ref);
+    EXPECT_EQ(b.findNext(0, b.slots()), -1);
+
+    setCase("Growing keeps the bits.");
+    b.resize(numRows, 200);
+    EXPECT_EQ(b.slots(), 256);
+    checkRows(b, ref);
+    b.set(1, 255);
+    ref[1].insert(255);
+    checkRows(b, ref);
+
+    setCase("Row operations.");
+    b.copyRow(0, 1);
+    ref[0] = ref[1];
+    checkRows(b, ref);
+
+    b.maskRow(0, 2);
+    for (set<int>::iterator i = ref[2].begin(); i != ref[2].end(); ++i)
+        ref[0].erase(*i);
+    checkRows(b, ref);
+
+    b.clearRow(1);
+    ref[1].clear();
+    checkRows(b, ref);
+
+    b.clear();
+    for (int r = 0; r < numRows; r++)
+        ref[r].clear();
+    checkRows(b, ref);
+
+    return UnitTest::printResults();
+}
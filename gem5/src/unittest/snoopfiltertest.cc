@@ -0,0 +1,113 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/request.hh"
+#include "mem/snoop_filter.hh"
+#include "unittest/unittest.hh"
+
+using UnitTest::setCase;
+
+namespace {
+
+const unsigned blockSize = 64;
+const Addr blockA = 0x1000;
+const Addr blockB = 0x2000;
+
+uint64_t
+ports(PortID a, PortID b = InvalidPortID)
+{
+    return SnoopFilter::portBit(a) |
+        (b == InvalidPortID ? 0 : SnoopFilter::portBit(b));
+}
+
+} // anonymous namespace
+
+int
+main()
+{
+    SnoopFilter filter;
+    filter.setBlockSize(blockSize);
+
+    setCase("Addresses are aligned to blocks.");
+    EXPECT_EQ(filter.blockAlign(blockA + blockSize - 1), blockA);
+    EXPECT_EQ(filter.blockAlign(blockA + blockSize), blockA + blockSize);
+
+    setCase("Holders are added per block.");
+    EXPECT_EQ(filter.lookup(blockA), 0);
+    filter.addHolder(blockA, 0);
+    filter.addHolder(blockA, 3);
+    filter.addHolder(blockB, 63);
+    EXPECT_EQ(filter.lookup(blockA), ports(0, 3));
+    EXPECT_EQ(filter.lookup(blockB), ports(63));
+
+    setCase("An invalidation leaves only the kept ports.");
+    filter.invalidate(blockA, ports(3));
+    EXPECT_EQ(filter.lookup(blockA), ports(3));
+    filter.invalidate(blockA, 0);
+    EXPECT_EQ(filter.lookup(blockA), 0);
+    EXPECT_EQ(filter.lookup(blockB), ports(63));
+
+    setCase("Ports with a request in flight are holders.");
+    Request req1, req2;
+    filter.addPending(&req1, blockA, 1);
+    filter.addPending(&req2, blockA, 2);
+    EXPECT_EQ(filter.lookup(blockA), ports(1, 2));
+
+    // the requesters may still get the block after an invalidation
+    filter.invalidate(blockA, 0);
+    EXPECT_EQ(filter.lookup(blockA), ports(1, 2));
+
+    // and keep it once the response has gone back
+    filter.removePending(&req1);
+    EXPECT_EQ(filter.lookup(blockA), ports(1, 2));
+    filter.removePending(&req2);
+    filter.removePending(&req2);
+    EXPECT_EQ(filter.lookup(blockA), ports(1, 2));
+    filter.invalidate(blockA, ports(2));
+    EXPECT_EQ(filter.lookup(blockA), ports(2));
+
+    setCase("Unseen blocks have all the holders after a restore.");
+    const uint64_t all = ports(0, 1) | ports(2, 3);
+    filter.assumeHolders(all);
+    EXPECT_EQ(filter.lookup(0x3000), all);
+    EXPECT_EQ(filter.lookup(blockA), ports(2));
+
+    // adding a holder must not forget the others
+    filter.addHolder(0x3000, 5);
+    EXPECT_EQ(filter.lookup(0x3000), all | ports(5));
+
+    // a response to a request for an unseen block doesn't either
+    filter.addPending(&req1, 0x4000, 5);
+    filter.removePending(&req1);
+    EXPECT_EQ(filter.lookup(0x4000), all | ports(5));
+
+    // an invalidation tells the filter who is left
+    filter.invalidate(0x3000, 0);
+    EXPECT_EQ(filter.lookup(0x3000), 0);
+    filter.invalidate(0x5000, ports(1));
+    EXPECT_EQ(filter.lookup(0x5000), ports(1));
+
+    return UnitTest::printResults();
+}
@@ -0,0 +1,70 @@
+#!/usr/bin/env python
+
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Convert a text trace for the traffic generator, with one
+# "r|w,addr,size,tick" transaction per line, into the binary trace
+# format that TraceGen maps directly into memory. The binary file is
+# written in the byte order of the host running this script, which must
+# match the host running the simulation.
+
+import struct
+import sys
+
+magic = 'gem5tgen'
+version = 1
+header = struct.Struct('=8sII')
+record = struct.Struct('=QQIB3x')
+
+def main():
+    if len(sys.argv) != 3:
+        print "Usage: %s <text trace> <binary trace>" % sys.argv[0]
+        sys.exit(1)
+
+    text = open(sys.argv[1], 'r')
+    binary = open(sys.argv[2], 'wb')
+
+    binary.write(header.pack(magic, version, record.size))
+
+    count = 0
+    for (num, line) in enumerate(text):
+        line = line.strip()
+        if not line:
+            continue
+
+        (cmd, addr, size, tick) = line.split(',')
+        if cmd not in ('r', 'w'):
+            print "Unknown command '%s' on line %d" % (cmd, num + 1)
+            sys.exit(1)
+
+        binary.write(record.pack(int(tick), int(addr), int(size), ord(cmd)))
+        count += 1
+
+    binary.close()
+    text.close()
+
+    print "Converted %d transactions" % count
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,110 @@
+#!/usr/bin/env python
+
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Run a workload twice to get OPT replacement numbers for the L2 cache.
+# The first pass records the line addresses referenced in the L2, the
+# second one runs the given CPU on Ruby with OPT replacement in the L2,
+# driven by the recorded references.
+#
+# By default the recording pass is a fast one: the atomic CPU with
+# classic caches of the same sizes, recording the requests that leave
+# the L1 caches. It can't use --fastmem, which bypasses the caches.
+# With --record-ruby it runs the same CPU on Ruby as the second pass,
+# and the L2 records its own references, which is slower but closer
+# to what the second pass sees.
+#
+# Both passes get the same script arguments, so restoring a checkpoint
+# with -r starts them from the same point, as long as both memory
+# systems can restore it.
+#
+# The result is an approximation of OPT. The recorded references are
+# not exactly those of the second pass: the classic and Ruby caches
+# differ, the L2 replacements change what the L1 caches miss on, and
+# timing changes the interleaving of the requests. The OPT policy
+# matches the references line by line and only looks a cache's worth
+# of references around where it thinks the run is, so its choices are
+# only as good as the recording predicts the second pass.
+
+import optparse
+import os
+import subprocess
+import sys
+
+def run(cmd):
+    print "Running: %s" % ' '.join(cmd)
+    status = subprocess.call(cmd)
+    if status != 0:
+        print "Command failed with status %d" % status
+        sys.exit(status)
+
+def main():
+    parser = optparse.OptionParser(
+        usage="%prog [options] <gem5 binary> <config script> [script args]")
+    parser.disable_interspersed_args()
+    parser.add_option("--outdir", default="m5out-opt",
+                      help="directory for the output of both passes")
+    parser.add_option("--trace", default="opt.trace",
+                      help="name of the recorded block address trace")
+    parser.add_option("--record-args", default="",
+                      help="extra script arguments for the recording pass")
+    parser.add_option("--replay-args", default="",
+                      help="extra script arguments for the OPT pass")
+    parser.add_option("--cpu", default="detailed",
+                      help="CPU type of the OPT pass")
+    parser.add_option("--record-ruby", action="store_true",
+                      help="record on Ruby with the CPU of the OPT pass "
+                      "instead of the atomic CPU with classic caches")
+    (options, args) = parser.parse_args()
+
+    if len(args) < 2:
+        parser.print_usage()
+        sys.exit(1)
+
+    (gem5, script, script_args) = (args[0], args[1], args[2:])
+
+    record_dir = os.path.join(options.outdir, "record")
+    replay_dir = os.path.join(options.outdir, "replay")
+
+    if options.record_ruby:
+        record_system = ["--ruby", "--cpu-type=%s" % options.cpu]
+    else:
+        record_system = ["--cpu-type=atomic", "--caches", "--l2cache"]
+
+    run([gem5, "-d", record_dir, script] + script_args + record_system +
+        ["--opt-record=%s" % options.trace] +
+        options.record_args.split())
+
+    trace = os.path.join(record_dir, options.trace)
+    if not os.path.exists(trace):
+        print "The recording pass did not produce %s" % trace
+        sys.exit(1)
+
+    run([gem5, "-d", replay_dir, script] + script_args +
+        ["--ruby", "--cpu-type=%s" % options.cpu,
+         "--opt-oracle=%s" % os.path.abspath(trace)] +
+        options.replay_args.split())
+
+if __name__ == '__main__':
+    main()